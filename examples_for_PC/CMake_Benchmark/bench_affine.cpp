@@ -0,0 +1,45 @@
+// pushRotateZoom / pushRotateZoomWithAA の処理時間を角度ごとに計測する
+// 1024x1024 の16bitスプライトを、同じ大きさの16bitスプライトへ回転して描画する
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+
+#include "bench_common.hpp"
+
+int main(void)
+{
+  static constexpr int size = 1024;
+
+  LGFX_Sprite src;
+  src.setColorDepth(16);
+  src.createSprite(size, size);
+  for (int y = 0; y < size; ++y)
+  {
+    for (int x = 0; x < size; ++x)
+    {
+      src.writePixel(x, y, lgfx::color565(x, y, x ^ y));
+    }
+  }
+
+  LGFX_Sprite dst;
+  dst.setColorDepth(16);
+  dst.createSprite(size, size);
+
+  printf("angle    plain (ms)      AA (ms)\n");
+  for (float angle : { 0.0f, 30.0f, 45.0f, 60.0f, 80.0f, 89.0f, 90.0f, 180.0f, 270.0f })
+  {
+    double plain = bench_usec([&]{ src.pushRotateZoom(&dst, size / 2, size / 2, angle, 1.0f, 1.0f); });
+    double aa = bench_usec([&]{ src.pushRotateZoomWithAA(&dst, size / 2, size / 2, angle, 1.0f, 1.0f); });
+
+    // AAは描画先と合成するため、ハッシュは消去した描画先に1回描画して求める
+    dst.clear();
+    src.pushRotateZoom(&dst, size / 2, size / 2, angle, 1.0f, 1.0f);
+    uint64_t plain_hash = bench_hash(dst.getBuffer(), dst.bufferLength());
+    dst.clear();
+    src.pushRotateZoomWithAA(&dst, size / 2, size / 2, angle, 1.0f, 1.0f);
+    uint64_t aa_hash = bench_hash(dst.getBuffer(), dst.bufferLength());
+    printf("%5.0f  %8.2f %016llx  %8.2f %016llx\n", angle
+          , plain / 1000.0, (unsigned long long)plain_hash
+          , aa / 1000.0, (unsigned long long)aa_hash);
+  }
+  return 0;
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+// Bus_Recorder に Panel_ILI9341 をつないで、実機のパネルと同じ経路で送信されるバイト数を数える
+// 記録したバイト列を CASET / RASET / RAMWR / COLMOD に従って画面の内容に戻し、描画結果を比べられるようにする
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+#include <lgfx/v1/panel/Panel_ILI9341.hpp>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "bench_common.hpp"
+
+template <typename TPanel = lgfx::Panel_ILI9341>
+class LGFX_Recorded : public lgfx::LGFX_Device
+{
+public:
+  TPanel panel;
+  lgfx::Bus_Recorder bus;
+
+  LGFX_Recorded(void)
+  {
+    _stream = open_memstream(&_stream_buf, &_stream_len);
+    auto cfg = bus.config();
+    cfg.output = _stream;
+    bus.config(cfg);
+    panel.setBus(&bus);
+    setPanel(&panel);
+  }
+
+  ~LGFX_Recorded(void)
+  {
+    fclose(_stream);
+    free(_stream_buf);
+  }
+
+  // ここまでに記録したバイト列を取り出し、記録を空にする
+  std::vector<uint8_t> takeRecord(void)
+  {
+    fflush(_stream);
+    std::vector<uint8_t> result(_stream_buf, _stream_buf + _stream_len);
+    rewind(_stream);
+    fflush(_stream);
+    return result;
+  }
+
+private:
+  FILE* _stream = nullptr;
+  char* _stream_buf = nullptr;
+  size_t _stream_len = 0;
+};
+
+// 記録されたバイト列から画面の内容を組み立てる (1ピクセルは送信されたバイトを下位から詰めた値)
+class FrameDecoder
+{
+public:
+  FrameDecoder(uint32_t width = 240, uint32_t height = 320) : _width(width), _height(height), _frame(width * height) {}
+
+  const std::vector<uint32_t>& frame(void) const { return _frame; }
+  uint64_t hash(void) const { return bench_hash(_frame.data(), _frame.size() * sizeof(uint32_t)); }
+
+  void feed(const std::vector<uint8_t>& record)
+  {
+    size_t pos = 0;
+    while (pos + 6 <= record.size())
+    {
+      char kind = record[pos];
+      uint32_t length = record[pos + 2] | record[pos + 3] << 8 | record[pos + 4] << 16 | (uint32_t)record[pos + 5] << 24;
+      const uint8_t* payload = &record[pos + 6];
+      pos += 6;
+      if (kind == 'C')
+      {
+        for (uint32_t i = 0; i < length; ++i) { command(payload[i]); }
+        pos += length;
+      }
+      else if (kind == 'D')
+      {
+        for (uint32_t i = 0; i < length; ++i) { data(payload[i]); }
+        pos += length;
+      }
+      else if (kind == 'R')
+      {
+        uint32_t bytes = record[pos - 5] >> 3;
+        for (uint32_t n = 0; n < length; ++n)
+        {
+          for (uint32_t i = 0; i < bytes; ++i) { data(payload[i]); }
+        }
+        pos += bytes;
+      }
+      else { break; }
+    }
+  }
+
+private:
+  uint32_t _width;
+  uint32_t _height;
+  std::vector<uint32_t> _frame;
+
+  uint8_t _cmd = 0;
+  uint32_t _argc = 0;
+  uint8_t _args[4] = {};
+  uint16_t _xs = 0, _xe = 0, _ys = 0, _ye = 0;
+  uint16_t _x = 0, _y = 0;
+  uint32_t _pixel_bytes = 2;
+  uint32_t _pixel = 0;
+  uint32_t _pixel_pos = 0;
+
+  void command(uint8_t cmd)
+  {
+    _cmd = cmd;
+    _argc = 0;
+    if (cmd == 0x2C)
+    {
+      _x = _xs;
+      _y = _ys;
+      _pixel = 0;
+      _pixel_pos = 0;
+    }
+  }
+
+  void data(uint8_t value)
+  {
+    if (_cmd == 0x2C)
+    {
+      _pixel |= value << (_pixel_pos * 8);
+      if (++_pixel_pos < _pixel_bytes) { return; }
+      if (_x < _width && _y < _height) { _frame[_y * _width + _x] = _pixel; }
+      _pixel = 0;
+      _pixel_pos = 0;
+      if (++_x > _xe)
+      {
+        _x = _xs;
+        if (++_y > _ye) { _y = _ys; }
+      }
+      return;
+    }
+    if (_argc < 4) { _args[_argc] = value; }
+    if (++_argc == 4)
+    {
+      if (_cmd == 0x2A) { _xs = _args[0] << 8 | _args[1]; _xe = _args[2] << 8 | _args[3]; }
+      if (_cmd == 0x2B) { _ys = _args[0] << 8 | _args[1]; _ye = _args[2] << 8 | _args[3]; }
+    }
+    if (_cmd == 0x3A && _argc == 1) { _pixel_bytes = ((value & 0x0F) <= 5) ? 2 : 3; }
+  }
+};
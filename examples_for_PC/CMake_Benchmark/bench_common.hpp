@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <chrono>
+
+// 指定時間以上くり返し実行し、1回あたりの時間(us)を返す
+template <typename TFunc>
+double bench_usec(TFunc func, double seconds = 1.0)
+{
+  auto start = std::chrono::steady_clock::now();
+  uint32_t count = 0;
+  double elapsed;
+  do
+  {
+    func();
+    ++count;
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  } while (elapsed < seconds);
+  return elapsed * 1000000.0 / count;
+}
+
+// 描画結果が変わっていないことを確認するためのハッシュ (FNV-1a)
+inline uint64_t bench_hash(const void* data, size_t len)
+{
+  auto p = (const uint8_t*)data;
+  uint64_t h = 1469598103934665603ull;
+  for (size_t i = 0; i < len; ++i) { h = (h ^ p[i]) * 1099511628211ull; }
+  return h;
+}
@@ -0,0 +1,122 @@
+// Panel_FlexibleFrameBuffer の1行単位の関数 (_fill_span_inner / _copy_span_inner / _read_span_inner) の効果を測る
+// メモリ上の RGB565 バッファに描くパネルを2つ用意し、1ピクセル単位の関数だけを持つものと
+// 1行単位の関数も持つものとで、処理速度 (Mpx/s) を比較する
+// 描画結果のハッシュは両者で同じになる
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+#include <lgfx/v1/panel/Panel_FlexibleFrameBuffer.hpp>
+
+#include <string.h>
+#include <vector>
+
+#include "bench_common.hpp"
+
+static constexpr int panel_w = 320;
+static constexpr int panel_h = 240;
+
+// 1ピクセル単位の関数だけを持つパネル (行単位の関数は既定の実装を使う)
+class Panel_Memory : public lgfx::Panel_FlexibleFrameBuffer
+{
+public:
+  Panel_Memory(void)
+  {
+    auto cfg = config();
+    cfg.memory_width  = cfg.panel_width  = panel_w;
+    cfg.memory_height = cfg.panel_height = panel_h;
+    config(cfg);
+    _buf.resize(panel_w * panel_h);
+  }
+  const uint16_t* data(void) const { return _buf.data(); }
+
+protected:
+  std::vector<uint16_t> _buf;
+
+  void _draw_pixel_inner(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor) override
+  {
+    _buf[y * panel_w + x] = rawcolor;
+  }
+  uint32_t _read_pixel_inner(uint_fast16_t x, uint_fast16_t y) override
+  {
+    return _buf[y * panel_w + x];
+  }
+};
+
+// 1行単位の関数を memcpy で実装したパネル
+class Panel_MemorySpan : public Panel_Memory
+{
+protected:
+  void _fill_span_inner(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint32_t rawcolor) override
+  {
+    auto dst = &_buf[y * panel_w + x];
+    do { *dst++ = rawcolor; } while (--w);
+  }
+  void _copy_span_inner(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, const uint8_t* pixels) override
+  {
+    memcpy(&_buf[y * panel_w + x], pixels, w * 2);
+  }
+  void _read_span_inner(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint8_t* pixels) override
+  {
+    memcpy(pixels, &_buf[y * panel_w + x], w * 2);
+  }
+};
+
+class LGFX : public lgfx::LGFX_Device
+{
+public:
+  LGFX(lgfx::Panel_Device* panel) { setPanel(panel); }
+};
+
+static std::vector<uint16_t> image;
+static std::vector<uint16_t> readbuf;
+
+static void run(const char* name, Panel_Memory* panel, uint_fast8_t rotation)
+{
+  LGFX gfx(panel);
+  gfx.init();
+  gfx.setColorDepth(16);
+  gfx.setRotation(rotation);
+  int w = gfx.width();
+  int h = gfx.height();
+  double px = w * h;
+
+  uint32_t c = 0;
+  double fill = bench_usec([&]() { gfx.fillRect(0, 0, w, h, ++c); }, 0.5);
+
+  double push = bench_usec([&]() { gfx.pushImage(0, 0, w, h, image.data()); }, 0.5);
+
+  double pixels = bench_usec([&]()
+  {
+    gfx.startWrite();
+    gfx.setAddrWindow(0, 0, w, h);
+    gfx.writePixels(image.data(), w * h);
+    gfx.endWrite();
+  }, 0.5);
+
+  double read = bench_usec([&]() { gfx.readRect(0, 0, w, h, readbuf.data()); }, 0.5);
+
+  gfx.fillScreen(0x1234u);
+  gfx.pushImage(10, 10, w / 2, h / 2, image.data(), (uint16_t)0);
+  gfx.fillRectAlpha(30, 20, 100, 80, 128, 0xFF8000u);
+  gfx.readRect(0, 0, w, h, readbuf.data());
+  uint64_t hash = bench_hash(panel->data(), panel_w * panel_h * 2) * 31 + bench_hash(readbuf.data(), w * h * 2);
+
+  printf("%-10s rot%u %10.0f %10.0f %10.0f %10.0f   %016llx\n", name, rotation
+        , px / fill, px / push, px / pixels, px / read, (unsigned long long)hash);
+}
+
+int main(void)
+{
+  image.resize(panel_w * panel_h);
+  readbuf.resize(panel_w * panel_h);
+  for (size_t i = 0; i < image.size(); ++i) { image[i] = i * 2654435761u >> 16; }
+
+  printf("(Mpx/s)         %10s %10s %10s %10s   %16s\n", "fillRect", "pushImage", "writePixel", "readRect", "hash");
+  for (uint_fast8_t rotation : { 0, 1 })
+  {
+    Panel_Memory pixel_panel;
+    Panel_MemorySpan span_panel;
+    run("per pixel", &pixel_panel, rotation);
+    run("span"     , &span_panel , rotation);
+  }
+  return 0;
+}
@@ -0,0 +1,115 @@
+// floodFill / boundaryFill の処理時間を測る
+// 細い通路の迷路と渦巻きを描いたスプライトを、毎回描画前の内容に戻してから塗り潰す (戻す時間は差し引く)
+// 作業領域をヒープから確保する場合と setFillWorkBuffer で渡す場合を比べる
+// 描画結果のハッシュはどちらの場合も同じになる
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+
+#include <string.h>
+#include <vector>
+
+#include "bench_common.hpp"
+
+static constexpr int width = 480;
+static constexpr int height = 320;
+
+static uint32_t rand_state = 1;
+static uint32_t next_rand(void) { rand_state = rand_state * 1103515245u + 12345u; return rand_state >> 8; }
+
+// 通路の幅1ピクセルの迷路 (穴掘り法)
+static void draw_maze(LGFX_Sprite& sprite)
+{
+  static std::vector<uint8_t> maze;
+  constexpr int cw = (width - 1) / 2;
+  constexpr int ch = (height - 1) / 2;
+  if (maze.empty())
+  {
+    maze.assign(width * height, 1);
+    rand_state = 1;
+    std::vector<int> stack = { 0 };
+    std::vector<uint8_t> visited(cw * ch, 0);
+    visited[0] = 1;
+    maze[1 * width + 1] = 0;
+    while (!stack.empty())
+    {
+      int c = stack.back();
+      int cx = c % cw, cy = c / cw;
+      int next[4], n = 0;
+      if (cx > 0      && !visited[c - 1 ]) { next[n++] = c - 1;  }
+      if (cx < cw - 1 && !visited[c + 1 ]) { next[n++] = c + 1;  }
+      if (cy > 0      && !visited[c - cw]) { next[n++] = c - cw; }
+      if (cy < ch - 1 && !visited[c + cw]) { next[n++] = c + cw; }
+      if (n == 0) { stack.pop_back(); continue; }
+      int d = next[next_rand() % n];
+      visited[d] = 1;
+      int dx = d % cw, dy = d / cw;
+      maze[(cy + dy + 1) * width + (cx + dx + 1)] = 0;
+      maze[(dy * 2 + 1) * width + (dx * 2 + 1)] = 0;
+      stack.push_back(d);
+    }
+  }
+  sprite.fillScreen(TFT_BLACK);
+  for (int y = 0; y < height; ++y)
+  {
+    for (int x = 0; x < width; ++x)
+    {
+      if (maze[y * width + x]) { sprite.drawPixel(x, y, TFT_WHITE); }
+    }
+  }
+}
+
+// 通路の幅2ピクセルの四角い渦巻き
+static void draw_spiral(LGFX_Sprite& sprite)
+{
+  sprite.fillScreen(TFT_BLACK);
+  for (int k = 0; 3 * k + 3 < height - 1 - 3 * k; ++k)
+  {
+    int l = 3 * k, t = 3 * k, r = width - 1 - 3 * k, b = height - 1 - 3 * k;
+    sprite.drawLine(l, t, r, t, TFT_WHITE);
+    sprite.drawLine(r, t, r, b, TFT_WHITE);
+    sprite.drawLine(r, b, l, b, TFT_WHITE);
+    sprite.drawLine(l, b, l, t + 3, TFT_WHITE);
+  }
+}
+
+static void run(LGFX_Sprite& sprite, const char* name, void (*draw)(LGFX_Sprite&), int seed_x, int seed_y)
+{
+  static std::vector<uint8_t> work(64 * 1024);
+  draw(sprite);
+  std::vector<uint8_t> scene((uint8_t*)sprite.getBuffer(), (uint8_t*)sprite.getBuffer() + sprite.bufferLength());
+  auto restore = [&]() { memcpy(sprite.getBuffer(), scene.data(), scene.size()); };
+  double base = bench_usec(restore, 0.3);
+  for (int border = 0; border < 2; ++border)
+  {
+    auto fill = [&]()
+    {
+      restore();
+      if (border) { sprite.boundaryFill(seed_x, seed_y, TFT_WHITE, TFT_RED); }
+      else        { sprite.floodFill(seed_x, seed_y, TFT_RED); }
+    };
+    sprite.setFillWorkBuffer(nullptr, 0);
+    double heap = bench_usec(fill, 0.5) - base;
+    uint64_t hash_heap = bench_hash(sprite.getBuffer(), sprite.bufferLength());
+    sprite.setFillWorkBuffer(work.data(), work.size());
+    double supplied = bench_usec(fill, 0.5) - base;
+    uint64_t hash_supplied = bench_hash(sprite.getBuffer(), sprite.bufferLength());
+    sprite.setFillWorkBuffer(nullptr, 0);
+    printf("%-8s %-6s %-12s %10.1f %10.1f   %016llx %s\n", name, sprite.getColorDepth() == 16 ? "rgb565" : "rgb332"
+          , border ? "boundaryFill" : "floodFill", heap, supplied
+          , (unsigned long long)hash_heap, hash_heap == hash_supplied ? "same" : "DIFFERENT");
+  }
+}
+
+int main(void)
+{
+  printf("%-8s %-6s %-12s %10s %10s   %16s\n", "(us)", "depth", "", "heap", "work buf", "hash");
+  for (int depth : { 16, 8 })
+  {
+    LGFX_Sprite sprite;
+    sprite.setColorDepth(depth);
+    sprite.createSprite(width, height);
+    run(sprite, "maze", draw_maze, 1, 1);
+    run(sprite, "spiral", draw_spiral, 1, 1);
+  }
+  return 0;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+// VLW フォントをその場で生成し、読出しと seek の回数を数える DataWrapper から読み込むための部品
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+
+#include <vector>
+
+// 読出しと seek の回数を数える
+struct CountingWrapper : public lgfx::PointerWrapper
+{
+  CountingWrapper(const uint8_t* src, uint32_t length) : PointerWrapper(src, length) {}
+  int read(uint8_t *buf, uint32_t len) override { ++reads; return PointerWrapper::read(buf, len); }
+  bool seek(uint32_t offset) override { ++seeks; return PointerWrapper::seek(offset); }
+  uint32_t reads = 0;
+  uint32_t seeks = 0;
+};
+
+inline void put32(std::vector<uint8_t>& v, uint32_t value)
+{
+  for (int i = 24; i >= 0; i -= 8) { v.push_back(value >> i); }
+}
+
+// 高さ20ピクセルの VLW フォント。半数のグリフは x のずれが 0 で、メトリクスの取得にファイルの読出しが要る
+inline std::vector<uint8_t> make_vlw(void)
+{
+  std::vector<uint8_t> font;
+  std::vector<uint8_t> bitmaps;
+  uint32_t rand_state = 1;
+  uint32_t count = 0x7F - 0x21;
+  put32(font, count);
+  put32(font, 11);
+  put32(font, 20);
+  put32(font, 0);
+  put32(font, 16);
+  put32(font, 4);
+  for (uint32_t code = 0x21; code < 0x7F; ++code)
+  {
+    uint32_t w = 6 + (code % 7);
+    uint32_t h = 10 + (code % 6);
+    put32(font, code);
+    put32(font, h);
+    put32(font, w);
+    put32(font, w + 2);
+    put32(font, 16 - (code % 3));
+    put32(font, (code & 1) ? 1 : 0);
+    put32(font, 0);
+    for (uint32_t i = 0; i < w * h; ++i)
+    {
+      rand_state = rand_state * 1103515245u + 12345u;
+      bitmaps.push_back(rand_state >> 8);
+    }
+  }
+  font.insert(font.end(), bitmaps.begin(), bitmaps.end());
+  return font;
+}
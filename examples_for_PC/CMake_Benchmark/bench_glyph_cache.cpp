@@ -0,0 +1,89 @@
+// CachedLVGLfont のグリフキャッシュの効果を測る
+// キャッシュの容量を変えて同じ文字列を描き、1回あたりの時間とヒット/ミスの回数を表示する
+// 最初の1回と、その後の1回あたりのヒープ確保の回数 (グリフ展開用の作業領域とキャッシュの合計) も表示する
+// 描画結果のハッシュは容量によらず同じになる
+// ファイルから読むフォントの例として、読出し回数を数える DataWrapper から VLW フォントを読み込み、
+// setFontCacheSize の容量を変えて1回あたりの時間と読出し・seek の回数も表示する
+// フォントのデータはメモリ上にあり読出しは速いため、時間はほとんど変わらない。SD カードなどでは読出し・seek の回数が時間を左右する
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+
+#include "bench_common.hpp"
+#include "bench_font.hpp"
+
+static const char text[] =
+  "The quick brown fox jumps over the lazy dog. 0123456789\n"
+  "ABCDEFGHIJKLMNOPQRSTUVWXYZ abcdefghijklmnopqrstuvwxyz !?#$%&()[]{}<>";
+
+int main(void)
+{
+  LGFX_Sprite sprite;
+  sprite.setColorDepth(16);
+  sprite.createSprite(1024, 128);
+  sprite.setTextColor(0xFFFFFFu, 0x000040u);
+
+  printf("%-10s %10s %10s %10s %9s %9s %16s\n", "cache", "us/draw", "hit", "miss", "alloc:1st", "alloc", "hash");
+
+  sprite.releaseFontScratch();
+  sprite.resetFontScratchAllocCount();
+  sprite.setFont(&lgfx::fonts::lv_font_montserrat_28_compressed);
+  sprite.drawString(text, 0, 0);
+  uint32_t first = sprite.getFontScratchAllocCount();
+  sprite.resetFontScratchAllocCount();
+  uint32_t draws = 0;
+  double us = bench_usec([&]() { sprite.drawString(text, 0, 0); ++draws; });
+  uint32_t allocs = sprite.getFontScratchAllocCount() / draws;
+  sprite.clear();
+  sprite.drawString(text, 0, 0);
+  printf("%-10s %10.1f %10s %10s %9u %9u %016llx\n", "none", us, "-", "-", first, allocs
+        , (unsigned long long)bench_hash(sprite.getBuffer(), sprite.bufferLength()));
+
+  for (size_t bytes : { 2048u, 8192u, 32768u, 262144u })
+  {
+    lgfx::CachedLVGLfont font(lgfx::fonts::lv_font_montserrat_28_compressed, bytes);
+    sprite.releaseFontScratch();
+    sprite.resetFontScratchAllocCount();
+    sprite.setFont(&font);
+    sprite.drawString(text, 0, 0);
+    first = sprite.getFontScratchAllocCount() + font.getGlyphCacheAllocCount();
+    sprite.resetFontScratchAllocCount();
+    font.resetGlyphCacheCount();
+    draws = 0;
+    us = bench_usec([&]() { sprite.drawString(text, 0, 0); ++draws; });
+    uint32_t hit = font.getGlyphCacheHitCount() / draws;
+    uint32_t miss = font.getGlyphCacheMissCount() / draws;
+    allocs = (sprite.getFontScratchAllocCount() + font.getGlyphCacheAllocCount()) / draws;
+    sprite.clear();
+    sprite.drawString(text, 0, 0);
+    printf("%-10zu %10.1f %10u %10u %9u %9u %016llx\n", bytes, us, hit, miss, first, allocs
+          , (unsigned long long)bench_hash(sprite.getBuffer(), sprite.bufferLength()));
+    sprite.setFont(&lgfx::fonts::Font0);
+  }
+
+  // make_vlw のフォントは ASCII の 0x21 ~ 0x7E のみを持つ
+  printf("\n%-10s %10s %10s %10s %9s %9s %16s\n", "VLW cache", "us/draw", "hit", "miss", "reads", "seeks", "hash");
+  auto vlw = make_vlw();
+  for (size_t bytes : { 0u, 2048u, 8192u, 32768u })
+  {
+    CountingWrapper data(vlw.data(), vlw.size());
+    sprite.setFontCacheSize(bytes);
+    sprite.loadFont(&data);
+    sprite.drawString(text, 0, 0);
+    uint32_t hit = sprite.getFontCacheHitCount();
+    uint32_t miss = sprite.getFontCacheMissCount();
+    data.reads = data.seeks = 0;
+    draws = 0;
+    us = bench_usec([&]() { sprite.drawString(text, 0, 0); ++draws; });
+    hit = (sprite.getFontCacheHitCount() - hit) / draws;
+    miss = (sprite.getFontCacheMissCount() - miss) / draws;
+    uint32_t reads = data.reads / draws;
+    uint32_t seeks = data.seeks / draws;
+    sprite.clear();
+    sprite.drawString(text, 0, 0);
+    printf("%-10zu %10.1f %10u %10u %9u %9u %016llx\n", bytes, us, hit, miss, reads, seeks
+          , (unsigned long long)bench_hash(sprite.getBuffer(), sprite.bufferLength()));
+    sprite.unloadFont();
+  }
+  sprite.setFontCacheSize(0);
+  return 0;
+}
@@ -0,0 +1,308 @@
+// drawJpg と LGFX_MJpegPlayer のフレームレートを測る
+// 320x240 のフレームを 30 枚、簡易なベースライン JPEG エンコーダでその場で生成して使う
+// MJPEG は、全フレームにテーブルを持つストリームと、2枚目以降の DHT/DQT を省いたストリームの2種類
+// 同じフレームの描画結果のハッシュは、どの方法でも同じになる
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+#include <lgfx/v1/LGFX_MJpegPlayer.hpp>
+
+#include <math.h>
+#include <vector>
+
+#include "bench_common.hpp"
+
+static constexpr int img_w = 320;
+static constexpr int img_h = 240;
+static constexpr int frames = 30;
+
+static const uint8_t zigzag[64] =
+{  0,  1,  8, 16,  9,  2,  3, 10, 17, 24, 32, 25, 18, 11,  4,  5
+, 12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13,  6,  7, 14, 21, 28
+, 35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51
+, 58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63
+};
+
+static const uint8_t qt_lum[64] =
+{ 16, 11, 10, 16, 24, 40, 51, 61,  12, 12, 14, 19, 26, 58, 60, 55
+, 14, 13, 16, 24, 40, 57, 69, 56,  14, 17, 22, 29, 51, 87, 80, 62
+, 18, 22, 37, 56, 68,109,103, 77,  24, 35, 55, 64, 81,104,113, 92
+, 49, 64, 78, 87,103,121,120,101,  72, 92, 95, 98,112,100,103, 99
+};
+
+static const uint8_t qt_chr[64] =
+{ 17, 18, 24, 47, 99, 99, 99, 99,  18, 21, 26, 66, 99, 99, 99, 99
+, 24, 26, 56, 99, 99, 99, 99, 99,  47, 66, 99, 99, 99, 99, 99, 99
+, 99, 99, 99, 99, 99, 99, 99, 99,  99, 99, 99, 99, 99, 99, 99, 99
+, 99, 99, 99, 99, 99, 99, 99, 99,  99, 99, 99, 99, 99, 99, 99, 99
+};
+
+static const uint8_t dc_lum_bits[16] = { 0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0 };
+static const uint8_t dc_chr_bits[16] = { 0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 };
+static const uint8_t dc_vals[12] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+
+static const uint8_t ac_lum_bits[16] = { 0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d };
+static const uint8_t ac_lum_vals[162] =
+{ 0x01,0x02,0x03,0x00,0x04,0x11,0x05,0x12,0x21,0x31,0x41,0x06,0x13,0x51,0x61,0x07
+, 0x22,0x71,0x14,0x32,0x81,0x91,0xa1,0x08,0x23,0x42,0xb1,0xc1,0x15,0x52,0xd1,0xf0
+, 0x24,0x33,0x62,0x72,0x82,0x09,0x0a,0x16,0x17,0x18,0x19,0x1a,0x25,0x26,0x27,0x28
+, 0x29,0x2a,0x34,0x35,0x36,0x37,0x38,0x39,0x3a,0x43,0x44,0x45,0x46,0x47,0x48,0x49
+, 0x4a,0x53,0x54,0x55,0x56,0x57,0x58,0x59,0x5a,0x63,0x64,0x65,0x66,0x67,0x68,0x69
+, 0x6a,0x73,0x74,0x75,0x76,0x77,0x78,0x79,0x7a,0x83,0x84,0x85,0x86,0x87,0x88,0x89
+, 0x8a,0x92,0x93,0x94,0x95,0x96,0x97,0x98,0x99,0x9a,0xa2,0xa3,0xa4,0xa5,0xa6,0xa7
+, 0xa8,0xa9,0xaa,0xb2,0xb3,0xb4,0xb5,0xb6,0xb7,0xb8,0xb9,0xba,0xc2,0xc3,0xc4,0xc5
+, 0xc6,0xc7,0xc8,0xc9,0xca,0xd2,0xd3,0xd4,0xd5,0xd6,0xd7,0xd8,0xd9,0xda,0xe1,0xe2
+, 0xe3,0xe4,0xe5,0xe6,0xe7,0xe8,0xe9,0xea,0xf1,0xf2,0xf3,0xf4,0xf5,0xf6,0xf7,0xf8
+, 0xf9,0xfa
+};
+
+static const uint8_t ac_chr_bits[16] = { 0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77 };
+static const uint8_t ac_chr_vals[162] =
+{ 0x00,0x01,0x02,0x03,0x11,0x04,0x05,0x21,0x31,0x06,0x12,0x41,0x51,0x07,0x61,0x71
+, 0x13,0x22,0x32,0x81,0x08,0x14,0x42,0x91,0xa1,0xb1,0xc1,0x09,0x23,0x33,0x52,0xf0
+, 0x15,0x62,0x72,0xd1,0x0a,0x16,0x24,0x34,0xe1,0x25,0xf1,0x17,0x18,0x19,0x1a,0x26
+, 0x27,0x28,0x29,0x2a,0x35,0x36,0x37,0x38,0x39,0x3a,0x43,0x44,0x45,0x46,0x47,0x48
+, 0x49,0x4a,0x53,0x54,0x55,0x56,0x57,0x58,0x59,0x5a,0x63,0x64,0x65,0x66,0x67,0x68
+, 0x69,0x6a,0x73,0x74,0x75,0x76,0x77,0x78,0x79,0x7a,0x82,0x83,0x84,0x85,0x86,0x87
+, 0x88,0x89,0x8a,0x92,0x93,0x94,0x95,0x96,0x97,0x98,0x99,0x9a,0xa2,0xa3,0xa4,0xa5
+, 0xa6,0xa7,0xa8,0xa9,0xaa,0xb2,0xb3,0xb4,0xb5,0xb6,0xb7,0xb8,0xb9,0xba,0xc2,0xc3
+, 0xc4,0xc5,0xc6,0xc7,0xc8,0xc9,0xca,0xd2,0xd3,0xd4,0xd5,0xd6,0xd7,0xd8,0xd9,0xda
+, 0xe2,0xe3,0xe4,0xe5,0xe6,0xe7,0xe8,0xe9,0xea,0xf2,0xf3,0xf4,0xf5,0xf6,0xf7,0xf8
+, 0xf9,0xfa
+};
+
+struct huffman_t
+{
+  uint16_t code[256];
+  uint8_t size[256];
+  void build(const uint8_t* bits, const uint8_t* vals)
+  {
+    uint32_t c = 0;
+    for (int len = 1, k = 0; len <= 16; ++len, c <<= 1)
+    {
+      for (int i = 0; i < bits[len - 1]; ++i, ++k, ++c) { code[vals[k]] = c; size[vals[k]] = len; }
+    }
+  }
+};
+
+struct jpeg_writer_t
+{
+  std::vector<uint8_t> out;
+  uint32_t acc = 0;
+  int nbits = 0;
+
+  void byte(uint8_t b) { out.push_back(b); }
+  void word(uint16_t w) { out.push_back(w >> 8); out.push_back(w); }
+  void bits(uint32_t value, int len)
+  {
+    acc = (acc << len) | (value & ((1u << len) - 1));
+    nbits += len;
+    while (nbits >= 8)
+    {
+      uint8_t b = acc >> (nbits - 8);
+      out.push_back(b);
+      if (b == 0xFF) { out.push_back(0); }
+      nbits -= 8;
+    }
+  }
+  void flush(void) { if (nbits) { bits(0x7F, 8 - nbits); } }
+
+  void dht(uint8_t id, const uint8_t* b, const uint8_t* v)
+  {
+    int n = 0;
+    for (int i = 0; i < 16; ++i) { n += b[i]; }
+    word(0xFFC4); word(2 + 1 + 16 + n); byte(id);
+    for (int i = 0; i < 16; ++i) { byte(b[i]); }
+    for (int i = 0; i < n; ++i) { byte(v[i]); }
+  }
+};
+
+static void fdct(const float* in, float* out)
+{
+  for (int v = 0; v < 8; ++v)
+  {
+    for (int u = 0; u < 8; ++u)
+    {
+      float sum = 0;
+      for (int y = 0; y < 8; ++y)
+      {
+        for (int x = 0; x < 8; ++x)
+        {
+          sum += in[y * 8 + x] * cosf((2 * x + 1) * u * (float)M_PI / 16) * cosf((2 * y + 1) * v * (float)M_PI / 16);
+        }
+      }
+      float cu = u ? 1.0f : (float)M_SQRT1_2;
+      float cv = v ? 1.0f : (float)M_SQRT1_2;
+      out[v * 8 + u] = 0.25f * cu * cv * sum;
+    }
+  }
+}
+
+static void put_value(jpeg_writer_t& w, const huffman_t& h, int symbol_run, int value)
+{
+  int a = value < 0 ? -value : value;
+  int cat = 0;
+  while (a) { ++cat; a >>= 1; }
+  int symbol = (symbol_run << 4) | cat;
+  w.bits(h.code[symbol], h.size[symbol]);
+  if (cat) { w.bits(value < 0 ? value - 1 : value, cat); }
+}
+
+// 4:4:4 のベースライン JPEG を生成する. with_tables = false の場合は DQT/DHT を省く
+static std::vector<uint8_t> encode(const lgfx::bgr888_t* rgb, bool with_tables)
+{
+  static huffman_t dc_lum, dc_chr, ac_lum, ac_chr;
+  dc_lum.build(dc_lum_bits, dc_vals);
+  dc_chr.build(dc_chr_bits, dc_vals);
+  ac_lum.build(ac_lum_bits, ac_lum_vals);
+  ac_chr.build(ac_chr_bits, ac_chr_vals);
+
+  jpeg_writer_t w;
+  w.word(0xFFD8);
+  if (with_tables)
+  {
+    w.word(0xFFDB); w.word(2 + 65 * 2);
+    w.byte(0); for (int i = 0; i < 64; ++i) { w.byte(qt_lum[zigzag[i]]); }
+    w.byte(1); for (int i = 0; i < 64; ++i) { w.byte(qt_chr[zigzag[i]]); }
+  }
+  w.word(0xFFC0); w.word(17); w.byte(8); w.word(img_h); w.word(img_w); w.byte(3);
+  w.byte(1); w.byte(0x11); w.byte(0);
+  w.byte(2); w.byte(0x11); w.byte(1);
+  w.byte(3); w.byte(0x11); w.byte(1);
+  if (with_tables)
+  {
+    w.dht(0x00, dc_lum_bits, dc_vals);
+    w.dht(0x10, ac_lum_bits, ac_lum_vals);
+    w.dht(0x01, dc_chr_bits, dc_vals);
+    w.dht(0x11, ac_chr_bits, ac_chr_vals);
+  }
+  w.word(0xFFDA); w.word(12); w.byte(3);
+  w.byte(1); w.byte(0x00);
+  w.byte(2); w.byte(0x11);
+  w.byte(3); w.byte(0x11);
+  w.byte(0); w.byte(63); w.byte(0);
+
+  int prev_dc[3] = { 0, 0, 0 };
+  float block[64], coef[64];
+  for (int by = 0; by < img_h; by += 8)
+  {
+    for (int bx = 0; bx < img_w; bx += 8)
+    {
+      for (int c = 0; c < 3; ++c)
+      {
+        for (int i = 0; i < 64; ++i)
+        {
+          auto& p = rgb[(by + (i >> 3)) * img_w + bx + (i & 7)];
+          float r = p.r, g = p.g, b = p.b;
+          float v = (c == 0) ?          0.299f * r + 0.587f * g + 0.114f * b
+                  : (c == 1) ? 128.0f - 0.168736f * r - 0.331264f * g + 0.5f * b
+                  :            128.0f + 0.5f * r - 0.418688f * g - 0.081312f * b;
+          block[i] = v - 128.0f;
+        }
+        fdct(block, coef);
+        auto qt = c ? qt_chr : qt_lum;
+        int q[64];
+        for (int i = 0; i < 64; ++i) { q[i] = (int)lroundf(coef[zigzag[i]] / qt[zigzag[i]]); }
+        auto& dc = c ? dc_chr : dc_lum;
+        auto& ac = c ? ac_chr : ac_lum;
+        put_value(w, dc, 0, q[0] - prev_dc[c]);
+        prev_dc[c] = q[0];
+        int run = 0;
+        for (int i = 1; i < 64; ++i)
+        {
+          if (q[i] == 0) { ++run; continue; }
+          while (run > 15) { w.bits(ac.code[0xF0], ac.size[0xF0]); run -= 16; }
+          put_value(w, ac, run, q[i]);
+          run = 0;
+        }
+        if (run) { w.bits(ac.code[0x00], ac.size[0x00]); }
+      }
+    }
+  }
+  w.flush();
+  w.word(0xFFD9);
+  return w.out;
+}
+
+// 動く円とグラデーションのフレーム
+static void make_frame(int index, lgfx::bgr888_t* rgb)
+{
+  int cx = 40 + index * 8;
+  int cy = 120 + (int)(60 * sinf(index * 0.3f));
+  for (int y = 0; y < img_h; ++y)
+  {
+    for (int x = 0; x < img_w; ++x)
+    {
+      int dx = x - cx, dy = y - cy;
+      bool in = dx * dx + dy * dy < 40 * 40;
+      auto& p = rgb[y * img_w + x];
+      p.r = in ? 240 : x * 255 / img_w;
+      p.g = in ? 200 : y * 255 / img_h;
+      p.b = in ? 40  : ((x ^ y) & 16) ? 160 : 96;
+    }
+  }
+}
+
+int main(void)
+{
+  std::vector<lgfx::bgr888_t> rgb(img_w * img_h);
+  std::vector<std::vector<uint8_t>> full;
+  std::vector<uint8_t> stream_full, stream_stripped;
+  for (int i = 0; i < frames; ++i)
+  {
+    make_frame(i, rgb.data());
+    full.push_back(encode(rgb.data(), true));
+    stream_full.insert(stream_full.end(), full.back().begin(), full.back().end());
+    auto f = i ? encode(rgb.data(), false) : full.back();
+    stream_stripped.insert(stream_stripped.end(), f.begin(), f.end());
+  }
+
+  LGFX_Sprite sprite;
+  sprite.setColorDepth(16);
+  sprite.createSprite(img_w, img_h);
+
+  printf("%-34s %9s %8s   %16s\n", "(320x240, 30 frames)", "ms/frame", "fps", "last frame hash");
+
+  for (uint16_t sz_buf : { 512, 4096 })
+  {
+    sprite.setJpgInputBufferSize(sz_buf);
+    int index = 0;
+    bool ok = true;
+    double us = bench_usec([&]()
+    {
+      auto& f = full[index];
+      ok &= sprite.drawJpg(f.data(), f.size(), 0, 0);
+      if (++index == frames) { index = 0; }
+    });
+    sprite.drawJpg(full[frames - 1].data(), full[frames - 1].size(), 0, 0);
+    char name[40];
+    snprintf(name, sizeof(name), "drawJpg, input buffer %u", sz_buf);
+    printf("%-34s %9.2f %8.1f   %016llx%s\n", name, us / 1000, 1000000 / us
+          , (unsigned long long)bench_hash(sprite.getBuffer(), sprite.bufferLength()), ok ? "" : "  (decode error)");
+  }
+  sprite.setJpgInputBufferSize(512);
+
+  const struct { const std::vector<uint8_t>* stream; const char* name; } streams[] =
+  { { &stream_full    , "MJpegPlayer, tables in every frame" }
+  , { &stream_stripped, "MJpegPlayer, tables in 1st frame"   }
+  };
+  for (auto& s : streams)
+  {
+    lgfx::LGFX_MJpegPlayer player;
+    uint32_t drawn = 0;
+    double us = bench_usec([&]()
+    {
+      player.begin(&sprite, s.stream->data(), s.stream->size(), 4096);
+      while (player.drawNextFrame()) { ++drawn; }
+    }) / frames;
+    printf("%-34s %9.2f %8.1f   %016llx%s\n", s.name, us / 1000, 1000000 / us
+          , (unsigned long long)bench_hash(sprite.getBuffer(), sprite.bufferLength())
+          , (drawn % frames) ? "  (frames lost)" : "");
+  }
+
+  // テーブルを持たないフレームは、drawJpg では前の画像のテーブルを使わずにエラーとなる
+  sprite.drawJpg(full[0].data(), full[0].size(), 0, 0);
+  size_t first_len = full[0].size();
+  bool decoded = sprite.drawJpg(&stream_stripped[first_len], full[1].size(), 0, 0);
+  printf("frame without tables given to drawJpg: %s\n", decoded ? "decoded (unexpected)" : "rejected");
+  return 0;
+}
@@ -0,0 +1,85 @@
+// Panel_LCD の単色矩形の送信待ちキューの効果を、描画1回あたりのバス送信バイト数で測る
+// キューを使わない Panel_ILI9341 と比べ、記録したバイト列から組み立てた画面の内容が同じになることも確かめる
+#include "bench_bus.hpp"
+
+// 送信待ちキューを使わないパネル
+struct Panel_ILI9341_NoQueue : public lgfx::Panel_ILI9341
+{
+  Panel_ILI9341_NoQueue(void) { _fill_queue_mode = fill_queue_disabled; }
+};
+
+static void draw_checker(lgfx::LGFXBase* gfx)
+{
+  gfx->startWrite();
+  for (int y = 0; y < 64; ++y)
+  {
+    for (int x = 0; x < 64; ++x)
+    {
+      gfx->drawPixel(100 + x, 100 + y, (((x ^ y) >> 2) & 1) ? TFT_WHITE : TFT_BLUE);
+    }
+  }
+  gfx->endWrite();
+}
+
+// 送信待ちのある状態で色深度を変える
+static void draw_depth_change(lgfx::LGFXBase* gfx)
+{
+  gfx->startWrite();
+  gfx->fillRect(10, 10, 40, 8, TFT_RED);
+  gfx->fillRect(10, 18, 40, 8, TFT_RED);
+  gfx->setColorDepth(24);
+  gfx->fillRect(60, 10, 40, 8, TFT_GREEN);
+  gfx->fillRect(60, 18, 40, 8, TFT_GREEN);
+  gfx->setColorDepth(16);
+  gfx->fillRect(10, 30, 90, 4, TFT_YELLOW);
+  gfx->endWrite();
+}
+
+struct scene_t
+{
+  const char* name;
+  void (*draw)(lgfx::LGFXBase* gfx);
+};
+
+static const scene_t scenes[] =
+{ { "drawString Font2"          , [](lgfx::LGFXBase* g) { g->setFont(&lgfx::fonts::Font2); g->setTextColor(TFT_WHITE); g->drawString("Hello, World 123", 10, 10); } }
+, { "drawString Font2 with bg"  , [](lgfx::LGFXBase* g) { g->setFont(&lgfx::fonts::Font2); g->setTextColor(TFT_WHITE, TFT_NAVY); g->drawString("Hello, World 123", 10, 10); } }
+, { "drawString Font4 with bg"  , [](lgfx::LGFXBase* g) { g->setFont(&lgfx::fonts::Font4); g->setTextColor(TFT_WHITE, TFT_NAVY); g->drawString("Hello, World 123", 10, 10); } }
+, { "drawArc 80/70 0-270"       , [](lgfx::LGFXBase* g) { g->drawArc(120, 160, 80, 70, 0, 270, TFT_ORANGE); } }
+, { "fillTriangle"              , [](lgfx::LGFXBase* g) { g->fillTriangle(10, 20, 230, 60, 60, 300, TFT_CYAN); } }
+, { "drawRoundRect"             , [](lgfx::LGFXBase* g) { g->drawRoundRect(20, 20, 200, 120, 16, TFT_GREEN); } }
+, { "drawCircle r60"            , [](lgfx::LGFXBase* g) { g->drawCircle(120, 160, 60, TFT_MAGENTA); } }
+, { "drawLine shallow"          , [](lgfx::LGFXBase* g) { g->drawLine(0, 100, 239, 130, TFT_WHITE); } }
+, { "64x64 drawPixel 4x4 cells" , draw_checker }
+, { "fillRect / setColorDepth"  , draw_depth_change }
+};
+
+// 1つの場面を描き、送信バイト数と組み立てた画面を返す
+template <typename TPanel>
+static uint64_t run(const scene_t& scene, uint64_t* hash)
+{
+  LGFX_Recorded<TPanel> gfx;
+  gfx.init();
+  gfx.fillScreen(TFT_BLACK);
+  FrameDecoder decoder;
+  decoder.feed(gfx.takeRecord());
+  gfx.bus.resetStats();
+  scene.draw(&gfx);
+  decoder.feed(gfx.takeRecord());
+  *hash = decoder.hash();
+  return gfx.bus.getStats().total_bytes();
+}
+
+int main(void)
+{
+  printf("%-26s %10s %10s %7s   %s\n", "(bus bytes)", "no queue", "queue", "ratio", "frame");
+  for (auto& scene : scenes)
+  {
+    uint64_t hash_off, hash_on;
+    uint64_t off = run<Panel_ILI9341_NoQueue>(scene, &hash_off);
+    uint64_t on = run<lgfx::Panel_ILI9341>(scene, &hash_on);
+    printf("%-26s %10llu %10llu %6.0f%%   %s\n", scene.name, (unsigned long long)off, (unsigned long long)on
+          , on * 100.0 / off, hash_off == hash_on ? "same" : "DIFFERENT");
+  }
+  return 0;
+}
@@ -0,0 +1,132 @@
+// Panel_fb の描画速度 (MB/s) を測る
+// /dev/fb0 の代わりに一時ファイルを mmap し、ioctl で得る画面情報を自前で設定する
+// 行の長さ (line_length) には画面の幅より長い余白を付け、copyRect などが余白を書き換えないことも確かめる
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+#include <lgfx/v1/platforms/framebuffer/Panel_fb.hpp>
+
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "bench_common.hpp"
+
+static constexpr int screen_w = 1920;
+static constexpr int screen_h = 1080;
+static constexpr int line_pad = 64;  // 行末の余白 (バイト)
+
+// 一時ファイルをフレームバッファとして使う Panel_fb
+class Panel_fbFile : public lgfx::Panel_fb
+{
+public:
+  Panel_fbFile(int bpp) : _bpp(bpp) {}
+
+  bool init(bool use_reset) override
+  {
+    char path[] = "/tmp/lgfx_bench_fbXXXXXX";
+    _fbfd = mkstemp(path);
+    if (_fbfd == -1) { return false; }
+    unlink(path);
+
+    memset(&_var_info, 0, sizeof(_var_info));
+    memset(&_fix_info, 0, sizeof(_fix_info));
+    _var_info.xres = _var_info.xres_virtual = screen_w;
+    _var_info.yres = _var_info.yres_virtual = screen_h;
+    _var_info.bits_per_pixel = _bpp;
+    _fix_info.line_length = screen_w * (_bpp >> 3) + line_pad;
+    _fix_info.smem_len = _fix_info.line_length * screen_h;
+    setColorDepth((lgfx::color_depth_t)_bpp);
+
+    _screensize = _fix_info.smem_len;
+    if (ftruncate(_fbfd, _screensize)) { return false; }
+    _fbp = (char*)mmap(0, _screensize, PROT_READ | PROT_WRITE, MAP_SHARED, _fbfd, 0);
+    if ((intptr_t)_fbp == -1) { _fbp = nullptr; return false; }
+    memset(_fbp, 0, _screensize);
+    return Panel_Device::init(use_reset);
+  }
+
+  void resetPadding(void)
+  {
+    for (int y = 0; y < screen_h; ++y)
+    {
+      memset(&_fbp[y * _fix_info.line_length + screen_w * (_bpp >> 3)], 0xA5, line_pad);
+    }
+  }
+
+  // 各行の余白が resetPadding の後のままか
+  bool paddingUntouched(void) const
+  {
+    for (int y = 0; y < screen_h; ++y)
+    {
+      auto pad = (const uint8_t*)&_fbp[y * _fix_info.line_length + screen_w * (_bpp >> 3)];
+      for (int i = 0; i < line_pad; ++i) { if (pad[i] != 0xA5) { return false; } }
+    }
+    return true;
+  }
+
+private:
+  int _bpp;
+};
+
+class LGFX : public lgfx::LGFX_Device
+{
+public:
+  LGFX(lgfx::Panel_Device* panel) { setPanel(panel); }
+};
+
+static void run(int bpp)
+{
+  Panel_fbFile panel(bpp);
+  {
+    // パネルの幅を画面より広く設定し、画面の外にはみ出す copyRect を試す
+    auto cfg = panel.config();
+    cfg.memory_width  = cfg.panel_width  = screen_w + 16;
+    cfg.memory_height = cfg.panel_height = screen_h;
+    panel.config(cfg);
+  }
+  LGFX gfx(&panel);
+  if (!gfx.init()) { printf("%dbpp: init failed\n", bpp); return; }
+
+  // バイト数 / us = MB/s
+  double bytes = bpp >> 3;
+  double screen = screen_w * bytes * screen_h;
+  double rect = 300 * bytes * 200;
+
+  uint32_t c = 0;
+  double fill_screen = bench_usec([&]() { gfx.fillRect(0, 0, screen_w, screen_h, ++c); }, 0.5);
+  double fill_rect = bench_usec([&]() { gfx.fillRect(101, 57, 300, 200, ++c); }, 0.5);
+
+  // pixelcopy には argb8888 へ変換する関数が無いため、32bpp では画像の転送を測らない
+  double push_rate = 0;
+  if (bpp != 32)
+  {
+    LGFX_Sprite sprite;
+    sprite.setColorDepth(16);
+    sprite.createSprite(640, 480);
+    for (int y = 0; y < 480; ++y) { sprite.drawFastHLine(0, y, 640, sprite.color565(y, y * 3, 255 - y)); }
+    double push = bench_usec([&]() { sprite.pushSprite(&gfx, 200, 100); }, 0.5);
+    push_rate = 640 * bytes * 480 / push;
+  }
+
+  double copy = bench_usec([&]() { gfx.copyRect(10, 20, 1200, 800, 30, 10); }, 0.5);
+  double copy_bytes = 1200 * bytes * 800;
+
+  // init の画面消去はパネルの幅で行われ余白に及ぶため、ここで余白を戻してから確かめる
+  panel.resetPadding();
+  gfx.copyRect(0, 0, gfx.width(), 100, 8, 200);
+  gfx.copyRect(8, 300, gfx.width(), 100, 0, 400);
+  bool padding = panel.paddingUntouched();
+
+  char push_text[16] = "n/a";
+  if (push_rate) { snprintf(push_text, sizeof(push_text), "%.0f", push_rate); }
+  printf("%2dbpp %12.0f %12.0f %12s %12.0f   %s\n", bpp
+        , screen / fill_screen, rect / fill_rect, push_text, copy_bytes / copy
+        , padding ? "untouched" : "OVERWRITTEN");
+}
+
+int main(void)
+{
+  printf("%-5s %12s %12s %12s %12s   %s\n", "(MB/s)", "fillScreen", "fill 300x200", "pushSprite16", "copyRect", "line padding");
+  for (int bpp : { 16, 24, 32 }) { run(bpp); }
+  return 0;
+}
@@ -0,0 +1,112 @@
+// pixelcopy のベクトル化した変換・合成の経路 (pixelcopy_simd_t) を、1ピクセルずつ処理する経路と比べる
+// 長さ 1 ~ 4099 のすべてで結果が一致することを確かめ、4096 ピクセルでの処理速度 (Mpx/s) を表示する
+// 1ピクセルずつの経路には、変換は copy_rgb_affine を、合成は blend_rgb_fast の連続していない転送元向けの処理を使う
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+
+#include <string.h>
+#include <vector>
+
+#include "bench_common.hpp"
+
+using namespace lgfx;
+
+static constexpr uint32_t max_len = 4099;
+static constexpr uint32_t speed_len = 4096;
+
+static uint32_t rand_state = 1;
+static uint32_t next_rand(void) { rand_state = rand_state * 1103515245u + 12345u; return rand_state >> 8; }
+
+static void fill_random(std::vector<uint8_t>& buf)
+{
+  for (auto& b : buf) { b = next_rand(); }
+}
+
+// 合成では、完全に透明・完全に不透明・半透明のピクセルが混ざるようにする
+static void fill_random_alpha(std::vector<uint8_t>& buf)
+{
+  fill_random(buf);
+  for (size_t i = 3; i < buf.size(); i += 4)
+  {
+    uint32_t r = next_rand() % 4;
+    buf[i] = (r == 0) ? 0 : (r == 1) ? 255 : buf[i];
+  }
+}
+
+template <typename TDst, typename TSrc>
+static uint32_t run_copy(void* dst, const void* src, uint32_t len, bool simd)
+{
+  pixelcopy_t pc;
+  pc.src_data = src;
+  pc.src_bitwidth = len;
+  pc.src_x32_add = 1 << pixelcopy_t::FP_SCALE;
+  pc.src_y32_add = 0;
+  uint32_t index = 0;
+  do
+  {
+    index = simd ? pixelcopy_t::copy_rgb_fast<TDst, TSrc>(dst, index, len, &pc)
+                 : pixelcopy_t::copy_rgb_affine<TDst, TSrc>(dst, index, len, &pc);
+  } while (index != len);
+  return len;
+}
+
+template <typename TDst, typename TSrc>
+static uint32_t run_blend(void* dst, const void* src, uint32_t len, bool simd)
+{
+  pixelcopy_t pc;
+  pc.src_data = src;
+  pc.src_bitwidth = len;
+  pc.src_x32_add = 1 << pixelcopy_t::FP_SCALE;
+  // 1 / 65536 ピクセルの縦方向の移動は同じ行に留まるが、転送元が連続していないものとして1ピクセルずつの処理になる
+  pc.src_y32_add = simd ? 0 : 1;
+  return pixelcopy_t::blend_rgb_fast<TDst, TSrc>(dst, 0, len, &pc);
+}
+
+template <typename TDst, typename TSrc, bool blend>
+static void bench_pair(const char* name)
+{
+  auto run = [](void* dst, const void* src, uint32_t len, bool simd)
+  {
+    if constexpr (blend) { return run_blend<TDst, TSrc>(dst, src, len, simd); }
+    else                 { return run_copy <TDst, TSrc>(dst, src, len, simd); }
+  };
+  std::vector<uint8_t> src(max_len * sizeof(TSrc));
+  std::vector<uint8_t> dst_init(max_len * sizeof(TDst));
+  std::vector<uint8_t> dst_scalar(dst_init.size());
+  std::vector<uint8_t> dst_simd(dst_init.size());
+
+  uint32_t mismatch = 0;
+  for (uint32_t len = 1; len <= max_len; ++len)
+  {
+    if (blend) { fill_random_alpha(src); } else { fill_random(src); }
+    fill_random(dst_init);
+    dst_scalar = dst_init;
+    dst_simd = dst_init;
+    run(dst_scalar.data(), src.data(), len, false);
+    run(dst_simd.data(), src.data(), len, true);
+    if (dst_scalar != dst_simd) { ++mismatch; }
+  }
+
+  double scalar = bench_usec([&]() { run(dst_scalar.data(), src.data(), speed_len, false); }, 0.3);
+  double simd = bench_usec([&]() { run(dst_simd.data(), src.data(), speed_len, true); }, 0.3);
+  printf("%-28s %10.0f %10.0f %7.2fx   %s\n", name, speed_len / scalar, speed_len / simd, scalar / simd
+        , mismatch ? "MISMATCH" : "identical");
+  if (mismatch) { printf("  %u of %u lengths differ\n", mismatch, max_len); }
+}
+
+int main(void)
+{
+#if LGFX_PIXELCOPY_SIMD
+  printf("LGFX_PIXELCOPY_SIMD = 1\n");
+#else
+  printf("LGFX_PIXELCOPY_SIMD = 0 (the two paths are the same scalar code)\n");
+#endif
+  printf("%-28s %10s %10s %8s   %s\n", "(Mpx/s)", "scalar", "simd", "ratio", "1..4099");
+  bench_pair<bgr888_t  , swap565_t , false>("copy  swap565  -> bgr888"  );
+  bench_pair<swap565_t , bgr888_t  , false>("copy  bgr888   -> swap565" );
+  bench_pair<argb8888_t, bgr888_t  , false>("copy  bgr888   -> argb8888");
+  bench_pair<bgr888_t  , argb8888_t, false>("copy  argb8888 -> bgr888"  );
+  bench_pair<bgr888_t  , argb8888_t, true >("blend argb8888 -> bgr888"  );
+  bench_pair<swap565_t , argb8888_t, true >("blend argb8888 -> swap565" );
+  return 0;
+}
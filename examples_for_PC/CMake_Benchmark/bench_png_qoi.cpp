@@ -0,0 +1,112 @@
+// 画面の内容を画像にする処理 (createPng / writePng / writeQoi) の時間と出力サイズを比べる
+// 出力した画像を drawPng / drawQoi で別のスプライトに描き戻し、元の内容と同じになることを確かめる
+// writeQoi を複数のスレッドで同時に実行し、1つずつ実行した場合と同じ出力になることも確かめる
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include "bench_common.hpp"
+
+static constexpr int width = 320;
+static constexpr int height = 240;
+static constexpr int thread_count = 4;
+
+// 画面らしい内容 (グラデーションの背景・塗り潰し・文字)
+static void draw_scene(LGFX_Sprite& sprite, int seed)
+{
+  for (int y = 0; y < height; ++y)
+  {
+    sprite.drawFastHLine(0, y, width, sprite.color565(y, (y + seed * 40) & 255, 255 - y));
+  }
+  sprite.fillRoundRect(20, 20, 180, 60, 10, TFT_NAVY);
+  sprite.fillCircle(250, 150, 50 + seed * 5, TFT_ORANGE);
+  sprite.setFont(&fonts::Font2);
+  sprite.setTextColor(TFT_WHITE);
+  sprite.setCursor(30, 40);
+  sprite.printf("scene %d 0123456789", seed);
+}
+
+static bool append(void* user, const uint8_t* data, uint32_t length)
+{
+  auto out = static_cast<std::vector<uint8_t>*>(user);
+  out->insert(out->end(), data, data + length);
+  return true;
+}
+
+// 画像を描き戻した結果が元のスプライトと同じか
+static bool round_trip(LGFX_Sprite& src, const std::vector<uint8_t>& image, bool png)
+{
+  LGFX_Sprite dst;
+  dst.setColorDepth(src.getColorDepth());
+  dst.createSprite(width, height);
+  dst.fillScreen(TFT_BLACK);
+  if (png) { dst.drawPng(image.data(), image.size(), 0, 0); }
+  else     { dst.drawQoi(image.data(), image.size(), 0, 0); }
+  return 0 == memcmp(src.getBuffer(), dst.getBuffer(), src.bufferLength());
+}
+
+int main(void)
+{
+  LGFX_Sprite sprite;
+  sprite.setColorDepth(16);
+  sprite.createSprite(width, height);
+  draw_scene(sprite, 0);
+
+  std::vector<uint8_t> image;
+  size_t created_len = 0;
+  double create_png = bench_usec([&]()
+  {
+    void* data = sprite.createPng(&created_len);
+    image.assign((uint8_t*)data, (uint8_t*)data + created_len);
+    free(data);
+  }, 0.5);
+  bool create_ok = round_trip(sprite, image, true);
+
+  double write_png = bench_usec([&]() { image.clear(); sprite.writePng(append, &image); }, 0.5);
+  size_t png_len = image.size();
+  bool png_ok = round_trip(sprite, image, true);
+
+  double write_qoi = bench_usec([&]() { image.clear(); sprite.writeQoi(append, &image); }, 0.5);
+  size_t qoi_len = image.size();
+  bool qoi_ok = round_trip(sprite, image, false);
+
+  printf("%-10s %10s %10s   %s\n", "(320x240)", "us", "bytes", "drawn back");
+  printf("%-10s %10.0f %10zu   %s\n", "createPng", create_png, created_len, create_ok ? "same" : "DIFFERENT");
+  printf("%-10s %10.0f %10zu   %s\n", "writePng", write_png, png_len, png_ok ? "same" : "DIFFERENT");
+  printf("%-10s %10.0f %10zu   %s\n", "writeQoi", write_qoi, qoi_len, qoi_ok ? "same" : "DIFFERENT");
+
+  // スレッドごとに別の内容のスプライトを用意し、まず1つずつ出力する
+  std::vector<LGFX_Sprite> sprites(thread_count);
+  std::vector<std::vector<uint8_t>> expected(thread_count);
+  for (int i = 0; i < thread_count; ++i)
+  {
+    sprites[i].setColorDepth(16);
+    sprites[i].createSprite(width, height);
+    draw_scene(sprites[i], i + 1);
+    sprites[i].writeQoi(append, &expected[i]);
+  }
+
+  int failed = 0, differ = 0;
+  for (int round = 0; round < 50; ++round)
+  {
+    std::vector<std::vector<uint8_t>> results(thread_count);
+    std::vector<bool> ok(thread_count);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < thread_count; ++i)
+    {
+      threads.emplace_back([&, i]() { ok[i] = sprites[i].writeQoi(append, &results[i]); });
+    }
+    for (auto& t : threads) { t.join(); }
+    for (int i = 0; i < thread_count; ++i)
+    {
+      if (!ok[i]) { ++failed; }
+      else if (results[i] != expected[i]) { ++differ; }
+    }
+  }
+  printf("writeQoi x %d threads x 50: %d failed, %d different\n", thread_count, failed, differ);
+  return 0;
+}
@@ -0,0 +1,82 @@
+// アンチエイリアスの図形 (drawWideLine / drawWedgeLine / fillSmoothRoundRect / fillSmoothCircle) の
+// 描画1回あたりのバス送受信バイト数とアドレス設定 (CASET/RASET) の回数を、1ピクセルずつ描く方法と比べる
+// 1ピクセルずつの方法は、行ごとの合成を行う前の描き方 (覆われたピクセルは drawPixel、縁は fillRectAlpha(x, y, 1, 1)) を再現する
+// 縁の不透明度は、黒の背景に白で描いたスプライトの明るさから求める
+// どちらも同じ Panel_ILI9341 に描くため、連続した drawPixel は単色矩形の送信待ちキューでまとめられる
+// Bus_Recorder の読出しは 0 を返すため、どちらも黒の背景に合成した画面になる。組み立てた画面が一致するかも表示する
+#include "bench_bus.hpp"
+
+static constexpr int width = 240;
+static constexpr int height = 320;
+static constexpr uint32_t white = 0xFFFFFFu;  // rgb888
+
+struct shape_t
+{
+  const char* name;
+  void (*draw)(lgfx::LGFXBase* gfx, uint32_t color);
+};
+
+static const shape_t shapes[] =
+{ { "drawWideLine r4"          , [](lgfx::LGFXBase* g, uint32_t c) { g->drawWideLine(20, 30, 220, 290, 4.0f, c); } }
+, { "drawWedgeLine r1-8"       , [](lgfx::LGFXBase* g, uint32_t c) { g->drawWedgeLine(30, 300, 210, 40, 1.0f, 8.0f, c); } }
+, { "fillSmoothRoundRect r24"  , [](lgfx::LGFXBase* g, uint32_t c) { g->fillSmoothRoundRect(20, 40, 200, 120, 24, c); } }
+, { "fillSmoothCircle r80"     , [](lgfx::LGFXBase* g, uint32_t c) { g->fillSmoothCircle(120, 200, 80, c); } }
+};
+
+struct result_t
+{
+  lgfx::Bus_Recorder::stats_t stats;
+  uint64_t hash;
+};
+
+template <typename TFunc>
+static result_t run(TFunc draw)
+{
+  LGFX_Recorded<> gfx;
+  gfx.init();
+  gfx.fillScreen(TFT_BLACK);
+  FrameDecoder decoder(width, height);
+  decoder.feed(gfx.takeRecord());
+  gfx.bus.resetStats();
+  draw(&gfx);
+  decoder.feed(gfx.takeRecord());
+  return { gfx.bus.getStats(), decoder.hash() };
+}
+
+int main(void)
+{
+  LGFX_Sprite coverage;
+  coverage.setColorDepth(24);
+  coverage.createSprite(width, height);
+
+  printf("%-24s %10s %10s %8s %10s %10s %8s %7s   %s\n", "(per draw)", "px bytes", "px read", "px win"
+        , "span bytes", "span read", "span win", "ratio", "frame");
+  for (auto& shape : shapes)
+  {
+    coverage.fillScreen(TFT_BLACK);
+    shape.draw(&coverage, white);
+
+    auto per_pixel = run([&](lgfx::LGFXBase* gfx)
+    {
+      gfx->startWrite();
+      for (int y = 0; y < height; ++y)
+      {
+        for (int x = 0; x < width; ++x)
+        {
+          uint8_t alpha = coverage.readPixelRGB(x, y).R8();
+          if (alpha == 255) { gfx->drawPixel(x, y, white); }
+          else if (alpha) { gfx->fillRectAlpha(x, y, 1, 1, alpha, white); }
+        }
+      }
+      gfx->endWrite();
+    });
+    auto span = run([&](lgfx::LGFXBase* gfx) { shape.draw(gfx, white); });
+
+    printf("%-24s %10llu %10llu %8u %10llu %10llu %8u %6.1f%%   %s\n", shape.name
+          , (unsigned long long)per_pixel.stats.total_bytes(), (unsigned long long)per_pixel.stats.read_bytes, per_pixel.stats.windows
+          , (unsigned long long)span.stats.total_bytes(), (unsigned long long)span.stats.read_bytes, span.stats.windows
+          , span.stats.total_bytes() * 100.0 / per_pixel.stats.total_bytes()
+          , per_pixel.hash == span.hash ? "same" : "DIFFERENT");
+  }
+  return 0;
+}
@@ -0,0 +1,82 @@
+// drawString と、事前に準備した LGFX_TextRun の描画を比較する
+// ROMフォントでは textWidth と描画の時間を、VLWフォントではフォントデータの読出し回数も表示する
+// VLWフォントは ASCII の文字をその場で生成し、読出し回数を数える DataWrapper から読み込む
+// 描画結果のハッシュは drawString と LGFX_TextRun で同じになる
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+#include <lgfx/v1/LGFX_TextRun.hpp>
+
+#include "bench_common.hpp"
+#include "bench_font.hpp"
+
+static const char label[] = "Temp 23.5C  Hum 41%";
+
+static void bench_font(LGFX_Sprite& sprite, const char* name)
+{
+  lgfx::LGFX_TextRun run;
+  run.prepare(&sprite, label);
+
+  double width_str = bench_usec([&]() { sprite.textWidth(label); }, 0.3);
+  double width_run = bench_usec([&]() { run.textWidth(&sprite); }, 0.3);
+  double draw_str = bench_usec([&]() { sprite.drawString(label, 8, 8); }, 0.3);
+  double draw_run = bench_usec([&]() { run.drawString(&sprite, 8, 8); }, 0.3);
+
+  sprite.clear();
+  sprite.drawString(label, 8, 8);
+  uint64_t hash_str = bench_hash(sprite.getBuffer(), sprite.bufferLength());
+  sprite.clear();
+  run.drawString(&sprite, 8, 8);
+  uint64_t hash_run = bench_hash(sprite.getBuffer(), sprite.bufferLength());
+
+  printf("%-26s %9.3f %9.3f %9.2f %9.2f   %s\n", name, width_str, width_run, draw_str, draw_run
+        , hash_str == hash_run ? "same" : "DIFFERENT");
+}
+
+int main(void)
+{
+  LGFX_Sprite sprite;
+  sprite.setColorDepth(16);
+  sprite.createSprite(320, 64);
+  sprite.setTextColor(0xFFFFFFu, 0x000040u);
+  sprite.setTextPadding(300);
+
+  printf("%-26s %9s %9s %9s %9s   %s\n", "(us)", "width:str", "width:run", "draw:str", "draw:run", "result");
+  const struct { const lgfx::IFont* font; const char* name; } fonts[] =
+  { { &lgfx::fonts::Font0                    , "Font0"                     }
+  , { &lgfx::fonts::Font2                    , "Font2"                     }
+  , { &lgfx::fonts::Font4                    , "Font4"                     }
+  , { &lgfx::fonts::Font7                    , "Font7"                     }
+  , { &lgfx::fonts::FreeSansBoldOblique12pt7b, "FreeSansBoldOblique12pt7b" }
+  , { &lgfx::fonts::Orbitron_Light_24        , "Orbitron_Light_24"         }
+  };
+  for (auto& f : fonts)
+  {
+    sprite.setFont(f.font);
+    bench_font(sprite, f.name);
+  }
+
+  auto vlw = make_vlw();
+  for (size_t cache : { 0u, 32768u })
+  {
+    CountingWrapper data(vlw.data(), vlw.size());
+    sprite.setFontCacheSize(cache);
+    sprite.loadFont(&data);
+    char name[32];
+    snprintf(name, sizeof(name), "VLW (cache %zu)", cache);
+    bench_font(sprite, name);
+
+    lgfx::LGFX_TextRun run;
+    run.prepare(&sprite, label);
+    sprite.drawString(label, 8, 8);
+    run.drawString(&sprite, 8, 8);
+    data.reads = data.seeks = 0;
+    sprite.drawString(label, 8, 8);
+    uint32_t str_reads = data.reads, str_seeks = data.seeks;
+    data.reads = data.seeks = 0;
+    run.drawString(&sprite, 8, 8);
+    printf("  per draw: drawString %u reads / %u seeks, run %u reads / %u seeks\n"
+          , str_reads, str_seeks, data.reads, data.seeks);
+    sprite.unloadFont();
+  }
+  return 0;
+}
@@ -0,0 +1,161 @@
+// Touch_Replay で記録したタッチ操作 (スライダーのドラッグとボタンのタップ) を再生し、
+// 画面の更新1フレームあたりのバス送信バイト数を Bus_Recorder で数える
+// 毎フレーム全体を描き直す方法と、変化した部分だけを描き直す方法を比べ、最後の画面が同じになることを確かめる
+#include "bench_bus.hpp"
+#include <lgfx/v1/touch/Touch_Replay.hpp>
+
+#include <algorithm>
+
+static constexpr int width = 240;
+static constexpr int height = 320;
+static constexpr uint32_t frame_msec = 16;
+static constexpr uint32_t trace_msec = 1300;
+
+static constexpr int slider_y = 120;
+static constexpr int slider_left = 30;
+static constexpr int slider_right = 210;
+static constexpr int knob_r = 12;
+static constexpr int button_x = 70, button_y = 230, button_w = 100, button_h = 44;
+
+// 左から右へのドラッグと、ボタンのタップ
+static std::vector<lgfx::touch_event_t> make_trace(void)
+{
+  std::vector<lgfx::touch_event_t> trace;
+  auto add = [&](uint32_t msec, int x, int y)
+  {
+    lgfx::touch_event_t e;
+    e.msec = msec;
+    e.count = (x >= 0) ? 1 : 0;
+    e.point[0].x = x;
+    e.point[0].y = y;
+    e.point[0].size = e.count;
+    trace.push_back(e);
+  };
+  add(0, -1, -1);
+  for (uint32_t t = 100; t <= 700; t += 20) { add(t, 40 + (t - 100) * 160 / 600, slider_y + 3); }
+  add(720, -1, -1);
+  add(900, button_x + 50, button_y + 20);
+  add(980, -1, -1);
+  return trace;
+}
+
+struct ui_state_t
+{
+  int value = slider_left;
+  bool pressed = false;
+};
+
+static ui_state_t update_state(ui_state_t state, uint_fast8_t count, const lgfx::touch_point_t& tp)
+{
+  state.pressed = false;
+  if (count == 0) { return state; }
+  if (abs(tp.y - slider_y) <= knob_r * 2)
+  {
+    state.value = std::min(std::max((int)tp.x, slider_left), slider_right);
+  }
+  state.pressed = (tp.x >= button_x && tp.x < button_x + button_w && tp.y >= button_y && tp.y < button_y + button_h);
+  return state;
+}
+
+static void draw_slider(lgfx::LGFXBase* gfx, const ui_state_t& state)
+{
+  gfx->fillRect(0, slider_y - knob_r - 1, width, knob_r * 2 + 3, TFT_BLACK);
+  gfx->fillRoundRect(slider_left, slider_y - 3, slider_right - slider_left + 1, 7, 3, TFT_DARKGREY);
+  gfx->fillRoundRect(slider_left, slider_y - 3, state.value - slider_left + 1, 7, 3, TFT_CYAN);
+  gfx->fillSmoothCircle(state.value, slider_y, knob_r, TFT_WHITE);
+}
+
+static void draw_value(lgfx::LGFXBase* gfx, const ui_state_t& state)
+{
+  gfx->setFont(&lgfx::fonts::Font4);
+  gfx->setTextColor(TFT_WHITE, TFT_BLACK);
+  gfx->setTextPadding(100);
+  gfx->setTextDatum(lgfx::textdatum_t::top_center);
+  char text[8];
+  snprintf(text, sizeof(text), "%d", (state.value - slider_left) * 100 / (slider_right - slider_left));
+  gfx->drawString(text, width / 2, 60);
+}
+
+static void draw_button(lgfx::LGFXBase* gfx, const ui_state_t& state)
+{
+  gfx->fillRoundRect(button_x, button_y, button_w, button_h, 8, state.pressed ? TFT_ORANGE : TFT_NAVY);
+  gfx->setFont(&lgfx::fonts::Font2);
+  gfx->setTextColor(TFT_WHITE);
+  gfx->setTextPadding(0);
+  gfx->setTextDatum(lgfx::textdatum_t::middle_center);
+  gfx->drawString("OK", button_x + button_w / 2, button_y + button_h / 2);
+}
+
+static void draw_all(lgfx::LGFXBase* gfx, const ui_state_t& state)
+{
+  gfx->fillScreen(TFT_BLACK);
+  draw_value(gfx, state);
+  draw_slider(gfx, state);
+  draw_button(gfx, state);
+}
+
+static void draw_changed(lgfx::LGFXBase* gfx, const ui_state_t& prev, const ui_state_t& state)
+{
+  if (prev.value != state.value) { draw_value(gfx, state); draw_slider(gfx, state); }
+  if (prev.pressed != state.pressed) { draw_button(gfx, state); }
+}
+
+static void run(const char* name, const std::vector<lgfx::touch_event_t>& trace, bool full)
+{
+  lgfx::Touch_Replay touch;
+  {
+    auto cfg = touch.config();
+    cfg.x_max = width - 1;
+    cfg.y_max = height - 1;
+    touch.config(cfg);
+  }
+  touch.setTrace(trace.data(), trace.size());
+
+  LGFX_Recorded<> gfx;
+  gfx.panel.setTouch(&touch);
+  gfx.init();
+  FrameDecoder decoder(width, height);
+
+  ui_state_t state;
+  gfx.startWrite();
+  draw_all(&gfx, state);
+  gfx.endWrite();
+  decoder.feed(gfx.takeRecord());
+
+  uint32_t frames = 0, idle = 0;
+  uint64_t total = 0, peak = 0;
+  for (uint32_t msec = 0; msec <= trace_msec; msec += frame_msec)
+  {
+    touch.setTime(msec);
+    lgfx::touch_point_t tp;
+    auto count = gfx.getTouch(&tp, 1);
+    auto next = update_state(state, count, tp);
+
+    gfx.bus.resetStats();
+    gfx.startWrite();
+    if (full) { draw_all(&gfx, next); }
+    else      { draw_changed(&gfx, state, next); }
+    gfx.endWrite();
+    state = next;
+
+    auto& stats = gfx.bus.getStats();
+    uint64_t bytes = stats.total_bytes();
+    decoder.feed(gfx.takeRecord());
+    ++frames;
+    total += bytes;
+    peak = std::max(peak, bytes);
+    // endWrite は NOP を1バイト送るため、画素を送らなかったフレームを数える
+    if (stats.windows == 0) { ++idle; }
+  }
+  printf("%-10s %7u %7u %12.0f %12llu %14llu   %016llx\n", name, frames, idle, (double)total / frames
+        , (unsigned long long)peak, (unsigned long long)total, (unsigned long long)decoder.hash());
+}
+
+int main(void)
+{
+  auto trace = make_trace();
+  printf("%-10s %7s %7s %12s %12s %14s   %16s\n", "(bytes)", "frames", "idle", "avg/frame", "max/frame", "total", "last frame");
+  run("full", trace, true);
+  run("changed", trace, false);
+  return 0;
+}
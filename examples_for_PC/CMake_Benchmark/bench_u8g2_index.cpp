@@ -0,0 +1,144 @@
+// U8g2font の Unicode グリフ探索と IndexedU8g2font の索引を比較する
+// 収録の CJK フォントと同じ構成 (16x16, 100文字ごとの lut ブロック, 6856文字) のフォントをその場で生成して使う
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+
+static uint32_t rand_state = 1;
+static uint32_t next_rand(void) { rand_state = rand_state * 1103515245u + 12345u; return rand_state >> 8; }
+
+struct bit_writer_t
+{
+  std::vector<uint8_t> bytes;
+  uint32_t pos = 0;
+  void put(uint32_t value, uint32_t bits)
+  {
+    for (uint32_t i = 0; i < bits; ++i, ++pos)
+    {
+      if ((pos & 7) == 0) { bytes.push_back(0); }
+      if ((value >> i) & 1) { bytes.back() |= 1 << (pos & 7); }
+    }
+  }
+};
+
+// 16x16 の乱数パターンを u8g2 の RLE 形式で符号化する (bits_per_0 = bits_per_1 = 4)
+static std::vector<uint8_t> make_glyph(void)
+{
+  bit_writer_t b;
+  b.put(16, 5); b.put(16, 5);            // width, height
+  b.put(0 + 4, 3); b.put(-2 + 16, 5);   // x, y
+  b.put(16 + 16, 5);                     // delta x
+  uint8_t px[256];
+  for (auto& p : px) { p = (next_rand() % 100) < 35; }
+  for (uint32_t i = 0; i < 256; )
+  {
+    uint32_t z = 0, o = 0;
+    while (i < 256 && !px[i] && z < 15) { ++z; ++i; }
+    while (i < 256 &&  px[i] && o < 15) { ++o; ++i; }
+    b.put(z, 4); b.put(o, 4); b.put(0, 1);
+  }
+  return b.bytes;
+}
+
+static std::vector<uint8_t> make_font(std::vector<uint16_t>& codes)
+{
+  for (uint16_t c = 0x3000; c < 0x3100; ++c) { codes.push_back(c); }
+  for (uint16_t c = 0x4E00; c < 0x4E00 + 6600; ++c) { codes.push_back(c); }
+
+  std::vector<uint8_t> low;
+  for (int c = 32; c < 127; ++c)
+  {
+    auto g = make_glyph();
+    low.push_back(c); low.push_back(g.size() + 2);
+    low.insert(low.end(), g.begin(), g.end());
+  }
+  low.push_back(0); low.push_back(0);
+
+  std::vector<std::vector<uint8_t>> blocks;
+  std::vector<uint16_t> block_last;
+  for (size_t i = 0; i < codes.size(); i += 100)
+  {
+    std::vector<uint8_t> d;
+    for (size_t j = i; j < i + 100 && j < codes.size(); ++j)
+    {
+      auto g = make_glyph();
+      d.push_back(codes[j] >> 8); d.push_back(codes[j]); d.push_back(g.size() + 3);
+      d.insert(d.end(), g.begin(), g.end());
+      block_last.resize(blocks.size() + 1, codes[j]);
+      block_last.back() = codes[j];
+    }
+    blocks.push_back(d);
+  }
+
+  std::vector<uint8_t> uni;
+  for (size_t i = 0; i < blocks.size(); ++i)
+  {
+    size_t offset = (i == 0) ? blocks.size() * 4 : blocks[i - 1].size();
+    uint16_t last = (i + 1 == blocks.size()) ? 0xFFFF : block_last[i];
+    uni.push_back(offset >> 8); uni.push_back(offset);
+    uni.push_back(last >> 8);   uni.push_back(last);
+  }
+  for (auto& d : blocks) { uni.insert(uni.end(), d.begin(), d.end()); }
+  uni.push_back(0); uni.push_back(0);
+
+  std::vector<uint8_t> font = { (uint8_t)codes.size(), 0, 4, 4, 5, 5, 3, 5, 5, 16, 16, 0, (uint8_t)-2, 12, (uint8_t)-2, 14, (uint8_t)-2
+                              , 0, 0, 0, 0, (uint8_t)(low.size() >> 8), (uint8_t)low.size() };
+  font.insert(font.end(), low.begin(), low.end());
+  font.insert(font.end(), uni.begin(), uni.end());
+  return font;
+}
+
+static void put_utf8(std::string& s, uint32_t c)
+{
+  s += (char)(0xE0 | (c >> 12));
+  s += (char)(0x80 | ((c >> 6) & 0x3F));
+  s += (char)(0x80 | (c & 0x3F));
+}
+
+static void run(const char* name, const lgfx::IFont* font, LGFX_Sprite& sprite, const std::string& text)
+{
+  sprite.setFont(font);
+  double print_us = bench_usec([&]{ sprite.setCursor(0, 0); sprite.print(text.c_str()); });
+  double width_us = bench_usec([&]{ sprite.textWidth(text.c_str()); });
+  printf("%-10s print %8.1f us  textWidth %8.1f us  hash %016llx\n"
+        , name, print_us, width_us
+        , (unsigned long long)bench_hash(sprite.getBuffer(), sprite.bufferLength()));
+}
+
+int main(void)
+{
+  std::vector<uint16_t> codes;
+  auto data = make_font(codes);
+  static const lgfx::U8g2font plain(data.data());
+
+  // ひらがなと漢字をまぜた600文字 (40文字ごとに改行)
+  std::string text;
+  for (int i = 0; i < 600; ++i)
+  {
+    put_utf8(text, (next_rand() % 3 == 0) ? 0x3041 + next_rand() % 83 : 0x4E00 + next_rand() % 6600);
+    if (i % 40 == 39) { text += '\n'; }
+  }
+
+  LGFX_Sprite sprite;
+  sprite.setColorDepth(16);
+  sprite.createSprite(800, 480);
+  sprite.setTextColor(TFT_WHITE, TFT_BLACK);
+
+  printf("%u glyphs, 600 chars per paragraph\n", (unsigned)codes.size());
+  run("walk", &plain, sprite, text);
+
+  for (uint8_t step : { 4, 8, 16, 32 })
+  {
+    lgfx::IndexedU8g2font indexed(plain, step);
+    double build_us = bench_usec([&]{ indexed.build(); }, 0.2);
+    char name[16];
+    snprintf(name, sizeof(name), "step %u", step);
+    printf("%-10s build %8.1f us  index %u bytes\n", name, build_us, (unsigned)indexed.getIndexSize());
+    run(name, &indexed, sprite, text);
+  }
+  return 0;
+}
@@ -0,0 +1,57 @@
+#include <stdio.h>
+
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+#include <lgfx/v1/panel/Panel_Headless.hpp>
+
+#define SCREEN_X 320
+#define SCREEN_Y 240
+#define FRAMES   300
+
+// 表示装置を使わず、メモリ上に描画して処理量と時間を計測する
+// 引数1 を指定すると、各フレームを QOI 画像として連結したファイルを出力する
+class LGFX : public lgfx::LGFX_Device
+{
+public:
+  lgfx::Panel_Headless _panel_instance;
+
+  LGFX(FILE* output)
+  {
+    auto cfg = _panel_instance.config();
+    cfg.panel_width  = SCREEN_X;
+    cfg.panel_height = SCREEN_Y;
+    _panel_instance.config(cfg);
+
+    auto detail = _panel_instance.config_detail();
+    detail.ring_frames = 2;
+    detail.output = output;
+    detail.output_format = lgfx::Panel_Headless::output_qoi;
+    _panel_instance.config_detail(detail);
+
+    setPanel(&_panel_instance);
+  }
+};
+
+int main(int argc, char** argv)
+{
+  FILE* output = (argc > 1) ? fopen(argv[1], "wb") : nullptr;
+  LGFX lcd(output);
+  lcd.init();
+
+  for (int i = 0; i < FRAMES; ++i)
+  {
+    lcd.fillScreen(TFT_BLACK);
+    lcd.fillCircle(i % SCREEN_X, SCREEN_Y / 2, 40, TFT_RED);
+    lcd.drawString("LovyanGFX", 10, 10, &fonts::Font4);
+    lcd.display();  // 1フレームの終了
+  }
+
+  auto& total = lcd._panel_instance.getTotalStats();
+  printf("frames %u  draw calls %u  pixels %llu\n"
+        , total.frames, total.draw_calls, (unsigned long long)total.pixels);
+  printf("draw %u us (%.1f us/frame)  output %u us\n"
+        , total.draw_usec, (float)total.draw_usec / total.frames, total.output_usec);
+
+  if (output) { fclose(output); }
+  return 0;
+}
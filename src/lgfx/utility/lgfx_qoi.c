@@ -242,33 +242,52 @@ void lgfx_qoi_destroy(qoi_t *qoi)
 // Qoi Encoder
 
 
+// output state of one encode, kept on the caller's stack so that encodes can run concurrently
+typedef struct
+{
+  uint8_t* buf;
+  size_t size;
+  uint32_t pos;
+  lfgx_qoi_writer_func write_bytes;
+  lgfx_qoi_writer_user_func write_user;
+  void* user;
+} qoi_enc_out_t;
+
+// used by lgfx_qoi_encoder_write_fb, which returns the whole buffer
 static uint8_t* writeBuffer;
 static size_t writeBufferSize;
-static uint32_t writeBufferPos;
-lfgx_qoi_writer_func bytes_writer;
 
 
-static int8_t enc_write_uint8( uint8_t v )
+static void enc_flush( qoi_enc_out_t *out, size_t len )
+{
+  // TODO: handle write errors
+  if( out->write_user ) out->write_user( out->user, out->buf, len );
+  else if( out->write_bytes ) out->write_bytes( out->buf, len );
+}
+
+
+static int8_t enc_write_uint8( qoi_enc_out_t *out, uint8_t v )
 {
-  writeBuffer[writeBufferPos++] = v;
-  if( writeBufferPos == writeBufferSize )  { // buffer full, write!
-    // TODO: handle write errors
-    if( bytes_writer ) bytes_writer( writeBuffer, writeBufferSize );
-    writeBufferPos = 0;
+  out->buf[out->pos++] = v;
+  if( out->pos == out->size )  { // buffer full, write!
+    enc_flush( out, out->size );
+    out->pos = 0;
   }
   return 1;
 }
 
 
-static int8_t enc_write_uint32( uint32_t v )
+static int8_t enc_write_uint32( qoi_enc_out_t *out, uint32_t v )
 {
-  enc_write_uint8( (uint8_t)(v >> 24) );
-  enc_write_uint8( (uint8_t)(v >> 16) );
-  enc_write_uint8( (uint8_t)(v >>  8) );
-  enc_write_uint8( (uint8_t)v );
+  enc_write_uint8( out, (uint8_t)(v >> 24) );
+  enc_write_uint8( out, (uint8_t)(v >> 16) );
+  enc_write_uint8( out, (uint8_t)(v >>  8) );
+  enc_write_uint8( out, (uint8_t)v );
   return 4;
 }
 
+static size_t qoi_encode_out(const void *lineBuffer, const qoi_desc_t *desc, int flip, lgfx_qoi_encoder_get_row_func get_row, qoi_enc_out_t *out, void *qoienc);
+
 uint32_t lgfx_qoi_get_width(qoi_t *qoi)
 {
   if (!qoi) return 0;
@@ -296,6 +315,19 @@ size_t lgfx_qoi_encoder_write_cb(const void *lineBuffer, uint32_t bufferLen, int
 }
 
 
+size_t lgfx_qoi_encoder_write_cb_user(const void *lineBuffer, uint32_t bufferLen, int w, int h, int num_chans, int flip, lgfx_qoi_encoder_get_row_func get_row, lgfx_qoi_writer_user_func write_bytes, void *user, void *qoienc)
+{
+  if (write_bytes == NULL) { debug_printf( "Bad writer"); return 0; }
+  qoi_desc_t desc;
+  desc.width      = w;
+  desc.height     = h;
+  desc.channels   = num_chans;
+  desc.colorspace = QOI_SRGB; // QOI_SRGB=0, QOI_LINEAR=1
+  qoi_enc_out_t out = { NULL, bufferLen, 0, NULL, write_bytes, user };
+  return qoi_encode_out(lineBuffer, &desc, flip, get_row, &out, qoienc);
+}
+
+
 void *lgfx_qoi_encoder_write_fb(const void *lineBuffer, int w, int h, int num_chans, size_t *out_len, int flip, lgfx_qoi_encoder_get_row_func get_row, void *qoienc)
 {
   qoi_desc_t desc;
@@ -311,6 +343,15 @@ void *lgfx_qoi_encoder_write_fb(const void *lineBuffer, int w, int h, int num_ch
 
 
 size_t lgfx_qoi_encode(const void *lineBuffer, const qoi_desc_t *desc, int flip, lgfx_qoi_encoder_get_row_func get_row, lfgx_qoi_writer_func write_bytes, void *qoienc)
+{
+  qoi_enc_out_t out = { NULL, writeBufferSize, 0, write_bytes, NULL, NULL };
+  size_t res = qoi_encode_out(lineBuffer, desc, flip, get_row, &out, qoienc);
+  writeBuffer = out.buf;
+  return res;
+}
+
+
+static size_t qoi_encode_out(const void *lineBuffer, const qoi_desc_t *desc, int flip, lgfx_qoi_encoder_get_row_func get_row, qoi_enc_out_t *out, void *qoienc)
 {
   int i, p, repeat;
   int px_len, px_end, px_pos, channels;
@@ -328,22 +369,20 @@ size_t lgfx_qoi_encode(const void *lineBuffer, const qoi_desc_t *desc, int flip,
   if (desc->height >= QOI_PIXELS_MAX / desc->width ) { debug_printf( "Too big");        return 0; }
 
   p = 0;
-  writeBufferPos = 0;
-  writeBuffer = (uint8_t*)malloc(writeBufferSize);
-  if (!writeBuffer)
+  out->pos = 0;
+  out->buf = (uint8_t*)malloc(out->size);
+  if (!out->buf)
   {
-    debug_printf( "Can't malloc %d bytes", (int)writeBufferSize);
+    debug_printf( "Can't malloc %d bytes", (int)out->size);
     return 0;
   }
 
-  bytes_writer = write_bytes;
-
-  p += enc_write_uint32( qoi_sig);
-  p += enc_write_uint32( desc->width);
-  p += enc_write_uint32( desc->height);
+  p += enc_write_uint32( out, qoi_sig);
+  p += enc_write_uint32( out, desc->width);
+  p += enc_write_uint32( out, desc->height);
 
-  p += enc_write_uint8( desc->channels );
-  p += enc_write_uint8( desc->colorspace );
+  p += enc_write_uint8( out, desc->channels );
+  p += enc_write_uint8( out, desc->colorspace );
 
   uint32_t lineBufferLen = desc->width * desc->channels;
 
@@ -380,7 +419,7 @@ size_t lgfx_qoi_encode(const void *lineBuffer, const qoi_desc_t *desc, int flip,
       repeat++;
       if (repeat == 62 || px_pos == px_end)
       {
-        p += enc_write_uint8( (uint8_t)(QOI_OP_RUN | (repeat - 1)) );
+        p += enc_write_uint8( out, (uint8_t)(QOI_OP_RUN | (repeat - 1)) );
         repeat = 0;
       }
     }
@@ -390,7 +429,7 @@ size_t lgfx_qoi_encode(const void *lineBuffer, const qoi_desc_t *desc, int flip,
 
       if (repeat > 0)
       {
-        p += enc_write_uint8( (uint8_t)(QOI_OP_RUN | (repeat - 1)));
+        p += enc_write_uint8( out, (uint8_t)(QOI_OP_RUN | (repeat - 1)));
         repeat = 0;
       }
 
@@ -398,7 +437,7 @@ size_t lgfx_qoi_encode(const void *lineBuffer, const qoi_desc_t *desc, int flip,
 
       if (qoi_index[index_pos].v == px.v)
       {
-        p += enc_write_uint8( (uint8_t)(QOI_OP_INDEX | index_pos) );
+        p += enc_write_uint8( out, (uint8_t)(QOI_OP_INDEX | index_pos) );
       }
       else
       {
@@ -415,28 +454,28 @@ size_t lgfx_qoi_encode(const void *lineBuffer, const qoi_desc_t *desc, int flip,
 
           if ( vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2 )
           {
-            p += enc_write_uint8( (uint8_t)(QOI_OP_DIFF + ((vr + 2) << 4) + ((vg + 2) << 2) + (vb + 2)) );
+            p += enc_write_uint8( out, (uint8_t)(QOI_OP_DIFF + ((vr + 2) << 4) + ((vg + 2) << 2) + (vb + 2)) );
           }
           else if ( vg_r >  -9 && vg_r <  8 && vg   > -33 && vg   < 32 && vg_b >  -9 && vg_b <  8 )
           {
-            p += enc_write_uint8( (uint8_t)(QOI_OP_LUMA     | (vg   + 32)) );
-            p += enc_write_uint8( (uint8_t)((vg_r + 8) << 4 | (vg_b +  8)) );
+            p += enc_write_uint8( out, (uint8_t)(QOI_OP_LUMA     | (vg   + 32)) );
+            p += enc_write_uint8( out, (uint8_t)((vg_r + 8) << 4 | (vg_b +  8)) );
           }
           else
           {
-            p += enc_write_uint8( QOI_OP_RGB );
-            p += enc_write_uint8( px.rgba.r  );
-            p += enc_write_uint8( px.rgba.g  );
-            p += enc_write_uint8( px.rgba.b  );
+            p += enc_write_uint8( out, QOI_OP_RGB );
+            p += enc_write_uint8( out, px.rgba.r  );
+            p += enc_write_uint8( out, px.rgba.g  );
+            p += enc_write_uint8( out, px.rgba.b  );
           }
         }
         else
         {
-          p += enc_write_uint8( QOI_OP_RGBA );
-          p += enc_write_uint8( px.rgba.r   );
-          p += enc_write_uint8( px.rgba.g   );
-          p += enc_write_uint8( px.rgba.b   );
-          p += enc_write_uint8( px.rgba.a   );
+          p += enc_write_uint8( out, QOI_OP_RGBA );
+          p += enc_write_uint8( out, px.rgba.r   );
+          p += enc_write_uint8( out, px.rgba.g   );
+          p += enc_write_uint8( out, px.rgba.b   );
+          p += enc_write_uint8( out, px.rgba.a   );
         }
       }
     }
@@ -445,13 +484,14 @@ size_t lgfx_qoi_encode(const void *lineBuffer, const qoi_desc_t *desc, int flip,
 
   for (i = 0; i < (int)sizeof(qoi_padding); i++)
   {
-    p += enc_write_uint8( qoi_padding[i] );
+    p += enc_write_uint8( out, qoi_padding[i] );
   }
 
-  if( write_bytes )
+  if( out->write_bytes || out->write_user )
   {
-    if( writeBufferPos>0 ) write_bytes( writeBuffer, writeBufferPos );
-    free( writeBuffer );
+    if( out->pos>0 ) enc_flush( out, out->pos );
+    free( out->buf );
+    out->buf = NULL;
   }
 
   free( qoi_index );
@@ -20,6 +20,8 @@ typedef void (*lgfx_qoi_draw_callback_t)(void *user_data, uint32_t x, uint32_t y
 typedef uint8_t *(*lgfx_qoi_encoder_get_row_func)(uint8_t *lineBuffer, int flip, int w, int h, int y, void *qoienc);
 // basic buffer/stream writer signature
 typedef int (*lfgx_qoi_writer_func)(uint8_t* buf, size_t buf_len);
+// stream writer with a user pointer
+typedef int (*lgfx_qoi_writer_user_func)(void* user, uint8_t* buf, size_t buf_len);
 
 // ---------------------
 // Basic read interfaces
@@ -45,6 +47,8 @@ qoi_desc_t *lgfx_qoi_get_desc(qoi_t *qoi);
 void  *lgfx_qoi_encoder_write_fb(const void *lineBuffer, int w, int h, int num_chans, size_t *out_len, int flip, lgfx_qoi_encoder_get_row_func cb, void *qoienc);
 // write to callback (falls back to malloc if none provided)
 size_t lgfx_qoi_encoder_write_cb(const void *lineBuffer, uint32_t buflen, int w, int h, int num_chans, int flip, lgfx_qoi_encoder_get_row_func get_row, lfgx_qoi_writer_func write_bytes, void *qoienc);
+// write to callback with a user pointer (keeps no state in globals, so it can run on several threads at once)
+size_t lgfx_qoi_encoder_write_cb_user(const void *lineBuffer, uint32_t buflen, int w, int h, int num_chans, int flip, lgfx_qoi_encoder_get_row_func get_row, lgfx_qoi_writer_user_func write_bytes, void *user, void *qoienc);
 // encode
 size_t lgfx_qoi_encode(const void *lineBuffer, const qoi_desc_t *desc, int flip, lgfx_qoi_encoder_get_row_func get_row, lfgx_qoi_writer_func write_bytes, void *qoienc);
 
@@ -72,7 +72,7 @@ static const uint16_t Ipsf[64] = {	/* See also aa_idct.png */
 
 #if JD_TBLCLIP
 
-//#define BYTECLIP(v) Clip8[(uint16_t)(v) & 0x3FF]
+#define BYTECLIP(v) Clip8[(uint16_t)(v) & 0x3FF]
 
 static const uint8_t Clip8[1024] = {
 	/* 0..255 */
@@ -260,7 +260,7 @@ static int32_t bitext (	/* >=0: extracted data, <0: error code */
 			uint8_t *dpend = jd->dpend;
 			if (++dp == dpend) {	/* No input data is available, re-fill input buffer */
 				dp = jd->inbuf;	/* Top of input buffer */
-				dpend = dp + jd->infunc(jd->device, dp, JD_SZBUF);
+				dpend = dp + jd->infunc(jd->device, dp, jd->sz_buf);
 				if (dp == dpend) return 0 - (int32_t)JDR_INP;	/* Err: read error or wrong stream termination */
 				jd->dpend = dpend;
 			}
@@ -269,7 +269,7 @@ static int32_t bitext (	/* >=0: extracted data, <0: error code */
 			if (s == 0xff) {		/* Is start of flag sequence? */
 				if (++dp == dpend) {	/* No input data is available, re-fill input buffer */
 					dp = jd->inbuf;	/* Top of input buffer */
-					dpend = dp + jd->infunc(jd->device, dp, JD_SZBUF);
+					dpend = dp + jd->infunc(jd->device, dp, jd->sz_buf);
 					if (dp == dpend) return 0 - (int32_t)JDR_INP;	/* Err: read error or wrong stream termination */
 					jd->dpend = dpend;
 				}
@@ -307,7 +307,7 @@ static int32_t huffext (	/* >=0: decoded data, <0: error code */
 			msk = 8;
 			if (++dp == dpend) {	/* No input data is available, re-fill input buffer */
 				dp = jd->inbuf;	/* Top of input buffer */
-				jd->dpend = dpend = dp + jd->infunc(jd->device, dp, JD_SZBUF);
+				jd->dpend = dpend = dp + jd->infunc(jd->device, dp, jd->sz_buf);
 				if (dp == dpend) return 0 - (int32_t)JDR_INP;	/* Err: read error or wrong stream termination */
 			}
 			uint_fast8_t s = *dp;
@@ -315,7 +315,7 @@ static int32_t huffext (	/* >=0: decoded data, <0: error code */
 			if (*dp == 0xff) {		/* Is start of flag sequence? */
 				if (++dp == dpend) {	/* No input data is available, re-fill input buffer */
 					dp = jd->inbuf;	/* Top of input buffer */
-					jd->dpend = dpend = dp + jd->infunc(jd->device, dp, JD_SZBUF);
+					jd->dpend = dpend = dp + jd->infunc(jd->device, dp, jd->sz_buf);
 					if (dp == dpend) return 0 - (int32_t)JDR_INP;	/* Err: read error or wrong stream termination */
 				}
 				if (*dp != 0) return 0 - (int32_t)JDR_FMT1;	/* Err: unexpected flag is detected (may be collapted data) */
@@ -727,7 +727,7 @@ static JRESULT restart (
 	for (int i = 0; i < 2; ++i) {
 		if (++dp == dpend) {	/* No input data is available, re-fill input buffer */
 			dp = jd->inbuf;
-			jd->dpend = dpend = dp + jd->infunc(jd->device, dp, JD_SZBUF);
+			jd->dpend = dpend = dp + jd->infunc(jd->device, dp, jd->sz_buf);
 			if (dp == dpend) return JDR_INP;
 		}
 		d = (d << 8) | *dp;	/* Get a byte */
@@ -759,6 +759,51 @@ static inline uint16_t LDB_WORD(uint8_t* ptr) {
 }
 
 
+/*-----------------------------------------------------------------------*/
+/* Tables kept across frames                                             */
+/*-----------------------------------------------------------------------*/
+
+static uint32_t tbl_seg_hash (	/* FNV-1a hash of a DHT/DQT segment */
+	uint_fast8_t marker,
+	const uint8_t* data,
+	uint_fast16_t len
+)
+{
+	uint32_t h = (2166136261u ^ marker) * 16777619u;
+	h = (h ^ len) * 16777619u;
+	for (uint_fast16_t i = 0; i < len; ++i) {
+		h = (h ^ data[i]) * 16777619u;
+	}
+	return h;
+}
+
+static void set_pool_pos (	/* Move the allocation point of the memory pool */
+	lgfxJdec* jd,
+	uint8_t* pos
+)
+{
+	jd->sz_pool = jd->pool_end - pos;
+	jd->pool = pos;
+}
+
+static void discard_tables (	/* Forget the tables placed at or after pos */
+	lgfxJdec* jd,
+	uint8_t* pos
+)
+{
+	for (size_t i = 0; i < 4; ++i) {
+		if (jd->qttbl[i] && (uint8_t*)jd->qttbl[i] >= pos) jd->qttbl[i] = 0;
+		size_t id = i >> 1, cls = i & 1;
+		if (jd->huffbits[id][cls] && jd->huffbits[id][cls] + 1 >= pos) {
+			jd->huffbits[id][cls] = 0;
+			jd->huffcode[id][cls] = 0;
+			jd->huffdata[id][cls] = 0;
+		}
+	}
+	set_pool_pos(jd, pos);
+}
+
+
 JRESULT lgfx_jd_prepare (
 	lgfxJdec* jd,			/* Blank decompressor object */
 	uint32_t (*infunc)(void*, uint8_t*, uint32_t),	/* JPEG strem input function */
@@ -766,28 +811,51 @@ JRESULT lgfx_jd_prepare (
 	uint_fast16_t sz_pool,	/* Size of working buffer */
 	void* dev			/* I/O device identifier for the session */
 )
+{
+	return lgfx_jd_prepare_ex(jd, infunc, pool, sz_pool, JD_SZBUF, dev, 0);
+}
+
+
+static JRESULT prepare_frame (
+	lgfxJdec* jd,
+	uint32_t (*infunc)(void*, uint8_t*, uint32_t),
+	void* pool,
+	uint32_t sz_pool,
+	uint_fast16_t sz_buf,
+	void* dev,
+	uint_fast8_t reuse
+)
 {
 	uint8_t *seg;
 	uint32_t ofs;
 	size_t n;
 	int32_t rc;
+	uint_fast8_t seg_idx = 0;
+	uint_fast8_t seg_over = 0;	/* A DHT/DQT segment did not fit in tbl_seg_hash */
 
 
-	if (!pool) return JDR_PAR;
+	if (!pool || sz_buf < 64) return JDR_PAR;
 
+	if (reuse != JD_REUSE_TAKE || jd->pool_base != (uint8_t*)pool || jd->pool_end != (uint8_t*)pool + sz_pool || jd->sz_buf != sz_buf) {
+		memset(jd->huffbits, 0, sizeof(uint8_t*) * 4);	/* Nulls pointers */
+		memset(jd->huffcode, 0, sizeof(uint16_t*) * 4);
+		memset(jd->huffdata, 0, sizeof(uint8_t*) * 4);
+		memset(jd->qttbl, 0, sizeof(uint32_t*) * 4);
+		jd->tbl_seg_num = 0;
+	}
+	jd->pool_base = (uint8_t*)pool;
+	jd->pool_end = (uint8_t*)pool + sz_pool;
 	jd->pool = (uint8_t*)pool;		/* Work memroy */
 	jd->sz_pool = sz_pool;	/* Size of given work memory */
+	jd->sz_buf = sz_buf;	/* Size of stream input buffer */
 	jd->infunc = infunc;	/* Stream input function */
 	jd->device = dev;		/* I/O device identifier */
 	jd->nrst = 0;			/* No restart interval (default) */
+	jd->width = jd->height = 0;
 
-//	memset(jd->huffbits, 0, sizeof(uint8_t*) * 4);	/* Nulls pointers */
-//	memset(jd->huffcode, 0, sizeof(uint16_t*) * 4);
-//	memset(jd->huffdata, 0, sizeof(uint8_t*) * 4);
-//	memset(jd->qttbl, 0, sizeof(uint32_t*) * 4);
-
-	jd->inbuf = seg = alloc_pool(jd, JD_SZBUF);		/* Allocate stream input buffer */
+	jd->inbuf = seg = alloc_pool(jd, sz_buf);		/* Allocate stream input buffer */
 	if (!seg) return JDR_MEM1;
+	uint8_t* tbl_top = jd->pool;	/* Tables are placed from here */
 
 	if (infunc(dev, seg, 2) != 2) return JDR_INP;/* Check SOI marker */
 	if (LDB_WORD(seg) != 0xFFD8) return JDR_FMT1;	/* Err: SOI is not detected */
@@ -807,7 +875,7 @@ JRESULT lgfx_jd_prepare (
 		switch (seg[1]) {	/* Marker */
 		case 0xC0:	/* SOF0 (baseline JPEG) */
 			{/* Load segment data */
-			if (len > JD_SZBUF) return JDR_MEM2;
+			if (len > sz_buf) return JDR_MEM2;
 			if (infunc(dev, seg, len) != len) return JDR_INP;
 
 			jd->width = LDB_WORD(seg+3);		/* Image width in unit of pixel */
@@ -836,7 +904,7 @@ JRESULT lgfx_jd_prepare (
 
 		case 0xDD:	/* DRI */
 			{/* Load segment data */
-			if (len > JD_SZBUF) return JDR_MEM2;
+			if (len > sz_buf) return JDR_MEM2;
 			if (infunc(dev, seg, len) != len) return JDR_INP;
 
 			/* Get restart interval (MCUs) */
@@ -846,33 +914,76 @@ JRESULT lgfx_jd_prepare (
 
 		case 0xC4:	/* DHT */
 			{/* Load segment data */
-			if (len > JD_SZBUF) return JDR_MEM2;
+			if (len > sz_buf) return JDR_MEM2;
 			if (infunc(dev, seg, len) != len) return JDR_INP;
 
-			/* Create huffman tables */
+			/* Create huffman tables (or keep them when the same segment was loaded by the previous frame) */
+			uint32_t h = reuse ? tbl_seg_hash(0xC4, seg, len) : 0;
+			if (seg_idx < jd->tbl_seg_num) {
+				if (jd->tbl_seg_hash[seg_idx] == h) {
+					set_pool_pos(jd, jd->tbl_seg_end[seg_idx++]);
+					break;
+				}
+				discard_tables(jd, seg_idx ? jd->tbl_seg_end[seg_idx - 1] : tbl_top);
+				jd->tbl_seg_num = seg_idx;
+			} else {
+				discard_tables(jd, jd->pool);
+			}
 			rc = create_huffman_tbl(jd, seg, len);
 			if (rc) return (JRESULT)rc;
+			if (reuse) {
+				if (seg_idx < JD_TBLSEG_MAX) {
+					jd->tbl_seg_hash[seg_idx] = h;
+					jd->tbl_seg_end[seg_idx] = jd->pool;
+					jd->tbl_seg_num = ++seg_idx;
+				} else {
+					seg_over = 1;
+				}
+			}
 			}
 			break;
 
 		case 0xDB:	/* DQT */
 			{/* Load segment data */
-			if (len > JD_SZBUF) return JDR_MEM2;
+			if (len > sz_buf) return JDR_MEM2;
 			if (infunc(dev, seg, len) != len) return JDR_INP;
 
-			/* Create de-quantizer tables */
+			/* Create de-quantizer tables (or keep them when the same segment was loaded by the previous frame) */
+			uint32_t h = reuse ? tbl_seg_hash(0xDB, seg, len) : 0;
+			if (seg_idx < jd->tbl_seg_num) {
+				if (jd->tbl_seg_hash[seg_idx] == h) {
+					set_pool_pos(jd, jd->tbl_seg_end[seg_idx++]);
+					break;
+				}
+				discard_tables(jd, seg_idx ? jd->tbl_seg_end[seg_idx - 1] : tbl_top);
+				jd->tbl_seg_num = seg_idx;
+			} else {
+				discard_tables(jd, jd->pool);
+			}
 			rc = create_qt_tbl(jd, seg, len);
 			if (rc) return (JRESULT)rc;
+			if (reuse) {
+				if (seg_idx < JD_TBLSEG_MAX) {
+					jd->tbl_seg_hash[seg_idx] = h;
+					jd->tbl_seg_end[seg_idx] = jd->pool;
+					jd->tbl_seg_num = ++seg_idx;
+				} else {
+					seg_over = 1;
+				}
+			}
 			}
 			break;
 
 		case 0xDA:	/* SOS */
 			{/* Load segment data */
-			if (len > JD_SZBUF) return JDR_MEM2;
+			if (len > sz_buf) return JDR_MEM2;
 			if (infunc(dev, seg, len) != len) return JDR_INP;
 
 			if (!jd->width || !jd->height) return JDR_FMT1;	/* Err: Invalid image size */
 
+			/* Tables which were not redefined by this frame are taken over from the previous frame */
+			if (seg_idx < jd->tbl_seg_num) set_pool_pos(jd, jd->tbl_seg_end[jd->tbl_seg_num - 1]);
+
 			if (seg[0] != jd->comps_in_frame) return JDR_FMT3;	/* Err: Supports only three color or grayscale components format */
 
 			/* Check if all tables corresponding to each components have been loaded */
@@ -905,12 +1016,14 @@ JRESULT lgfx_jd_prepare (
 			}
 
 			/* Pre-load the JPEG data to extract it from the bit stream */
-			ofs %= JD_SZBUF;						/* Align read offset to JD_SZBUF */
-			int32_t dc = infunc(dev, seg + ofs, JD_SZBUF - ofs);
+			ofs %= sz_buf;						/* Align read offset to sz_buf */
+			int32_t dc = infunc(dev, seg + ofs, sz_buf - ofs);
 			jd->dptr = seg + ofs - 1;
 			jd->dpend = seg + ofs + dc;
 			jd->dbit = 0;	/* Prepare to read bit stream */
 
+			/* Tables of this frame are not all remembered, so the next frame must not take them over */
+			if (seg_over) jd->pool_base = 0;
 			}
 			return JDR_OK;		/* Initialization succeeded. Ready to decompress the JPEG image. */
 
@@ -939,6 +1052,25 @@ JRESULT lgfx_jd_prepare (
 }
 
 
+JRESULT lgfx_jd_prepare_ex (
+	lgfxJdec* jd,			/* Decompressor object (blank, or used by the previous frame when JD_REUSE_TAKE) */
+	uint32_t (*infunc)(void*, uint8_t*, uint32_t),	/* JPEG strem input function */
+	void* pool,			/* Working buffer for the decompression session */
+	uint32_t sz_pool,	/* Size of working buffer */
+	uint_fast16_t sz_buf,	/* Size of stream input buffer taken from the working buffer */
+	void* dev,			/* I/O device identifier for the session */
+	uint_fast8_t reuse	/* JD_REUSE_NONE, JD_REUSE_KEEP or JD_REUSE_TAKE (see lgfx_tjpgd.h) */
+)
+{
+	JRESULT rc = prepare_frame(jd, infunc, pool, sz_pool, sz_buf, dev, reuse);
+	if (rc != JDR_OK || reuse == JD_REUSE_NONE) {	/* Tables not built for reuse, or half rebuilt on error: the next prepare starts from scratch */
+		jd->pool_base = 0;
+		jd->tbl_seg_num = 0;
+	}
+	return rc;
+}
+
+
 
 
 /*-----------------------------------------------------------------------*/
@@ -13,11 +13,22 @@
 /*---------------------------------------------------------------------------*/
 /* System Configurations */
 
-#define	JD_SZBUF		512	/* Size of stream input buffer */
+#ifndef JD_SZBUF
+#define	JD_SZBUF		512	/* Default size of stream input buffer (lgfx_jd_prepare_ex can change it at run time) */
+#endif
 #define JD_FORMAT		0	/* Output pixel format 0:RGB888 (3 BYTE/pix), 1:RGB565 (1 WORD/pix) */
 #define	JD_USE_SCALE	1	/* Use descaling feature for output */
+#ifndef JD_TBLCLIP
 #define JD_TBLCLIP		0	/* Use table for saturation (might be a bit faster but increases 1K bytes of code size) */
+#endif
 #define JD_BAYER		1	/* Use bayer pattern table */
+#define JD_TBLSEG_MAX	8	/* Number of DHT/DQT segments remembered for reusing tables */
+
+/* Table reuse modes of lgfx_jd_prepare_ex */
+#define JD_REUSE_NONE	0	/* Build the tables of this frame only */
+#define JD_REUSE_KEEP	1	/* Build the tables and keep them for the next frame */
+#define JD_REUSE_TAKE	2	/* Take over the kept tables whose DHT/DQT segments are the same or omitted.
+							   Only for the following frames of the same stream. */
 
 /*---------------------------------------------------------------------------*/
 
@@ -77,16 +88,23 @@ struct lgfxJdec {
 	void* workbuf;				/* Working buffer for IDCT and RGB output */
 	int16_t* mcubuf;			/* Working buffer for the MCU */
 	uint8_t* pool;				/* Pointer to available memory pool */
-	uint16_t sz_pool;			/* Size of momory pool (bytes available) */
+	uint32_t sz_pool;			/* Size of momory pool (bytes available) */
 	uint32_t (*infunc)(void*, uint8_t*, uint32_t);/* Pointer to jpeg stream input function */
 	void* device;				/* Pointer to I/O device identifiler for the session */
 	uint8_t comps_in_frame;		/* 1=Y(grayscale)  3=YCrCb */
+	uint16_t sz_buf;			/* Size of stream input buffer */
+	uint8_t* pool_base;			/* Top of the memory pool given by the last prepare */
+	uint8_t* pool_end;			/* End of the memory pool given by the last prepare */
+	uint8_t tbl_seg_num;		/* Number of DHT/DQT segments whose tables are kept in the pool */
+	uint32_t tbl_seg_hash[JD_TBLSEG_MAX];	/* Hash of each kept DHT/DQT segment */
+	uint8_t* tbl_seg_end[JD_TBLSEG_MAX];	/* Pool position just after the tables of each kept segment */
 };
 
 
 
 /* TJpgDec API functions */
 JRESULT lgfx_jd_prepare (lgfxJdec*, uint32_t(*)(void*,uint8_t*,uint32_t), void*, uint_fast16_t, void*);
+JRESULT lgfx_jd_prepare_ex (lgfxJdec*, uint32_t(*)(void*,uint8_t*,uint32_t), void*, uint32_t, uint_fast16_t, void*, uint_fast8_t);
 JRESULT lgfx_jd_decomp (lgfxJdec*, uint32_t(*)(void*,void*,JRECT*), uint_fast8_t);
 
 
@@ -17,6 +17,7 @@ Contributors:
 /----------------------------------------------------------------------------*/
 
 #include "LGFXBase.hpp"
+#include "LGFX_Sprite.hpp"
 
 #include "../internal/limits.h"
 #include "../utility/lgfx_miniz.h"
@@ -31,7 +32,6 @@ Contributors:
 #include <stdarg.h>
 #include <stdint.h>
 #include <math.h>
-#include <list>
 
 #ifdef min
 #undef min
@@ -982,6 +982,72 @@ namespace lgfx
     endWrite();
   }
 
+  void LGFXBase::push_alpha_span(int32_t x, int32_t y, int32_t w, const argb8888_t* span)
+  {
+    if (y < _clip_t || y > _clip_b) return;
+    if (x < _clip_l) { span += _clip_l - x; w -= _clip_l - x; x = _clip_l; }
+    if (w > _clip_r + 1 - x) { w = _clip_r + 1 - x; }
+    if (w <= 0) return;
+
+    auto depth = _write_conv.depth;
+    auto fp_copy = (depth == rgb565_2Byte     ) ? pixelcopy_t::blend_rgb_fast<swap565_t  , argb8888_t>
+                 : (depth == rgb888_3Byte     ) ? pixelcopy_t::blend_rgb_fast<bgr888_t   , argb8888_t>
+                 : (depth == rgb666_3Byte     ) ? pixelcopy_t::blend_rgb_fast<bgr666_t   , argb8888_t>
+                 : (depth == rgb332_1Byte     ) ? pixelcopy_t::blend_rgb_fast<rgb332_t   , argb8888_t>
+                 : (depth == grayscale_8bit   ) ? pixelcopy_t::blend_rgb_fast<grayscale_t, argb8888_t>
+                 : (depth == rgb565_nonswapped) ? pixelcopy_t::blend_rgb_fast<rgb565_t   , argb8888_t>
+                 : (depth == argb8888_4Byte   ) ? pixelcopy_t::blend_rgb_fast<bgra8888_t , argb8888_t>
+                                                : nullptr;
+    if (fp_copy == nullptr || hasPalette())
+    { // blend_rgb_fast has no destination type for 1, 2, 4bit, palette and the other depths.
+      do
+      {
+        if (span->a) { _panel->writeFillRectAlphaPreclipped(x, y, 1, 1, span->raw); }
+        ++span;
+        ++x;
+      } while (--w);
+      return;
+    }
+
+    pixelcopy_t pc(span, depth, argb8888_t::depth, false);
+    pc.fp_copy = fp_copy;
+    pc.src_bitwidth = w;
+    pc.src_width = w;
+    pc.src_height = 1;
+    _panel->writeImageARGB(x, y, w, 1, &pc);
+  }
+
+  void LGFXBase::push_coverage_span(int32_t x, int32_t y, int32_t w, const argb8888_t* span)
+  {
+    int32_t i0 = 0;
+    while (i0 < w && span[i0].a != 255) { ++i0; }
+    int32_t i1 = i0;
+    while (i1 < w && span[i1].a == 255) { ++i1; }
+    if (i0) { push_alpha_span(x, y, i0, span); }
+    if (i0 != i1)
+    { // the covered middle does not need to be read.
+      int32_t i = i0;
+      while (++i < i1 && span[i].raw == span[i0].raw);
+      auto fp_copy = pixelcopy_t::get_fp_copy_rgb_affine<argb8888_t>(_write_conv.depth);
+      if (i == i1)
+      {
+        setColor(color888(span[i0].r, span[i0].g, span[i0].b));
+        writeFastHLine(x + i0, y, i1 - i0);
+      }
+      else if (fp_copy == nullptr || hasPalette())
+      {
+        push_alpha_span(x + i0, y, i1 - i0, &span[i0]);
+      }
+      else
+      {
+        pixelcopy_t pc(&span[i0], _write_conv.depth, argb8888_t::depth, false);
+        pc.fp_copy = fp_copy;
+        pushImage(x + i0, y, i1 - i0, 1, &pc);
+      }
+    }
+    if (i1 != w) { push_alpha_span(x + i1, y, w - i1, &span[i1]); }
+  }
+
   void LGFXBase::draw_gradient_wedgeline(float ax, float ay, float bx, float by, float ar, float br, const colors_t gradient )
   {
     const bool is_circle = (ax==bx && ay==by /*&& ar==br*/ );
@@ -1002,7 +1068,11 @@ namespace lgfx
 
     constexpr float PixelAlphaGain = 255.0f;
 
-    setClipRect( x0, y0, x1, y1 );
+    // Each scanline is collected into a run of coverage pixels and written at once,
+    // instead of a read-modify-write of every edge pixel.
+    // The clip rect of the caller is used as is.
+    auto span = (argb8888_t*)alloca((x1 - x0 + 1) * sizeof(argb8888_t));
+
     startWrite();
 
     // Establish x start and y start
@@ -1017,9 +1087,10 @@ namespace lgfx
     float xpax, ypay, bax = bx - ax, bay = by - ay;
 
     int32_t xs = x0; // Set x start to left side of box
-    // 1st pass: Scan bounding box from ys down, calculate pixel intensity from distance to line
-    for (int32_t yp = ys; yp <= y1; yp++) {
+    auto scanline = [&](int32_t yp)
+    {
       bool endX = false; // Flag to skip pixels
+      int32_t len = 0;
       ypay = yp - ay;
       for (int32_t xp = xs; xp <= x1; xp++) {
         if (endX) if (alpha <= LoAlphaTheshold) break;  // Skip right side
@@ -1030,40 +1101,20 @@ namespace lgfx
         if( gradient.count>1 ) fg_color = map_gradient( pixelDistance(ax, ay, xp, yp), 0.0f, linedist, gradient );
         // Track edge to minimise calculations
         if (!endX) { endX = true; xs = xp; }
-        if (alpha > HiAlphaTheshold) {
-          setColor(color888(fg_color.r, fg_color.g, fg_color.b));
-          drawPixel(xp, yp);
-          continue;
-        }
-        fillRectAlpha(xp, yp, 1, 1, (uint8_t)(alpha * PixelAlphaGain), fg_color);
+        uint8_t a = (alpha > HiAlphaTheshold) ? 255 : (uint8_t)(alpha * PixelAlphaGain);
+        span[len++] = argb8888_t(a, fg_color.r, fg_color.g, fg_color.b);
       }
-    }
+      if (len) { push_coverage_span(xs, yp, len, span); }
+    };
+
+    // 1st pass: Scan bounding box from ys down, calculate pixel intensity from distance to line
+    for (int32_t yp = ys; yp <= y1; yp++) { scanline(yp); }
 
     xs = x0; // Reset x start to left side of box
     // 2nd pass: Scan bounding box from ys-1 up, calculate pixel intensity from distance to line
-    for (int32_t yp = ys-1; yp >= y0; yp--) {
-      bool endX = false; // Flag to skip pixels
-      ypay = yp - ay;
-      for (int32_t xp = xs; xp <= x1; xp++) {
-        if (endX) if (alpha <= LoAlphaTheshold) break;  // Skip right side of drawn line
-        xpax = xp - ax;
-        alpha = ar - wedgeLineDistance(xpax, ypay, bax, bay, rdt);
-        if (alpha <= LoAlphaTheshold ) continue;
-        // handle gradient
-        if( gradient.count>1 ) fg_color = map_gradient( pixelDistance(ax, ay, xp, yp), 0.0f, linedist, gradient );
-        // Track line boundary
-        if (!endX) { endX = true; xs = xp; }
-        if (alpha > HiAlphaTheshold) {
-          setColor(color888(fg_color.r, fg_color.g, fg_color.b));
-          drawPixel(xp, yp);
-          continue;
-        }
-        fillRectAlpha(xp, yp, 1, 1, (uint8_t)(alpha * PixelAlphaGain), fg_color);
-      }
-    }
+    for (int32_t yp = ys-1; yp >= y0; yp--) { scanline(yp); }
 
     endWrite();
-    clearClipRect();
   }
 
   void LGFXBase::draw_wedgeline(float ax, float ay, float bx, float by, float ar, float br, const uint32_t fg_color)
@@ -1073,6 +1124,89 @@ namespace lgfx
     draw_gradient_wedgeline(ax, ay, bx, by, ar, br, gradient ); // dispatch
   }
 
+  struct LGFXBase::gradient_band_t
+  {
+    LGFXBase* gfx;
+    IPanel* panel;
+    color_conv_t* conv;
+    pixelcopy_t pc;           // rgb888_t scanline to the panel
+    const colors_t* gradient;
+    const rgb888_t* scanline; // linear : memoized colors
+    bool vertical;
+    int32_t x, y;             // clipped area
+    int32_t w, h;
+    int32_t dx, dy;           // offset of the clipped area in the gradient
+    int32_t gw;               // width of the gradient
+    float fmidx, fmidy, vratio, hratio, hyp0;
+  };
+
+  void LGFXBase::fill_rect_radial_gradient_band(void* arg, int32_t y, int32_t h)
+  {
+    auto b = (gradient_band_t*)arg;
+    int32_t w = b->gw;
+    auto scanline = (rgb888_t*)alloca(w * sizeof(rgb888_t));
+    h += y;
+    do
+    {
+      int _y = y - b->y + b->dy;
+      // only half of the scan line needs to be calculated, the other half is mirrored
+      for( int _x=0;_x<=w/2;_x++ ) {
+        auto distance       = pixelDistance( b->fmidx, b->fmidy, _x*b->vratio, _y*b->hratio );
+        scanline[_x]        = b->gfx->map_gradient( distance, 0, b->hyp0, *b->gradient );
+        scanline[(w-1)-_x]  = scanline[_x];
+      }
+      // writeImageは回転に合わせてpixelcopyを書き換えるため、行ごとに複製する;
+      pixelcopy_t pc = b->pc;
+      pc.src_data = scanline;
+      pc.src_x32 = pc.src_x32_add * b->dx;
+      b->panel->writeImage(b->x, y, b->w, 1, &pc, true);
+    } while (++y != h);
+  }
+
+  void LGFXBase::fill_rect_linear_gradient_band(void* arg, int32_t y, int32_t h)
+  {
+    auto b = (gradient_band_t*)arg;
+    h += y;
+    do
+    {
+      if (b->vertical)
+      { // 垂直方向のグラデーションは行ごとに単色で塗る;
+        auto c = b->scanline[y - b->y + b->dy];
+        b->panel->writeFillRectPreclipped(b->x, y, b->w, 1, b->conv->convert(color888(c.r, c.g, c.b)));
+      }
+      else
+      {
+        pixelcopy_t pc = b->pc;
+        pc.src_x32 = pc.src_x32_add * b->dx;
+        b->panel->writeImage(b->x, y, b->w, 1, &pc, true);
+      }
+    } while (++y != h);
+  }
+
+  bool LGFXBase::clip_gradient_band(int32_t x, int32_t y, uint32_t w, uint32_t h, gradient_band_t* band)
+  {
+    int32_t dx = 0, dw = w;
+    if (0 < _clip_l - x) { dx = _clip_l - x; dw -= dx; x = _clip_l; }
+    if (_adjust_width(x, dx, dw, _clip_l, _clip_r - _clip_l + 1)) return false;
+    int32_t dy = 0, dh = h;
+    if (0 < _clip_t - y) { dy = _clip_t - y; dh -= dy; y = _clip_t; }
+    if (_adjust_width(y, dy, dh, _clip_t, _clip_b - _clip_t + 1)) return false;
+
+    band->gfx = this;
+    band->panel = _panel;
+    band->conv = &_write_conv;
+    band->pc = create_pc((const rgb888_t*)nullptr);
+    band->pc.src_bitwidth = w;
+    band->x = x;
+    band->y = y;
+    band->w = dw;
+    band->h = dh;
+    band->dx = dx;
+    band->dy = dy;
+    band->gw = w;
+    return true;
+  }
+
   void LGFXBase::fill_rect_radial_gradient(int32_t x, int32_t y, uint32_t w, uint32_t h, const colors_t gradient)
   {
       if( w<=1 || h<=1 || !gradient.colors || gradient.count==0 ) return;
@@ -1081,26 +1215,23 @@ namespace lgfx
         fillRect(x, y, w, h);
         return;
       }
+      gradient_band_t band;
+      if (!clip_gradient_band(x, y, w, h, &band)) return;
+
       float major_side = std::max(w,h);
       float midx   = (w-1)/2.0f;
       float midy   = (h-1)/2.0f;
-      float vratio = h/major_side;
-      float hratio = w/major_side;
-      float fmidx  = midx*vratio;
-      float fmidy  = midy*hratio;
-      float hyp0   = pixelDistance( midx, midy, 0, 0 );
-
-      auto scanline = (rgb888_t*)alloca(w * sizeof(rgb888_t));
+      band.vratio  = h/major_side;
+      band.hratio  = w/major_side;
+      band.fmidx   = midx*band.vratio;
+      band.fmidy   = midy*band.hratio;
+      band.hyp0    = pixelDistance( midx, midy, 0, 0 );
+      band.gradient = &gradient;
 
       startWrite();
-      for( int _y=0;_y<(int)h;_y++ ) {
-        // only half of the scan line needs to be calculated, the other half is mirrored
-        for( int _x=0;_x<=(int)w/2;_x++ ) {
-          auto distance       = pixelDistance( fmidx, fmidy, _x*vratio, _y*hratio );
-          scanline[_x]        = map_gradient( distance, 0, hyp0, gradient );
-          scanline[(w-1)-_x]  = scanline[_x];
-        }
-        pushImage( x, _y+y, w, 1, scanline );
+      if (!_panel->writeBands(band.x, band.y, band.w, band.h, fill_rect_radial_gradient_band, &band))
+      {
+        fill_rect_radial_gradient_band(&band, band.y, band.h);
       }
       endWrite();
   }
@@ -1121,16 +1252,22 @@ namespace lgfx
     for(int i=0;i<(int)gradient_len;i++) { // memoize one gradient scanline
       scanline[i] = map_gradient( i, 0, gradient_len, gradient );
     }
-    startWrite();
-    for( int ys=0;ys<(int)h;ys++ ) {
-      if( is_vertical ) { // scanline is used as an colors index
-        setColor(color888(scanline[ys].r, scanline[ys].g, scanline[ys].b));
-        drawFastHLine( x, y+ys, w );
-      } else { // scanline is used as a line buffer
-        pushImage( x, y+ys, w, 1, scanline );
+    gradient_band_t band;
+    if (clip_gradient_band(x, y, w, h, &band)) {
+      band.scanline = scanline;
+      band.vertical = is_vertical;
+      band.pc.src_data = scanline;
+
+      startWrite();
+      if (!_panel->writeBands(band.x, band.y, band.w, band.h, fill_rect_linear_gradient_band, &band))
+      {
+        fill_rect_linear_gradient_band(&band, band.y, band.h);
       }
+      endWrite();
+    }
+    if( is_vertical && h ) { // leaves the color of the last row, as drawn row by row before
+      setColor(color888(scanline[h-1].r, scanline[h-1].g, scanline[h-1].b));
     }
-    endWrite();
   }
 
   void LGFXBase::fill_rect_gradient(int32_t x, int32_t y, uint32_t w, uint32_t h, const colors_t gradient, fill_style_t style )
@@ -1171,23 +1308,36 @@ namespace lgfx
     r++;
     int32_t r2 = r * r;
 
+    // the edge pixels of each corner row are blended as one run. (left side, and mirrored for the right side)
+    auto span = (argb8888_t*)alloca(r * 2 * sizeof(argb8888_t));
+    auto mirror = &span[r];
+
     for (int32_t cy = r - 1; cy > 0; cy--)
     {
       int32_t dy2 = (r - cy) * (r - cy);
+      int32_t cs = xs;
+      int32_t len = 0;
       for (cx = xs; cx < r; cx++)
       {
         int32_t hyp2 = (r - cx) * (r - cx) + dy2;
         if (hyp2 <= r1) break;
+        span[cx - cs] = 0;
         if (hyp2 >= r2) continue;
         float alphaf = (float)r - sqrtf(hyp2);
         if (alphaf > HiAlphaTheshold) break;
         xs = cx;
         if (alphaf < LoAlphaTheshold) continue;
         uint8_t alpha = alphaf * 255;
-        fillRectAlpha(x + cx - r    , y + cy - r    , 1, 1, alpha, rgb888);
-        fillRectAlpha(x - cx + r + w, y + cy - r    , 1, 1, alpha, rgb888);
-        fillRectAlpha(x - cx + r + w, y - cy + r + h, 1, 1, alpha, rgb888);
-        fillRectAlpha(x + cx - r    , y - cy + r + h, 1, 1, alpha, rgb888);
+        span[cx - cs] = rgb888 | (uint32_t)alpha << 24;
+        len = cx - cs + 1;
+      }
+      if (len)
+      {
+        for (int32_t i = 0; i < len; ++i) { mirror[len - 1 - i] = span[i]; }
+        push_alpha_span(x + cs - r            , y + cy - r    , len, span);
+        push_alpha_span(x - cs + r + w - len + 1, y + cy - r    , len, mirror);
+        push_alpha_span(x - cs + r + w - len + 1, y - cy + r + h, len, mirror);
+        push_alpha_span(x + cs - r            , y - cy + r + h, len, span);
       }
       writeFastHLine(x + cx - r, y + cy - r, 2 * (r - cx) + 1 + w);
       writeFastHLine(x + cx - r, y - cy + r + h, 2 * (r - cx) + 1 + w);
@@ -1606,6 +1756,168 @@ namespace lgfx
     endWrite();
   }
 
+  struct affine_band_t
+  {
+    IPanel* panel;
+    pixelcopy_t* pc;
+    pixelcopy_t* pc2;
+    int32_t iA[6];      // iA[2] and iA[5] are the values for the row before min_y
+    int32_t min_y;
+    int32_t xs1, xs2, ys1, ys2;
+    int32_t cl, cr;
+    uint32_t x32_diff, y32_diff;
+    int32_t tile_w;     // 0 = whole rows
+    bool fixed_span;    // 0/90/180/270 degrees : the row step (iA[1] / iA[4]) of each bound is 0, so every row has the same left and right
+  };
+
+  struct affine_span_t
+  {
+    int32_t left;
+    int32_t right;
+    int32_t ia2;
+    int32_t ia5;
+  };
+
+  /// 一度に範囲を求める行数。タイル描画時はタイルの高さになる;
+  static constexpr int32_t affine_tile_h = 32;
+  /// タイルの幅。転送元の参照範囲がL1キャッシュに収まるよう、タイル単位で描画する;
+  static constexpr int32_t affine_tile_w = 64;
+
+  /// 行y~y+rows-1 の描画範囲と逆変換の値を求める。pcを指定した場合、範囲の左端が転送元の外になる行は描画しない;
+  static void affine_spans(const affine_band_t* b, int32_t y, int32_t rows, affine_span_t* spans, const pixelcopy_t* pc)
+  {
+    auto iA = b->iA;
+    int32_t ia2 = iA[2] + (uint32_t)iA[1] * (y - b->min_y);
+    int32_t ia5 = iA[5] + (uint32_t)iA[4] * (y - b->min_y);
+    int32_t cl = b->cl;
+    int32_t cr = b->cr;
+    int32_t left = 0;
+    int32_t right = 0;
+    for (int32_t k = 0; k < rows; ++k)
+    {
+      ia2 += iA[1];
+      ia5 += iA[4];
+      if (k == 0 || !b->fixed_span)
+      {
+        left  = std::max(cl, std::max(iA[0] ? (ia2 + b->xs1) / - iA[0] : cl, iA[3] ? (ia5 + b->ys1) / - iA[3] : cl));
+        right = std::min(cr, std::min(iA[0] ? (ia2 + b->xs2) / - iA[0] : cr, iA[3] ? (ia5 + b->ys2) / - iA[3] : cr));
+      }
+      auto& s = spans[k];
+      s.left = left;
+      s.right = right;
+      s.ia2 = ia2;
+      s.ia5 = ia5;
+      if (pc && left < right)
+      {
+        pixelcopy_t tmp;
+        tmp.src_x32 = ia2 + left * iA[0];
+        tmp.src_y32 = ia5 + left * iA[3];
+        if (static_cast<uint32_t>(tmp.src_x) >= static_cast<uint32_t>(pc->src_width)
+         || static_cast<uint32_t>(tmp.src_y) >= static_cast<uint32_t>(pc->src_height))
+        {
+          s.right = left;
+        }
+      }
+    }
+  }
+
+  static void push_image_affine_band(void* arg, int32_t y, int32_t h)
+  {
+    auto b = (affine_band_t*)arg;
+    auto iA = b->iA;
+    // 帯ごとにpixelcopyを複製し、帯の先頭行の位置から逆変換を始める;
+    pixelcopy_t pc = *b->pc;
+    affine_span_t spans[affine_tile_h];
+    int32_t ye = y + h;
+    do
+    {
+      int32_t rows = std::min(affine_tile_h, ye - y);
+      affine_spans(b, y, rows, spans, &pc);
+      int32_t tx = b->cl;
+      do
+      {
+        int32_t txe = b->tile_w ? std::min(b->cr, tx + b->tile_w) : b->cr;
+        for (int32_t k = 0; k < rows; ++k)
+        {
+          auto& s = spans[k];
+          int32_t left  = std::max(s.left , tx );
+          int32_t right = std::min(s.right, txe);
+          if (left < right)
+          {
+            pc.src_x32 = s.ia2 + left * iA[0];
+            pc.src_y32 = s.ia5 + left * iA[3];
+            pc.src_x32_add = iA[0];
+            pc.src_y32_add = iA[3];
+            b->panel->writeImage(left, y + k, right - left, 1, &pc, true);
+          }
+        }
+        tx = txe;
+      } while (tx < b->cr);
+      y += rows;
+    } while (y < ye);
+  }
+
+  static void push_image_affine_aa_band(void* arg, int32_t y, int32_t h)
+  {
+    auto b = (affine_band_t*)arg;
+    auto iA = b->iA;
+    pixelcopy_t pc = *b->pc;
+    pixelcopy_t pc2 = *b->pc2;
+    auto buffer = (argb8888_t*)alloca((b->tile_w ? b->tile_w : (b->cr - b->cl)) * sizeof(argb8888_t));
+    pc2.src_data = buffer;
+    uint32_t x32_diff = b->x32_diff;
+    uint32_t y32_diff = b->y32_diff;
+    affine_span_t spans[affine_tile_h];
+    int32_t ye = y + h;
+    do
+    {
+      int32_t rows = std::min(affine_tile_h, ye - y);
+      affine_spans(b, y, rows, spans, nullptr);
+      int32_t tx = b->cl;
+      do
+      {
+        int32_t txe = b->tile_w ? std::min(b->cr, tx + b->tile_w) : b->cr;
+        for (int32_t k = 0; k < rows; ++k)
+        {
+          auto& s = spans[k];
+          int32_t left  = std::max(s.left , tx );
+          int32_t right = std::min(s.right, txe);
+          if (left < right)
+          {
+            int32_t len = right - left;
+
+            uint32_t xs = s.ia2 + left * iA[0];
+            pc.src_x32 = xs - x32_diff;
+            pc.src_xe32 = xs + x32_diff;
+            uint32_t ys = s.ia5 + left * iA[3];
+            pc.src_y32 = ys - y32_diff;
+            pc.src_ye32 = ys + y32_diff;
+
+            pc.fp_copy(buffer, 0, len, &pc);
+            pc2.src_x32_add = 1 << pixelcopy_t::FP_SCALE;
+            pc2.src_y32_add = 0;
+            pc2.src_x32 = 0;
+            pc2.src_y32 = 0;
+            b->panel->writeImageARGB(left, y + k, len, 1, &pc2);
+          }
+        }
+        tx = txe;
+      } while (tx < b->cr);
+      y += rows;
+    } while (y < ye);
+  }
+
+  /// 転送元を列方向に辿る角度では、メモリ上の描画先に対してタイル単位で描画する;
+  /// Tiles pay off only when the walk is close to a source column (within about 27 degrees
+  /// of 90/270); at 30~60 degrees a row still reuses the cache lines of the previous row,
+  /// and the extra spans make the blit slower.
+  static void affine_setup_tiles(affine_band_t* b, IPanel* panel)
+  {
+    auto iA = b->iA;
+    b->fixed_span = (iA[1] == 0 && iA[3] == 0) || (iA[0] == 0 && iA[4] == 0);
+    b->tile_w = (panel->isFrameBuffer() && (abs(iA[3]) >> 1) > abs(iA[0])) ? affine_tile_w : 0;
+  }
+
   void LGFXBase::push_image_affine(const float* matrix, pixelcopy_t* pc)
   {
     int32_t min_y = matrix[3] * (pc->src_width  << FP_SCALE);
@@ -1643,33 +1955,24 @@ namespace lgfx
     int32_t ys1 = (iA[3] < 0 ?   - scale_h :   1) - iA[3];
     int32_t ys2 = (iA[3] < 0 ? 0 : (1 - scale_h)) - iA[3];
 
-    int32_t cl = _clip_l    ;
-    int32_t cr = _clip_r + 1;
-
-    int32_t y = min_y - max_y;
+    affine_band_t band = {};
+    band.panel = _panel;
+    band.pc = pc;
+    memcpy(band.iA, iA, sizeof(iA));
+    band.min_y = min_y;
+    band.xs1 = xs1;
+    band.xs2 = xs2;
+    band.ys1 = ys1;
+    band.ys2 = ys2;
+    band.cl = _clip_l;
+    band.cr = _clip_r + 1;
+    affine_setup_tiles(&band, _panel);
 
     startWrite();
-    do
+    if (!_panel->writeBands(band.cl, min_y, band.cr - band.cl, max_y - min_y, push_image_affine_band, &band))
     {
-      iA[2] += iA[1];
-      iA[5] += iA[4];
-      int32_t left  = std::max(cl, std::max(iA[0] ? (iA[2] + xs1) / - iA[0] : cl, iA[3] ? (iA[5] + ys1) / - iA[3] : cl));
-      int32_t right = std::min(cr, std::min(iA[0] ? (iA[2] + xs2) / - iA[0] : cr, iA[3] ? (iA[5] + ys2) / - iA[3] : cr));
-      if (left < right)
-      {
-        pc->src_x32 = iA[2] + left * iA[0];
-        if (static_cast<uint32_t>(pc->src_x) < static_cast<uint32_t>(pc->src_width))
-        {
-          pc->src_y32 = iA[5] + left * iA[3];
-          if (static_cast<uint32_t>(pc->src_y) < static_cast<uint32_t>(pc->src_height))
-          {
-            pc->src_x32_add = iA[0];
-            pc->src_y32_add = iA[3];
-            _panel->writeImage(left, y + max_y, right - left, 1, pc, true);
-          }
-        }
-      }
-    } while (++y);
+      push_image_affine_band(&band, min_y, max_y - min_y);
+    }
     endWrite();
   }
 
@@ -1714,38 +2017,27 @@ namespace lgfx
     int32_t ys1 = (iA[3] < 0 ?   - scale_h :   1) - iA[3] + y32_diff;
     int32_t ys2 = (iA[3] < 0 ? 0 : (1 - scale_h)) - iA[3] + y32_diff;
 
-    int32_t cl = _clip_l    ;
-    int32_t cr = _clip_r + 1;
-
-    auto buffer = (argb8888_t*)alloca((cr - cl) * sizeof(argb8888_t));
-    pc2->src_data = buffer;
+    affine_band_t band = {};
+    band.panel = _panel;
+    band.pc = pc;
+    band.pc2 = pc2;
+    memcpy(band.iA, iA, sizeof(iA));
+    band.min_y = min_y;
+    band.xs1 = xs1;
+    band.xs2 = xs2;
+    band.ys1 = ys1;
+    band.ys2 = ys2;
+    band.cl = _clip_l;
+    band.cr = _clip_r + 1;
+    band.x32_diff = x32_diff;
+    band.y32_diff = y32_diff;
+    affine_setup_tiles(&band, _panel);
 
     startWrite();
-    do
+    if (!_panel->writeBands(band.cl, min_y, band.cr - band.cl, max_y - min_y, push_image_affine_aa_band, &band))
     {
-      iA[2] += iA[1];
-      iA[5] += iA[4];
-      int32_t left  = std::max(cl, std::max(iA[0] ? (iA[2] + xs1) / - iA[0] : cl, iA[3] ? (iA[5] + ys1) / - iA[3] : cl));
-      int32_t right = std::min(cr, std::min(iA[0] ? (iA[2] + xs2) / - iA[0] : cr, iA[3] ? (iA[5] + ys2) / - iA[3] : cr));
-      if (left < right)
-      {
-        int32_t len = right - left;
-
-        uint32_t xs = iA[2] + left * iA[0];
-        pc->src_x32 = xs - x32_diff;
-        pc->src_xe32 = xs + x32_diff;
-        uint32_t ys = iA[5] + left * iA[3];
-        pc->src_y32 = ys - y32_diff;
-        pc->src_ye32 = ys + y32_diff;
-
-        pc->fp_copy(buffer, 0, len, pc);
-        pc2->src_x32_add = 1 << pixelcopy_t::FP_SCALE;
-        pc2->src_y32_add = 0;
-        pc2->src_x32 = 0;
-        pc2->src_y32 = 0;
-        _panel->writeImageARGB(left, min_y, len, 1, pc2);
-      }
-    } while (++min_y != max_y);
+      push_image_affine_aa_band(&band, min_y, max_y - min_y);
+    }
     endWrite();
   }
 
@@ -1791,8 +2083,11 @@ namespace lgfx
 
     startWrite();
     if (w && h)
-    {
-      _panel->copyRect(dst_x, dst_y, w, h, src_x, src_y);
+    { // 全幅の縦スクロールは、対応していればパネル側で画像を移動する;
+      if (dx != 0 || _sx != 0 || _sw != width() || !_panel->scrollVertical(_sy, _sh, dy))
+      {
+        _panel->copyRect(dst_x, dst_y, w, h, src_x, src_y);
+      }
     }
 
     int_fast16_t sx = _sx;
@@ -1850,99 +2145,176 @@ namespace lgfx
 
   struct paint_point_t { int32_t lx,rx,y,oy; };
 
-  static void paint_add_points(std::list<paint_point_t>& points, int32_t lx, int32_t rx, int32_t y, int32_t oy, uint8_t* linebuf)
+  /// Pending spans of floodFill. Starts on the supplied work area and moves to the heap when it runs out.
+  struct paint_stack_t
+  {
+    paint_point_t* points = nullptr;
+    uint32_t count = 0;
+    uint32_t capacity = 0;
+    bool on_heap = false;
+
+    ~paint_stack_t(void) { if (on_heap) { heap_free(points); } }
+
+    bool push(int32_t lx, int32_t rx, int32_t y, int32_t oy)
+    {
+      if (count == capacity)
+      {
+        uint32_t newcap = capacity < 32 ? 64 : capacity << 1;
+        auto p = (paint_point_t*)heap_alloc(newcap * sizeof(paint_point_t));
+        if (p == nullptr) { return false; }
+        if (count) { memcpy(p, points, count * sizeof(paint_point_t)); }
+        if (on_heap) { heap_free(points); }
+        points = p;
+        capacity = newcap;
+        on_heap = true;
+      }
+      points[count++] = { lx, rx, y, oy };
+      return true;
+    }
+  };
+
+  static bool paint_add_points(paint_stack_t& points, int32_t lx, int32_t rx, int32_t y, int32_t oy, uint8_t* linebuf)
   {
-    paint_point_t pt { 0, 0, y, oy };
     do
     {
       while (lx < rx && !linebuf[lx]) ++lx;
       if (!linebuf[lx]) break;
-      pt.lx = lx;
+      int32_t l = lx;
       while (++lx <= rx && linebuf[lx]);
-      pt.rx = lx - 1;
-      points.emplace_back(pt);
+      if (!points.push(l, lx - 1, y, oy)) return false;
     } while (lx <= rx);
+    return true;
   }
 
-  void LGFXBase::floodFill(int32_t x, int32_t y)
+  bool LGFXBase::floodFill(int32_t x, int32_t y)
   {
-    if (x < _clip_l || x > _clip_r || y < _clip_t || y > _clip_b) return;
+    return flood_fill(x, y, 0, false);
+  }
+
+  bool LGFXBase::flood_fill(int32_t x, int32_t y, uint32_t border_raw, bool use_border)
+  {
+    if (x < _clip_l || x > _clip_r || y < _clip_t || y > _clip_b) return true;
     bgr888_t target;
     readRectRGB(x, y, 1, 1, &target);
-    if (_color.raw == _write_conv.convert(lgfx::color888(target.r, target.g, target.b))) return;
+    uint32_t seed_raw = _read_conv.convert(lgfx::color888(target.r, target.g, target.b));
 
     pixelcopy_t p;
-    p.transp = _read_conv.convert(lgfx::color888(target.r, target.g, target.b));
     p.src_bits = _read_conv.depth & color_depth_t::bit_mask;
+    if (use_border)
+    {
+      if (seed_raw == border_raw) return true;
+      if (_color.raw == _write_conv.convert(lgfx::color888(target.r, target.g, target.b))) return true;
+      // The fill colour is taken from the panel itself, so that it is compared in the same form as readRect returns.
+      startWrite();
+      writeFillRectPreclipped(x, y, 1, 1);
+      readRectRGB(x, y, 1, 1, &target);
+      endWrite();
+      p.transp = border_raw;
+      p.fore_rgb888 = _read_conv.convert(lgfx::color888(target.r, target.g, target.b));
+      if (p.fore_rgb888 == border_raw) return true;
+    }
+    else
+    {
+      if (_color.raw == _write_conv.convert(lgfx::color888(target.r, target.g, target.b))) return true;
+      p.transp = seed_raw;
+    }
     switch (_read_conv.depth)
     {
-    case color_depth_t::rgb888_3Byte: p.fp_copy = pixelcopy_t::compare_rgb_affine<bgr888_t>;  break;
-    case color_depth_t::rgb666_3Byte: p.fp_copy = pixelcopy_t::compare_rgb_affine<bgr666_t>;  break;
-    case color_depth_t::rgb565_2Byte: p.fp_copy = pixelcopy_t::compare_rgb_affine<swap565_t>; break;
-    case color_depth_t::rgb332_1Byte: p.fp_copy = pixelcopy_t::compare_rgb_affine<rgb332_t>;  break;
-    case color_depth_t::grayscale_8bit: p.fp_copy = pixelcopy_t::compare_rgb_affine<grayscale_t>;  break;
-    default: p.fp_copy = pixelcopy_t::compare_bit_affine;
+    case color_depth_t::rgb888_3Byte: p.fp_copy = use_border ? pixelcopy_t::compare_rgb_border_affine<bgr888_t>    : pixelcopy_t::compare_rgb_affine<bgr888_t>;    break;
+    case color_depth_t::rgb666_3Byte: p.fp_copy = use_border ? pixelcopy_t::compare_rgb_border_affine<bgr666_t>    : pixelcopy_t::compare_rgb_affine<bgr666_t>;    break;
+    case color_depth_t::rgb565_2Byte: p.fp_copy = use_border ? pixelcopy_t::compare_rgb_border_affine<swap565_t>   : pixelcopy_t::compare_rgb_affine<swap565_t>;   break;
+    case color_depth_t::rgb332_1Byte: p.fp_copy = use_border ? pixelcopy_t::compare_rgb_border_affine<rgb332_t>    : pixelcopy_t::compare_rgb_affine<rgb332_t>;    break;
+    case color_depth_t::grayscale_8bit: p.fp_copy = use_border ? pixelcopy_t::compare_rgb_border_affine<grayscale_t> : pixelcopy_t::compare_rgb_affine<grayscale_t>; break;
+    default: p.fp_copy = use_border ? pixelcopy_t::compare_bit_border_affine : pixelcopy_t::compare_bit_affine;
       p.src_mask = (1 << p.src_bits) - 1;
       p.transp &= p.src_mask;
+      p.fore_rgb888 &= p.src_mask;
       break;
     }
 
     const int32_t cl = _clip_l;
-    const int32_t w = _clip_r - cl + 1;
-    size_t bufIdx = 0;
-    uint8_t* linebufs[3] = { new uint8_t[w], new uint8_t[w], new uint8_t[w] };
+    const int32_t cr = _clip_r;
+    const int32_t w = cr - cl + 1;
+
+    // work area : 3 line buffers followed by the span stack.
+    const size_t line_bytes = (w * 3 + 3) & ~3u;
+    uint8_t* work = (uint8_t*)_fill_work;
+    size_t work_len = _fill_work_len;
+    void* heap_work = nullptr;
+    if (work_len < line_bytes + sizeof(paint_point_t) * 32 + 3)
+    {
+      work_len = line_bytes + sizeof(paint_point_t) * (64 + w);
+      heap_work = heap_alloc(work_len);
+      if (heap_work == nullptr) return false;
+      work = (uint8_t*)heap_work;
+    }
+    uint8_t* linebufs[3] = { work, &work[w], &work[w * 2] };
     int32_t bufY[3] = {y, -2, -2};  // 3 line buffer (default: out of range.)
+
+    size_t bufIdx = 0;
+    bool complete = true;  // false once a span is dropped because the stack could not grow.
+    paint_stack_t points;
+    {
+      auto top = (uintptr_t)&work[line_bytes];
+      auto stack_top = (top + 3) & ~(uintptr_t)3;
+      points.points = (paint_point_t*)stack_top;
+      points.capacity = (uint32_t)(((uintptr_t)work + work_len - stack_top) / sizeof(paint_point_t));
+    }
+
+    p.src_x32_add = 1 << FP_SCALE;
+    p.src_y32_add = 0;
     _panel->readRect(cl, y, w, 1, linebufs[0], &p);
-    std::list<paint_point_t> points;
-    points.push_back({x, x, y, y});
+    if (use_border) { linebufs[0][x - cl] = 1; } // seed pixel was already painted above.
+    points.push(x, x, y, y);
 
     startWrite();
-    while (!points.empty())
+    while (points.count)
     {
-      int32_t y0 = bufY[bufIdx];
-
-      auto it = points.begin();
-      int32_t counter = 0;
-      while (it->y != y0 && ++it != points.end()) ++counter;
-      if (it == points.end())
-      {
-        if (counter < 256)
+      { // prefer a span on the last painted line, then on the other cached lines, to avoid reading the line again.
+        auto pts = points.points;
+        uint32_t last = points.count - 1;
+        int32_t y0 = bufY[bufIdx];
+        uint32_t idx = last;
+        while (pts[idx].y != y0 && idx) { --idx; }
+        if (pts[idx].y != y0)
         {
-          ++bufIdx;
-          int32_t y1 = bufY[(bufIdx  )%3];
-          int32_t y2 = bufY[(bufIdx+1)%3];
-          it = points.begin();
-
-          while ((it->y != y1) && (it->y != y2) && (++it != points.end()));
+          int32_t y1 = bufY[(bufIdx + 1) % 3];
+          int32_t y2 = bufY[(bufIdx + 2) % 3];
+          uint32_t limit = last > 256 ? last - 256 : 0;
+          idx = last;
+          while (pts[idx].y != y1 && pts[idx].y != y2 && idx != limit) { --idx; }
+          if (pts[idx].y != y1 && pts[idx].y != y2) { idx = last; }
         }
+        if (idx != last) { std::swap(pts[idx], pts[last]); }
+      }
+      auto& pt = points.points[--points.count];
+      int32_t lx = pt.lx;
+      int32_t rx = pt.rx;
+      int32_t ly = pt.y;
+      int32_t oy = pt.oy;
+
+      bufIdx = 0;
+      while (ly != bufY[bufIdx] && ++bufIdx != 3);
+      if (bufIdx == 3)
+      { // replace the line farthest from ly.
         bufIdx = 0;
-        if (it == points.end())
+        int32_t dist = abs(bufY[0] - ly);
+        for (size_t i = 1; i < 3; ++i)
         {
-          it = points.begin();
-
-          bufY[0] = it->y;
-          p.src_x32_add = 1 << FP_SCALE;
-          p.src_y32_add = 0;
-          _panel->readRect(cl, it->y, w, 1, linebufs[0], &p);
-        }
-        else
-        {
-          for (; bufIdx < 2; ++bufIdx) if (it->y == bufY[bufIdx]) break;
+          int32_t d = abs(bufY[i] - ly);
+          if (dist < d) { dist = d; bufIdx = i; }
         }
+        bufY[bufIdx] = ly;
+        p.src_x32_add = 1 << FP_SCALE;
+        p.src_y32_add = 0;
+        _panel->readRect(cl, ly, w, 1, linebufs[bufIdx], &p);
       }
       auto linebuf = &linebufs[bufIdx][- cl];
-
-      int32_t lx = it->lx;
-      int32_t rx = it->rx;
-      int32_t ly = it->y;
-      int32_t oy = it->oy;
-      points.erase(it);
       if (!linebuf[lx]) continue;
 
       int32_t lxsav = lx - 1;
       int32_t rxsav = rx + 1;
 
-      const int32_t cr = _clip_r;
       while (lx > cl && linebuf[lx - 1]) --lx;
       while (rx < cr && linebuf[rx + 1]) ++rx;
       bool flg_noexpanded = lx >= lxsav && rxsav >= rx;
@@ -1967,12 +2339,12 @@ namespace lgfx
           p.src_y32_add = 0;
           _panel->readRect(cl, newy, w, 1, linebufs[bidx], &p);
         }
-        paint_add_points(points, lx ,rx, newy, ly, &linebufs[bidx][- cl]);
+        if (!paint_add_points(points, lx ,rx, newy, ly, &linebufs[bidx][- cl])) { complete = false; }
       } while (++i < 2);
     }
-    size_t i = 0;
-    do { delete[] linebufs[i]; } while (++i != 3);
     endWrite();
+    if (heap_work) { heap_free(heap_work); }
+    return complete;
   }
 
 //----------------------------------------------------------------------------
@@ -2266,6 +2638,21 @@ namespace lgfx
     int32_t sy = 65536 * _text_style.size_y;
     int32_t cheight = (metrics.height * sy) >> 16;
 
+    if (_text_buffered)
+    {
+      struct draw_arg_t { const char* string; textdatum_t datum; const IFont* font; };
+      draw_arg_t arg = { string, datum, font };
+      size_t res;
+      if (draw_string_strip(x, y, datum, cwidth, metrics, [](LGFXBase* strip, int32_t x, int32_t y, void* arg) -> size_t
+        {
+          auto a = (draw_arg_t*)arg;
+          return strip->draw_string(a->string, x, y, a->datum, a->font);
+        }, &arg, &res))
+      {
+        return res;
+      }
+    }
+
     if (string && string[0]) {
       auto tmp = string;
       do {
@@ -2608,6 +2995,7 @@ namespace lgfx
       break;
     }
 
+    this->_runtime_font->setGlyphCacheSize(_font_cache_size);
     if (this->_runtime_font->loadFont(data)) {
       result = true;
       this->_font = this->_runtime_font.get();
@@ -2623,6 +3011,77 @@ namespace lgfx
     if (_runtime_font.get() != nullptr) { setFont(&fonts::Font0); }
   }
 
+  bool LGFXBase::draw_string_strip(int32_t x, int32_t y, textdatum_t datum, int32_t cwidth, const FontMetrics& metrics, size_t (*draw)(LGFXBase* strip, int32_t x, int32_t y, void* arg), void* arg, size_t* result)
+  { // 行全体をストリップバッファに描画してから、1回の pushImageDMA で送る;
+    if ((_text_style.fore_rgb888 == _text_style.back_rgb888) || hasPalette() || _write_conv.bits < 8) { return false; }
+
+    int32_t sy = 65536 * _text_style.size_y;
+    int32_t cheight = (metrics.height * sy) >> 16;
+    int32_t left = x;
+    if (datum & top_center) {
+      left -= cwidth >> 1;
+    } else if (datum & top_right) {
+      left -= cwidth;
+    }
+    int32_t right = left + cwidth;
+    int32_t padx = _text_style.padding_x;
+    if (padx > cwidth) {
+      int32_t padl = (datum & top_center) ? x - (padx >> 1)
+                   : (datum & top_right)  ? x - padx
+                   : x;
+      left  = std::min(left , padl);
+      right = std::max(right, padl + padx);
+    }
+    int32_t top = y;
+    if (datum & middle_left) {
+      top -= cheight >> 1;
+    } else if (datum & bottom_left) {
+      top -= cheight;
+    } else if (datum & baseline_left) {
+      top -= (metrics.baseline * sy) >> 16;
+    }
+    int32_t w = right - left;
+    if (w <= 0 || cheight <= 0) { return false; }
+
+    // ストリップバッファは確保したまま次の描画で再利用する;
+    size_t size = (w * _write_conv.bits >> 3) * cheight;
+    if (_text_strip_size < size)
+    {
+      _text_strip_size = 0;
+      _text_strip.reset(size, AllocationSource::Dma);
+      if (!_text_strip) { return false; }
+      _text_strip_size = size;
+    }
+
+    auto depth = getColorDepth();
+    LGFX_Sprite strip;
+    strip.setColorDepth(depth);
+    strip.setBuffer(_text_strip.get(), w, cheight);
+    strip.setTextStyle(_text_style);
+    strip.setEmojiCallback(_emoji_draw_cb);
+    strip.setColor(_text_style.back_rgb888);
+    strip.fillRect(0, 0, w, cheight);
+    *result = draw(&strip, x - left, y - top, arg);
+
+    pixelcopy_t pc(_text_strip.get(), depth, depth, false);
+    pushImage(left, top, w, cheight, &pc, true);
+    waitDMA();
+    return true;
+  }
+
+  uint8_t* LGFXBase::getFontScratch(size_t size)
+  {
+    if (_font_scratch_size < size)
+    {
+      _font_scratch_size = 0;
+      _font_scratch.reset(size, AllocationSource::Normal);
+      ++_font_scratch_alloc;
+      if (!_font_scratch) { return nullptr; }
+      _font_scratch_size = size;
+    }
+    return _font_scratch.get();
+  }
+
   void LGFXBase::showFont(uint32_t td)
   {
     int_fast16_t x = 0;
@@ -2993,6 +3452,8 @@ namespace lgfx
   struct draw_jpg_info_t : public image_decoder_t
   {
     pixelcopy_t *pc;
+    uint32_t (*fp_output)(void*, void*, JRECT*);
+    uint32_t* output_us;
   };
 
   static uint32_t jpg_push_image(void *device, void *bitmap, JRECT *rect)
@@ -3035,7 +3496,43 @@ namespace lgfx
     return 1;
   }
 
+  struct jpg_decoder_t
+  {
+    lgfxJdec jdec;
+    uint32_t sz_pool;
+    uint8_t* pool(void) { return reinterpret_cast<uint8_t*>(this + 1); }
+  };
+
+  void LGFXBase::releaseJpgMemory(void)
+  {
+    _jpg_decoder.release();
+  }
+
+  void LGFXBase::setJpgInputBufferSize(uint16_t size)
+  {
+    size = (size < JD_SZBUF) ? JD_SZBUF : (size & ~3u);
+    if (_jpg_sz_buf != size)
+    {
+      _jpg_sz_buf = size;
+      releaseJpgMemory();
+    }
+  }
+
+  static uint32_t jpg_push_image_timed(void *device, void *bitmap, JRECT *rect)
+  {
+    draw_jpg_info_t *jpeg = static_cast<draw_jpg_info_t*>(device);
+    auto t = lgfx::micros();
+    auto res = jpeg->fp_output(device, bitmap, rect);
+    *jpeg->output_us += lgfx::micros() - t;
+    return res;
+  }
+
   bool LGFXBase::draw_jpg(DataWrapper* data, int32_t x, int32_t y, int32_t maxWidth, int32_t maxHeight, int32_t offX, int32_t offY, float zoom_x, float zoom_y, datum_t datum)
+  {
+    return draw_jpg(data, x, y, maxWidth, maxHeight, offX, offY, zoom_x, zoom_y, datum, nullptr, JD_REUSE_NONE);
+  }
+
+  bool LGFXBase::draw_jpg(DataWrapper* data, int32_t x, int32_t y, int32_t maxWidth, int32_t maxHeight, int32_t offX, int32_t offY, float zoom_x, float zoom_y, datum_t datum, uint32_t* output_us, uint8_t table_reuse)
   {
     prepareTmpTransaction(data);
     draw_jpg_info_t drawinfo;
@@ -3043,23 +3540,31 @@ namespace lgfx
     drawinfo.pc = &pc;
     drawinfo.data = data;
 
-    //TJpgD jpegdec;
-    lgfxJdec jpegdec;
-
-    static constexpr uint16_t sz_pool = 3900;
-    uint8_t *pool = (uint8_t*)malloc(sz_pool);
-    if (!pool)
+    /// デコーダとワークメモリはインスタンスごとに保持し、解放せずに再利用する。
+    /// テーブルの引き継ぎ (JD_REUSE_TAKE) は同じストリームの連続したフレーム (MJPEG) でのみ使用し、前回と同じ DHT/DQT セグメントのテーブルは再構築しない。
+    /// メモリを明示的に解放したい場合は releaseJpgMemory を使用する。
+    uint16_t sz_buf = _jpg_sz_buf ? _jpg_sz_buf : JD_SZBUF;
+    auto jpgdec = (jpg_decoder_t*)_jpg_decoder.get();
+    if (jpgdec == nullptr)
     {
-      // ESP_LOGW("LGFX", "jpeg memory alloc fail");
-      return false;
+      uint32_t sz_pool = 3900 - JD_SZBUF + sz_buf;
+      _jpg_decoder.reset(sizeof(jpg_decoder_t) + sz_pool, AllocationSource::Normal);
+      jpgdec = (jpg_decoder_t*)_jpg_decoder.get();
+      if (!jpgdec)
+      {
+        // ESP_LOGW("LGFX", "jpeg memory alloc fail");
+        return false;
+      }
+      memset(&jpgdec->jdec, 0, sizeof(lgfxJdec));
+      jpgdec->sz_pool = sz_pool;
     }
+    auto& jpegdec = jpgdec->jdec;
 
-    auto jres = lgfx_jd_prepare(&jpegdec, drawinfo.read_data, pool, sz_pool, &drawinfo);
+    auto jres = lgfx_jd_prepare_ex(&jpegdec, drawinfo.read_data, jpgdec->pool(), jpgdec->sz_pool, sz_buf, &drawinfo, table_reuse);
 
     if (jres != JDR_OK)
     {
       // ESP_LOGW("LGFX", "jpeg prepare error:%x", jres);
-      free(pool);
       return false;
     }
 
@@ -3075,7 +3580,6 @@ namespace lgfx
                        , datum
                        , jpegdec.width, jpegdec.height))
     {
-      free(pool);
       return false;
     }
 
@@ -3096,14 +3600,14 @@ namespace lgfx
 
     this->startWrite(!data->hasParent());
 
-    jres = lgfx_jd_decomp(&jpegdec, drawinfo.zoom_x == 1.0f && drawinfo.zoom_y == 1.0f ? jpg_push_image : jpg_push_image_affine, div);
+    drawinfo.fp_output = drawinfo.zoom_x == 1.0f && drawinfo.zoom_y == 1.0f ? jpg_push_image : jpg_push_image_affine;
+    drawinfo.output_us = output_us;
+    jres = lgfx_jd_decomp(&jpegdec, output_us ? jpg_push_image_timed : drawinfo.fp_output, div);
 
     drawinfo.end();
     this->endWrite();
     drawinfo.data->preRead();
 
-    free(pool);
-
     if (jres != JDR_OK) {
       // ESP_LOGW("LGFX", "jpeg decomp error:%x", jres);
       return false;
@@ -3559,15 +4063,22 @@ namespace lgfx
     return pImage;
   }
 
-  void* LGFXBase::createPng(size_t* datalen, int32_t x, int32_t y, int32_t w, int32_t h)
+  bool LGFXBase::_adjust_capture_area(int32_t& x, int32_t& y, int32_t& w, int32_t& h)
   {
-    if (_adjust_abs(x, w)||_adjust_abs(y, h)) return nullptr;
+    if (w == 0) w = width()  - x;  // 0 : up to the right / bottom edge
+    if (h == 0) h = height() - y;
+    if (_adjust_abs(x, w)||_adjust_abs(y, h)) return false;
     if (x < 0) { w += x; x = 0; }
     if (w > width() - x)  w = width()  - x;
-    if (w < 1) return nullptr;
+    if (w < 1) return false;
     if (y < 0) { h += y; y = 0; }
     if (h > height() - y) h = height() - y;
-    if (h < 1) return nullptr;
+    return h > 0;
+  }
+
+  void* LGFXBase::createPng(size_t* datalen, int32_t x, int32_t y, int32_t w, int32_t h)
+  {
+    if (!_adjust_capture_area(x, y, w, h)) return nullptr;
 
     void* rgbBuffer = heap_alloc_dma(w * 3);
 
@@ -3580,6 +4091,112 @@ namespace lgfx
     return res;
   }
 
+  struct png_stream_t
+  {
+    image_writer_cb_t writer;
+    void* user;
+    bool failed;
+  };
+
+  static bool png_write_bytes(png_stream_t* ps, const void* data, uint32_t len)
+  {
+    if (!ps->failed && !ps->writer(ps->user, (const uint8_t*)data, len)) { ps->failed = true; }
+    return !ps->failed;
+  }
+
+  static bool png_write_chunk(png_stream_t* ps, const char* type, const void* data, uint32_t len)
+  {
+    uint8_t hdr[8] = { (uint8_t)(len >> 24), (uint8_t)(len >> 16), (uint8_t)(len >> 8), (uint8_t)len
+                     , (uint8_t)type[0], (uint8_t)type[1], (uint8_t)type[2], (uint8_t)type[3] };
+    uint32_t c = (uint32_t)lgfx_mz_crc32(MZ_CRC32_INIT, &hdr[4], 4);
+    if (len) { c = (uint32_t)lgfx_mz_crc32(c, (const uint8_t*)data, len); }
+    uint8_t crc[4] = { (uint8_t)(c >> 24), (uint8_t)(c >> 16), (uint8_t)(c >> 8), (uint8_t)c };
+    return png_write_bytes(ps, hdr, 8)
+        && (len == 0 || png_write_bytes(ps, data, len))
+        && png_write_bytes(ps, crc, 4);
+  }
+
+  /// the compressed data is passed through as IDAT chunks as soon as the compressor flushes its output buffer.
+  static lgfx_mz_bool png_put_idat(const void* buf, int len, void* user)
+  {
+    return png_write_chunk(static_cast<png_stream_t*>(user), "IDAT", buf, len);
+  }
+
+  bool LGFXBase::writePng(image_writer_cb_t writer, void* user, int32_t x, int32_t y, int32_t w, int32_t h, uint8_t level)
+  {
+    if (writer == nullptr || !_adjust_capture_area(x, y, w, h)) return false;
+
+    static constexpr uint8_t png_sig[8] = { 0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A };
+    static const lgfx_mz_uint png_num_probes[11] = { 0, 1, 6, 32,  16, 32, 128, 256,  512, 768, 1500 };
+
+    auto comp = (tdefl_compressor*)heap_alloc(sizeof(tdefl_compressor));
+    if (comp == nullptr) return false;
+    auto line = (uint8_t*)heap_alloc_dma(w * 3 + 1);
+    if (line == nullptr) { heap_free(comp); return false; }
+
+    png_stream_t ps = { writer, user, false };
+
+    uint8_t ihdr[13] = { (uint8_t)(w >> 24), (uint8_t)(w >> 16), (uint8_t)(w >> 8), (uint8_t)w
+                       , (uint8_t)(h >> 24), (uint8_t)(h >> 16), (uint8_t)(h >> 8), (uint8_t)h
+                       , 8, 2, 0, 0, 0 };  // 8bit RGB, deflate, no filter, no interlace
+    bool res = png_write_bytes(&ps, png_sig, sizeof(png_sig))
+            && png_write_chunk(&ps, "IHDR", ihdr, sizeof(ihdr))
+            && TDEFL_STATUS_OKAY == tdefl_init(comp, png_put_idat, &ps, png_num_probes[level < 10 ? level : 10] | TDEFL_WRITE_ZLIB_HEADER);
+
+    line[0] = 0;  // filter type : none
+    for (int32_t ypos = 0; res && ypos < h; ++ypos)
+    {
+      readRectRGB(x, y + ypos, w, 1, &line[1]);
+      res = TDEFL_STATUS_OKAY == tdefl_compress_buffer(comp, line, w * 3 + 1, TDEFL_NO_FLUSH);
+    }
+    res = res && TDEFL_STATUS_DONE == tdefl_compress_buffer(comp, nullptr, 0, TDEFL_FINISH)
+              && png_write_chunk(&ps, "IEND", nullptr, 0);
+
+    heap_free(line);
+    heap_free(comp);
+
+    return res && !ps.failed;
+  }
+
+  struct qoi_stream_t
+  {
+    LGFXBase* gfx;
+    int32_t x;
+    int32_t y;
+    image_writer_cb_t writer;
+    void* user;
+    bool failed;
+  };
+
+  static int qoi_write_bytes(void* user, uint8_t* buf, size_t len)
+  {
+    auto qs = static_cast<qoi_stream_t*>(user);
+    if (!qs->failed && !qs->writer(qs->user, buf, len)) { qs->failed = true; }
+    return qs->failed ? 0 : len;
+  }
+
+  static uint8_t *qoi_encoder_get_row(uint8_t *lineBuffer, int, int w, int, int y, void *qoienc)
+  {
+    auto qs = static_cast<qoi_stream_t*>(qoienc);
+    qs->gfx->readRectRGB(qs->x, qs->y + y, w, 1, lineBuffer);
+    return lineBuffer;
+  }
+
+  bool LGFXBase::writeQoi(image_writer_cb_t writer, void* user, int32_t x, int32_t y, int32_t w, int32_t h)
+  {
+    if (writer == nullptr || !_adjust_capture_area(x, y, w, h)) return false;
+
+    auto line = heap_alloc_dma(w * 3);
+    if (line == nullptr) return false;
+
+    qoi_stream_t qs = { this, x, y, writer, user, false };
+    auto len = lgfx_qoi_encoder_write_cb_user(line, 512, w, h, 3, 0, qoi_encoder_get_row, qoi_write_bytes, &qs, &qs);
+
+    heap_free(line);
+
+    return len && !qs.failed;
+  }
+
 //----------------------------------------------------------------------------
 
   void LGFXBase::prepareTmpTransaction(DataWrapper* data)
@@ -3653,6 +4270,8 @@ namespace lgfx
       setRawColor(bg_rawcolor);
       fillRect(x - r, y - r, r * 2 + 1, r * 2 + 1);
       if (fg_rawcolor == bg_rawcolor) return;
+      int32_t cx, cy, cw, ch;
+      getClipRect(&cx, &cy, &cw, &ch);
       setClipRect(x - r, y - r, r * 2 + 1, r * 2 + 1);
       setRawColor(fg_rawcolor);
       startWrite();
@@ -3665,7 +4284,7 @@ namespace lgfx
       }
       display();
       endWrite();
-      clearClipRect();
+      setClipRect(cx, cy, cw, ch);
     }
 
     void LGFX_Device::calibrate_touch(uint16_t *parameters, uint32_t fg_rawcolor, uint32_t bg_rawcolor, uint8_t size)
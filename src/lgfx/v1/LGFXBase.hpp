@@ -29,6 +29,7 @@ Contributors:
 #include "misc/colortype.hpp"
 #include "misc/pixelcopy.hpp"
 #include "misc/DataWrapper.hpp"
+#include "misc/SpriteBuffer.hpp"
 #include "lgfx_fonts.hpp"
 #include "Touch.hpp"
 #include "panel/Panel_Device.hpp"
@@ -61,6 +62,13 @@ namespace lgfx
   /// @return pixel width actually drawn, or 0 if the glyph could not be rendered
   typedef int32_t (*emoji_draw_cb_t)(LGFXBase* gfx, int32_t x, int32_t y, uint32_t code, int32_t font_height);
 
+  /// Sink for the encoded data of writePng / writeQoi.
+  /// @param user   pointer given to writePng / writeQoi
+  /// @param data   encoded bytes
+  /// @param length number of bytes
+  /// @return false to abort the encoding
+  typedef bool (*image_writer_cb_t)(void* user, const uint8_t* data, uint32_t length);
+
   class LGFXBase
 #if defined (ARDUINO)
   : public Print
@@ -259,10 +267,18 @@ namespace lgfx
                   void drawCircleHelper( int32_t x, int32_t y, int32_t r, uint_fast8_t cornername);
     LGFX_INLINE_T void fillCircleHelper( int32_t x, int32_t y, int32_t r, uint_fast8_t corners, int32_t delta, const T& color)  { setColor(color); fillCircleHelper(x, y, r, corners, delta); }
                   void fillCircleHelper( int32_t x, int32_t y, int32_t r, uint_fast8_t corners, int32_t delta);
-    LGFX_INLINE_T void floodFill( int32_t x, int32_t y, const T& color) { setColor(color); floodFill(x, y); }
-                  void floodFill( int32_t x, int32_t y                );
-    LGFX_INLINE_T void paint    ( int32_t x, int32_t y, const T& color) { setColor(color); floodFill(x, y); }
-    LGFX_INLINE   void paint    ( int32_t x, int32_t y                ) {                  floodFill(x, y); }
+    /// @return false if the work area or the span stack could not be allocated. The area may then be filled only in part.
+    LGFX_INLINE_T bool floodFill( int32_t x, int32_t y, const T& color) { setColor(color); return floodFill(x, y); }
+                  bool floodFill( int32_t x, int32_t y                );
+    LGFX_INLINE_T bool paint    ( int32_t x, int32_t y, const T& color) { setColor(color); return floodFill(x, y); }
+    LGFX_INLINE   bool paint    ( int32_t x, int32_t y                ) {                  return floodFill(x, y); }
+    LGFX_INLINE_T bool boundaryFill( int32_t x, int32_t y, const T& border, const T& color) { setColor(color); return boundaryFill(x, y, border); }
+    LGFX_INLINE_T bool boundaryFill( int32_t x, int32_t y, const T& border                ) { return flood_fill(x, y, _read_conv.convert(border), true); }
+
+    /// @brief Supplies the work area used by floodFill / boundaryFill (line buffers and span stack).
+    /// @param buf work area. nullptr to allocate from the heap on each call.
+    /// @param length size of buf in bytes. If it is too small, the heap is used instead.
+    LGFX_INLINE   void setFillWorkBuffer(void* buf, size_t length) { _fill_work = buf; _fill_work_len = buf ? length : 0; }
 
     LGFX_INLINE_T void fillAffine(const float matrix[6], int32_t w, int32_t h, const T& color) { setColor(color); fillAffine(matrix, w, h); }
                   void fillAffine(const float matrix[6], int32_t w, int32_t h);
@@ -684,6 +700,11 @@ namespace lgfx
     void setTextPadding(uint32_t padding_x) { _text_style.padding_x = padding_x; }
     uint32_t getTextPadding(void) const { return _text_style.padding_x; }
     void setTextWrap( bool wrapX, bool wrapY = false) { _textwrap_x = wrapX; _textwrap_y = wrapY; }
+    /// drawString composes the whole line (with its background and padding) in a strip buffer
+    /// and sends it with a single pushImageDMA. Used only when the background color differs from the text color.
+    /// The strip buffer is kept for the next line; disabling the mode frees it.
+    void setTextBuffered(bool enable) { _text_buffered = enable; if (!enable) { _text_strip.release(); _text_strip_size = 0; } }
+    bool getTextBuffered(void) const { return _text_buffered; }
     void setTextScroll(bool scroll) { _textscroll = scroll; if (_cursor_x < this->_sx) { _cursor_x = this->_sx; } if (_cursor_y < this->_sy) { _cursor_y = this->_sy; } }
     void setEmojiCallback(emoji_draw_cb_t cb) { _emoji_draw_cb = cb; }
     emoji_draw_cb_t getEmojiCallback(void) const { return _emoji_draw_cb; }
@@ -836,6 +857,21 @@ namespace lgfx
     /// show VLW font
     void showFont(uint32_t td = 2000);
 
+    /// Set the byte budget of the in-RAM glyph cache used by loaded fonts. (0 = disabled)
+    void setFontCacheSize(size_t bytes) { _font_cache_size = bytes; if (_runtime_font.get() != nullptr) { _runtime_font->setGlyphCacheSize(bytes); } }
+    size_t getFontCacheSize(void) const { return _font_cache_size; }
+    uint32_t getFontCacheHitCount(void) const { return _runtime_font.get() != nullptr ? _runtime_font->getGlyphCacheHitCount() : 0; }
+    uint32_t getFontCacheMissCount(void) const { return _runtime_font.get() != nullptr ? _runtime_font->getGlyphCacheMissCount() : 0; }
+
+    /// Work buffer of the fonts that decode glyphs at draw time (LVGLfont).
+    /// It only grows, so once it fits the largest glyph, drawing text makes no heap allocations.
+    uint8_t* getFontScratch(size_t size);
+    size_t getFontScratchSize(void) const { return _font_scratch_size; }
+    void releaseFontScratch(void) { _font_scratch.release(); _font_scratch_size = 0; }
+    /// Number of heap allocations made by getFontScratch.
+    uint32_t getFontScratchAllocCount(void) const { return _font_scratch_alloc; }
+    void resetFontScratchAllocCount(void) { _font_scratch_alloc = 0; }
+
     void cp437(bool enable = true) { _text_style.cp437 = enable; }  // AdafruitGFX compatible.
 
     void setAttribute(attribute_t attr_id, uint8_t param);
@@ -969,6 +1005,15 @@ namespace lgfx
 
   #undef LGFX_FUNCTION_GENERATOR
 
+   protected:
+    friend class LGFX_MJpegPlayer;
+    friend class LGFX_TextRun;
+    /// output_us : adds the time spent in writing the decoded pixels (microseconds).
+    /// table_reuse : JD_REUSE_NONE / JD_REUSE_KEEP / JD_REUSE_TAKE of lgfx_tjpgd.h.
+    /// The tables are taken over only between frames of one stream.
+    bool draw_jpg(DataWrapper* data, int32_t x, int32_t y, int32_t maxWidth, int32_t maxHeight, int32_t offX, int32_t offY, float scale_x, float scale_y, datum_t datum, uint32_t* output_us, uint8_t table_reuse);
+   public:
+
     [[deprecated("use float scale")]] bool drawJpg(const uint8_t *jpg_data, uint32_t jpg_len, int32_t x, int32_t y, int32_t maxWidth, int32_t maxHeight, int32_t offX, int32_t offY, jpeg_div::jpeg_div_t scale)
     {
       return drawJpg(jpg_data, jpg_len, x, y, maxWidth, maxHeight, offX, offY, 1.0f / (1 << scale));
@@ -985,8 +1030,39 @@ namespace lgfx
 
     void* createPng( size_t* datalen, int32_t x = 0, int32_t y = 0, int32_t width = 0, int32_t height = 0);
 
+    /// @brief Encodes the area as PNG and hands the data to the writer while it is produced.
+    /// Unlike createPng, the encoded image is never held in memory; only the compressor and one line of pixels are allocated.
+    /// @param level compression level (0-10)
+    bool writePng(image_writer_cb_t writer, void* user, int32_t x = 0, int32_t y = 0, int32_t width = 0, int32_t height = 0, uint8_t level = 6);
+
+    /// @brief Encodes the area as QOI and hands the data to the writer while it is produced.
+    bool writeQoi(image_writer_cb_t writer, void* user, int32_t x = 0, int32_t y = 0, int32_t width = 0, int32_t height = 0);
+
+    /// @brief writePng to an object that has write(const uint8_t*, size_t). (File, Print, etc.)
+    template<typename T>
+    bool writePng(T& stream, int32_t x = 0, int32_t y = 0, int32_t width = 0, int32_t height = 0, uint8_t level = 6)
+    {
+      return writePng(stream_writer<T>, &stream, x, y, width, height, level);
+    }
+
+    /// @brief writeQoi to an object that has write(const uint8_t*, size_t). (File, Print, etc.)
+    template<typename T>
+    bool writeQoi(T& stream, int32_t x = 0, int32_t y = 0, int32_t width = 0, int32_t height = 0)
+    {
+      return writeQoi(stream_writer<T>, &stream, x, y, width, height);
+    }
+
     void releasePngMemory(void);
 
+    /// @brief Sets the size of the stream input buffer used by drawJpg. (default 512 byte)
+    /// @param size buffer size in bytes. A larger buffer reduces the number of reads from the data source.
+    void setJpgInputBufferSize(uint16_t size);
+
+    /// @brief Releases the JPEG decoder kept by drawJpg.
+    /// @note Each instance keeps its decoder and work memory for the next drawJpg.
+    /// LGFX_MJpegPlayer also keeps the tables, so that frames of one stream sharing the same DHT/DQT segments (or omitting them) skip rebuilding them.
+    void releaseJpgMemory(void);
+
     template<typename T>
     [[deprecated("use pushImage")]] void pushRect( int32_t x, int32_t y, int32_t w, int32_t h, const T* data) { pushImage(x, y, w, h, data); }
 
@@ -1028,6 +1104,9 @@ namespace lgfx
 
     bool _swapBytes = false;
 
+    void* _fill_work = nullptr;   // caller supplied work area for floodFill
+    size_t _fill_work_len = 0;
+
     enum utf8_decode_state_t : uint8_t
     { utf8_state0 = 0
     , utf8_state1 = 1
@@ -1049,6 +1128,14 @@ namespace lgfx
 
     std::shared_ptr<RunTimeFont> _runtime_font;  // run-time generated font
     std::shared_ptr<DataWrapper> _font_file;  // run-time font file
+    size_t _font_cache_size = 0;  // glyph cache budget for run-time font
+    SpriteBuffer _jpg_decoder;    // decoder and work memory of drawJpg
+    uint16_t _jpg_sz_buf = 0;     // stream input buffer size of drawJpg (0 = JD_SZBUF)
+    SpriteBuffer _font_scratch;   // glyph decoding buffer for fonts (see getFontScratch)
+    size_t _font_scratch_size = 0;
+    uint32_t _font_scratch_alloc = 0;
+    SpriteBuffer _text_strip;     // line buffer of setTextBuffered
+    size_t _text_strip_size = 0;
     PointerWrapper _font_data;
 
     std::shared_ptr<DataWrapperFactory> _data_wrapper_factory;
@@ -1057,8 +1144,17 @@ namespace lgfx
     bool _textwrap_x = true;
     bool _textwrap_y = false;
     bool _textscroll = false;
+    bool _text_buffered = false;
 
     LGFX_INLINE static bool _adjust_abs(int32_t& x, int32_t& w) { if (w < 0) { x += w; w = -w; } return !w; }
+
+    bool _adjust_capture_area(int32_t& x, int32_t& y, int32_t& w, int32_t& h);
+
+    template<typename T>
+    static bool stream_writer(void* user, const uint8_t* data, uint32_t length)
+    {
+      return static_cast<T*>(user)->write(data, length) == length;
+    }
     static bool _adjust_width(int32_t& x, int32_t& dx, int32_t& dw, int32_t left, int32_t width)
     {
       if (x < left) { dx = -x; dw += x; x = left; }
@@ -1336,6 +1432,7 @@ namespace lgfx
     static void make_rotation_matrix(float* result, float dst_x, float dst_y, float src_x, float src_y, float angle, float zoom_x, float zoom_y);
 
     void read_rect(int32_t x, int32_t y, int32_t w, int32_t h, void* dst, pixelcopy_t* param);
+    bool flood_fill(int32_t x, int32_t y, uint32_t border_raw, bool use_border);
 
 //----------------------------------------------------------------------------
 
@@ -1344,9 +1441,20 @@ namespace lgfx
     rgb888_t map_gradient( float value, float start, float end, const rgb888_t *colors, uint32_t colors_count );
     rgb888_t map_gradient( float value, float start, float end, const colors_t gradient );
 
+    /// gradient fills are drawn by horizontal bands, in parallel if the panel supports IPanel::writeBands.
+    struct gradient_band_t;
+    bool clip_gradient_band(int32_t x, int32_t y, uint32_t w, uint32_t h, gradient_band_t* band);
+    static void fill_rect_radial_gradient_band(void* arg, int32_t y, int32_t h);
+    static void fill_rect_linear_gradient_band(void* arg, int32_t y, int32_t h);
+
     void draw_gradient_line( int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t colorstart, uint32_t colorend );
     void draw_gradient_line( int32_t x0, int32_t y0, int32_t x1, int32_t y1, const colors_t gradient );
 
+    /// blends a horizontal run of coverage pixels with one read and one write of the run. (clipped)
+    void push_alpha_span(int32_t x, int32_t y, int32_t w, const argb8888_t* span);
+    /// writes a scanline of a shape : the anti-aliased edges are blended, the covered middle is written without reading.
+    void push_coverage_span(int32_t x, int32_t y, int32_t w, const argb8888_t* span);
+
     void draw_wedgeline         (float x0, float y0, float x1, float y1, float r0, float r1, const uint32_t fg_color);
     void draw_gradient_wedgeline(float x0, float y0, float x1, float y1, float r0, float r1, const colors_t gradient );
 
@@ -1377,6 +1485,8 @@ namespace lgfx
     size_t printNumber(unsigned long n, uint8_t base);
     size_t printFloat(double number, uint8_t digits);
     size_t draw_string(const char *string, int32_t x, int32_t y, textdatum_t datum, const IFont* font = nullptr);
+    /// Draws one line through the reused strip buffer of setTextBuffered; returns false when the line must be drawn directly.
+    bool draw_string_strip(int32_t x, int32_t y, textdatum_t datum, int32_t cwidth, const FontMetrics& metrics, size_t (*draw)(LGFXBase* strip, int32_t x, int32_t y, void* arg), void* arg, size_t* result);
     int32_t text_width(const char *string, const IFont* font, FontMetrics* metrics);
     bool load_font(lgfx::DataWrapper* data, IFont::font_type_t font_type);
     bool load_font_with_path(const char *path, IFont::font_type_t font_type);
@@ -0,0 +1,430 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+
+#include "LGFX_DisplayList.hpp"
+
+#include "misc/common_function.hpp"
+
+#include <string.h>
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  bool Panel_DisplayList::createList(int32_t w, int32_t h, bool psram)
+  {
+    deleteList();
+    if (w < 1 || h < 1 || w > UINT16_MAX || h > UINT16_MAX) { return false; }
+    _psram = psram;
+    _row = (uint8_t*)heap_alloc(w * 4);
+    if (_row == nullptr) { return false; }
+    _width = w;
+    _height = h;
+    setWindow(0, 0, w - 1, h - 1);
+    return true;
+  }
+
+  void Panel_DisplayList::deleteList(void)
+  {
+    if (_list) { heap_free(_list); }
+    if (_row) { heap_free(_row); }
+    _list = nullptr;
+    _row = nullptr;
+    _capacity = 0;
+    _width = _height = 0;
+    clearList();
+  }
+
+  void Panel_DisplayList::clearList(void)
+  {
+    _length = 0;
+    _last = SIZE_MAX;
+    _op_count = 0;
+  }
+
+  bool Panel_DisplayList::reserve(size_t length)
+  {
+    length += _length;
+    if (length <= _capacity) { return true; }
+    size_t capacity = std::max<size_t>(std::max<size_t>(_capacity << 1, 1024), length);
+    uint8_t* list = nullptr;
+    if (_psram) { list = (uint8_t*)heap_alloc_psram(capacity); }
+    if (list == nullptr) { list = (uint8_t*)heap_alloc(capacity); }
+    if (list == nullptr) { return false; }
+    if (_list)
+    {
+      memcpy(list, _list, _length);
+      heap_free(_list);
+    }
+    _list = list;
+    _capacity = capacity;
+    return true;
+  }
+
+  Panel_DisplayList::op_t* Panel_DisplayList::add_op(op_type_t type, uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t value, size_t payload)
+  {
+    size_t size = (sizeof(op_t) + payload + 3) & ~3u;
+    if (!reserve(size)) { return nullptr; }
+    auto op = (op_t*)&_list[_length];
+    op->type = type;
+    op->x = x;
+    op->y = y;
+    op->w = w;
+    op->h = h;
+    op->value = value;
+    op->size = size;
+    _last = _length;
+    _length += size;
+    ++_op_count;
+    return op;
+  }
+
+  color_depth_t Panel_DisplayList::setColorDepth(color_depth_t depth)
+  {
+    uint_fast8_t bits = depth & color_depth_t::bit_mask;
+    depth = (bits <= 8)  ? rgb332_1Byte
+          : (bits <= 16) ? rgb565_2Byte
+          : (depth == rgb666_3Byte) ? rgb666_3Byte
+                         : rgb888_3Byte;
+    if (_write_depth != depth) { clearList(); }
+    _write_depth = depth;
+    _read_depth = depth;
+    return depth;
+  }
+
+  void Panel_DisplayList::setRotation(uint_fast8_t)
+  {
+    _rotation = 0;
+  }
+
+  void Panel_DisplayList::setWindow(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye)
+  {
+    xs = std::max<uint_fast16_t>(0u, std::min<uint_fast16_t>(_width  - 1, xs));
+    xe = std::max<uint_fast16_t>(0u, std::min<uint_fast16_t>(_width  - 1, xe));
+    ys = std::max<uint_fast16_t>(0u, std::min<uint_fast16_t>(_height - 1, ys));
+    ye = std::max<uint_fast16_t>(0u, std::min<uint_fast16_t>(_height - 1, ye));
+    _xpos = xs;
+    _xs = xs;
+    _xe = xe;
+    _ypos = ys;
+    _ys = ys;
+    _ye = ye;
+  }
+
+  void Panel_DisplayList::drawPixelPreclipped(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor)
+  {
+    writeFillRectPreclipped(x, y, 1, 1, rawcolor);
+  }
+
+  void Panel_DisplayList::add_fill(op_type_t type, uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t value)
+  {
+    if (_last != SIZE_MAX)
+    { // join to the previous fill. (horizontal lines of a circle, consecutive pixels of a line, etc.)
+      auto op = (op_t*)&_list[_last];
+      if (op->type == type && op->value == value)
+      {
+        if (op->y == y && op->h == h && op->x + op->w == x) { op->w += w; return; }
+        if (op->x == x && op->w == w && op->y + op->h == y) { op->h += h; return; }
+      }
+    }
+    add_op(type, x, y, w, h, value, 0);
+  }
+
+  void Panel_DisplayList::writeFillRectPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor)
+  {
+    if (x == 0 && y == 0 && w == _width && h == _height)
+    { // everything recorded so far is overwritten.
+      clearList();
+    }
+    add_fill(op_fill, x, y, w, h, rawcolor);
+  }
+
+  void Panel_DisplayList::writeFillRectAlphaPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t argb8888)
+  {
+    if (0 == (argb8888 >> 24)) { return; }
+    add_fill(op_fill_alpha, x, y, w, h, argb8888);
+  }
+
+  void Panel_DisplayList::writeBlock(uint32_t rawcolor, uint32_t length)
+  {
+    do
+    {
+      uint32_t h = 1;
+      auto w = std::min<uint32_t>(length, _xe + 1 - _xpos);
+      if (length >= (w << 1) && _xpos == _xs)
+      {
+        h = std::min<uint32_t>(length / w, _ye + 1 - _ypos);
+      }
+      writeFillRectPreclipped(_xpos, _ypos, w, h, rawcolor);
+      if ((_xpos += w) <= _xe) return;
+      _xpos = _xs;
+      if (_ye < (_ypos += h)) { _ypos = _ys; }
+      length -= w * h;
+    } while (length);
+  }
+
+  void Panel_DisplayList::add_image_row(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, const uint8_t* data)
+  {
+    size_t bytes = w * _write_bits >> 3;
+    if (_last != SIZE_MAX)
+    {
+      auto op = (op_t*)&_list[_last];
+      if (op->type == op_image
+       && ((op->x == x && op->w == w && op->y + op->h == y)                 // next row of the same image
+        || (op->h == 1 && op->y == y && op->x + op->w == x)))               // next span of the same row
+      {
+        size_t used = sizeof(op_t) + (op->w * op->h * _write_bits >> 3);
+        size_t size = (used + bytes + 3) & ~3u;
+        if (!reserve(size - op->size)) { return; }
+        op = (op_t*)&_list[_last];
+        memcpy(&_list[_last + used], data, bytes);
+        if (op->h == 1 && op->y == y) { op->w += w; }
+        else                          { op->h += 1; }
+        op->size = size;
+        _length = _last + size;
+        return;
+      }
+    }
+    auto op = add_op(op_image, x, y, w, 1, 0, bytes);
+    if (op) { memcpy(&op[1], data, bytes); }
+  }
+
+  void Panel_DisplayList::writePixels(pixelcopy_t* param, uint32_t length, bool use_dma)
+  {
+    (void)use_dma;
+    uint_fast16_t linelength;
+    do {
+      linelength = std::min<uint_fast16_t>(_xe - _xpos + 1, length);
+      param->fp_copy(_row, 0, linelength, param);
+      add_image_row(_xpos, _ypos, linelength, _row);
+      if ((_xpos += linelength) > _xe)
+      {
+        _xpos = _xs;
+        _ypos = (_ypos != _ye) ? (_ypos + 1) : _ys;
+      }
+    } while (length -= linelength);
+  }
+
+  void Panel_DisplayList::writeImage(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param, bool)
+  {
+    if (x == 0 && y == 0 && w == _width && h == _height && param->transp == pixelcopy_t::NON_TRANSP)
+    {
+      clearList();
+    }
+    uint32_t sx32 = param->src_x32;
+    uint32_t sy32 = param->src_y32;
+    size_t bytes = _write_bits >> 3;
+    do
+    { // convert one row, and record the opaque spans of it.
+      uint32_t pos = 0;
+      do
+      {
+        uint32_t end = param->fp_copy(_row, pos, w, param);
+        if (end != pos) { add_image_row(x + pos, y, end - pos, &_row[pos * bytes]); }
+        if (end == w) { break; }
+        pos = param->fp_skip(end, w, param);
+      } while (pos != w);
+      param->src_x32 = sx32;
+      param->src_y32 = (sy32 += 1 << pixelcopy_t::FP_SCALE);
+      ++y;
+    } while (--h);
+  }
+
+  void Panel_DisplayList::writeImageARGB(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param)
+  {
+    auto op = add_op(op_image_argb, x, y, w, h, 0, argb_header_size + w * h * sizeof(uint32_t));
+    if (op == nullptr) { return; }
+    auto payload = (uint8_t*)&op[1];
+    fp_copy_t fp = param->fp_copy;
+    memcpy(payload, &fp, sizeof(fp));
+
+    // keep the source pixels in the order the blend function reads them,
+    // so they can be replayed as a contiguous image. (argb8888 or bgra8888)
+    auto s = static_cast<const uint32_t*>(param->src_data);
+    auto d = (uint32_t*)&payload[argb_header_size];
+    auto bitwidth = param->src_bitwidth;
+    uint32_t sx32 = param->src_x32;
+    uint32_t sy32 = param->src_y32;
+    do
+    {
+      uint32_t x32 = sx32;
+      uint32_t y32 = sy32;
+      uint32_t i = w;
+      do
+      {
+        *d++ = s[(int16_t)(x32 >> pixelcopy_t::FP_SCALE) + (int16_t)(y32 >> pixelcopy_t::FP_SCALE) * bitwidth];
+        x32 += param->src_x32_add;
+        y32 += param->src_y32_add;
+      } while (--i);
+      sy32 += 1 << pixelcopy_t::FP_SCALE;
+    } while (--h);
+  }
+
+  void Panel_DisplayList::readRect(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, void* dst, pixelcopy_t* param)
+  {
+    (void)x;
+    (void)y;
+    memset(dst, 0, (w * h * param->dst_bits + 7) >> 3);
+  }
+
+  void Panel_DisplayList::replay(IPanel* band, int32_t band_y, int32_t band_h) const
+  {
+    int32_t band_ye = band_y + band_h;
+    size_t bytes = _write_bits >> 3;
+    for (size_t pos = 0; pos < _length; pos += ((const op_t*)&_list[pos])->size)
+    {
+      auto op = (const op_t*)&_list[pos];
+      int32_t ys = op->y;
+      int32_t ye = ys + op->h;
+      if (ye <= band_y || band_ye <= ys) { continue; }
+      int32_t skip = 0;
+      if (ys < band_y) { skip = band_y - ys; ys = band_y; }
+      if (ye > band_ye) { ye = band_ye; }
+      uint_fast16_t y = ys - band_y;
+      uint_fast16_t h = ye - ys;
+      auto payload = (const uint8_t*)&op[1];
+
+      switch (op->type)
+      {
+      case op_fill:
+        band->writeFillRectPreclipped(op->x, y, op->w, h, op->value);
+        break;
+
+      case op_fill_alpha:
+        band->writeFillRectAlphaPreclipped(op->x, y, op->w, h, op->value);
+        break;
+
+      case op_image:
+        {
+          pixelcopy_t pc(&payload[skip * op->w * bytes], _write_depth, _write_depth);
+          pc.src_bitwidth = op->w;
+          pc.src_width = op->w;
+          pc.src_height = h;
+          band->writeImage(op->x, y, op->w, h, &pc, false);
+        }
+        break;
+
+      case op_image_argb:
+        {
+          pixelcopy_t pc;
+          memcpy(&pc.fp_copy, payload, sizeof(fp_copy_t));
+          pc.src_data = &payload[argb_header_size];
+          pc.src_bitwidth = op->w;
+          pc.src_width = op->w;
+          pc.src_height = op->h;
+          pc.src_y = skip;
+          pc.dst_depth = _write_depth;
+          band->writeImageARGB(op->x, y, op->w, h, &pc);
+        }
+        break;
+
+      default:
+        break;
+      }
+    }
+  }
+
+//----------------------------------------------------------------------------
+
+  namespace
+  {
+    struct band_sprite_t : public LGFX_Sprite
+    {
+      IPanel* panel(void) const { return _panel; }
+    };
+  }
+
+  bool LGFX_DisplayList::createList(int32_t w, int32_t h)
+  {
+    if (!_panel_list.createList(w, h, _psram))
+    {
+      deleteList();
+      return false;
+    }
+
+    _sw = w;
+    _clip_r = w - 1;
+    _xpivot = w >> 1;
+
+    _sh = h;
+    _clip_b = h - 1;
+    _ypivot = h >> 1;
+
+    _clip_l = _clip_t = _sx = _sy = 0;
+    return true;
+  }
+
+  void LGFX_DisplayList::deleteList(void)
+  {
+    _panel_list.deleteList();
+    _clip_l = 0;
+    _clip_t = 0;
+    _clip_r = -1;
+    _clip_b = -1;
+  }
+
+  bool LGFX_DisplayList::pushBands(LovyanGFX* dst, int32_t x, int32_t y, int32_t band_height, uint_fast8_t buffer_count)
+  {
+    int32_t w = width();
+    int32_t h = height();
+    if (dst == nullptr || w <= 0 || h <= 0) { return false; }
+    if (band_height < 1) { band_height = 1; }
+    if (band_height > h) { band_height = h; }
+    if (buffer_count < 1) { buffer_count = 1; }
+
+    auto depth = getColorDepth();
+    size_t line_length = w * (depth & color_depth_t::bit_mask) >> 3;
+    size_t strip_length = line_length * band_height;
+    auto strips = (uint8_t*)heap_alloc_dma(strip_length * buffer_count);
+    if (strips == nullptr) { return false; }
+
+    band_sprite_t band;
+    band.setColorDepth(depth);
+
+    dst->startWrite();
+    uint_fast8_t index = 0;
+    for (int32_t band_y = 0; band_y < h; band_y += band_height)
+    {
+      int32_t bh = std::min(band_height, h - band_y);
+      auto strip = &strips[index * strip_length];
+      if (++index == buffer_count) { index = 0; }
+
+      // with a single strip, the previous band must be sent before drawing the next one.
+      // with two or more, the next pushImageDMA waits for the transfer before the previous one.
+      if (buffer_count == 1) { dst->waitDMA(); }
+
+      band.setBuffer(strip, w, bh);
+      memset(strip, 0, line_length * bh);
+      _panel_list.replay(band.panel(), band_y, bh);
+      if (_band_cb) { _band_cb(&band, band_y, _band_user); }
+
+      pixelcopy_t pc(strip, dst->getColorDepth(), depth, dst->hasPalette());
+      dst->pushImage(x, y + band_y, w, bh, &pc, true);
+    }
+    dst->endWrite();
+    dst->waitDMA();
+
+    heap_free(strips);
+    return true;
+  }
+
+//----------------------------------------------------------------------------
+ }
+}
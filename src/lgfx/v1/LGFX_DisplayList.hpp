@@ -0,0 +1,177 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#pragma once
+
+#include "LGFX_Sprite.hpp"
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  /// Records the preclipped drawing operations instead of writing pixels.
+  /// The recorded operations are replayed into a Panel_Sprite one band at a time.
+  struct Panel_DisplayList : public IPanel
+  {
+    Panel_DisplayList(void) { _start_count = INT32_MAX; }
+    virtual ~Panel_DisplayList(void) { deleteList(); }
+
+    void beginTransaction(void) override {}
+    void endTransaction(void) override {}
+    void setInvert(bool) override {}
+    void setSleep(bool) override {}
+    void setPowerSave(bool) override {}
+    void writeCommand(uint32_t, uint_fast8_t) override {}
+    void writeData(uint32_t, uint_fast8_t) override {}
+    void initDMA(void) override {}
+    void waitDMA(void) override {}
+    bool dmaBusy(void) override { return false; }
+    void waitDisplay(void) override {}
+    bool displayBusy(void) override { return false; }
+    void display(uint_fast16_t, uint_fast16_t, uint_fast16_t, uint_fast16_t) override {}
+    bool isReadable(void) const override { return false; }
+    bool isBusShared(void) const override { return false; }
+
+    uint32_t readCommand(uint_fast16_t, uint_fast8_t, uint_fast8_t) override { return 0; }
+    uint32_t readData(uint_fast8_t, uint_fast8_t) override { return 0; }
+
+    bool createList(int32_t w, int32_t h, bool psram);
+    void deleteList(void);
+    void clearList(void);
+
+    size_t listLength(void) const { return _length; }
+    uint32_t opCount(void) const { return _op_count; }
+
+    color_depth_t setColorDepth(color_depth_t depth) override;
+    void setRotation(uint_fast8_t r) override;
+
+    void setWindow(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye) override;
+    void drawPixelPreclipped(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor) override;
+    void writeFillRectPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor) override;
+    void writeFillRectAlphaPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t argb8888) override;
+    void writeBlock(uint32_t rawcolor, uint32_t len) override;
+    void writePixels(pixelcopy_t* param, uint32_t len, bool use_dma) override;
+    void writeImage(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param, bool use_dma) override;
+    void writeImageARGB(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param) override;
+
+    /// The list can not be read back. dst is filled with zero (black).
+    void readRect(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, void* dst, pixelcopy_t* param) override;
+    /// Not supported. (the source pixels do not exist until replayed)
+    void copyRect(uint_fast16_t, uint_fast16_t, uint_fast16_t, uint_fast16_t, uint_fast16_t, uint_fast16_t) override {}
+
+    /// Replays the operations that touch the rows band_y ~ band_y+band_h-1 into band.
+    /// band must have the same color depth as the list and be at least as wide as the list.
+    void replay(IPanel* band, int32_t band_y, int32_t band_h) const;
+
+  protected:
+    enum op_type_t : uint8_t
+    { op_fill        // value = raw color
+    , op_image       // payload = pixels in the list's color depth
+    , op_fill_alpha  // value = argb8888
+    , op_image_argb  // payload = blend function + 32bit source pixels
+    };
+
+    struct op_t
+    {
+      op_type_t type;
+      uint8_t reserved;
+      uint16_t x;
+      uint16_t y;
+      uint16_t w;
+      uint16_t h;
+      uint16_t reserved2;
+      uint32_t value;
+      uint32_t size;    // bytes from this op to the next op
+    };
+
+    typedef uint32_t (*fp_copy_t)(void*, uint32_t, uint32_t, pixelcopy_t*);
+    static constexpr size_t argb_header_size = (sizeof(fp_copy_t) + 7) & ~7u;
+
+    op_t* add_op(op_type_t type, uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t value, size_t payload);
+    bool reserve(size_t length);
+    void add_fill(op_type_t type, uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t value);
+    void add_image_row(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, const uint8_t* data);
+
+    uint8_t* _list = nullptr;
+    size_t _capacity = 0;
+    size_t _length = 0;
+    size_t _last = SIZE_MAX;   // offset of the last op (SIZE_MAX = can not be merged)
+    uint32_t _op_count = 0;
+
+    uint8_t* _row = nullptr;   // conversion buffer for one row
+    uint_fast16_t _xpos = 0;
+    uint_fast16_t _ypos = 0;
+    bool _psram = false;
+  };
+
+  /// Draws like a sprite, but keeps a list of the drawing operations instead of a frame buffer.
+  /// pushBands() renders the list into a strip buffer of a few rows and sends each band
+  /// to the destination with pushImageDMA, so a full screen frame is composed without tearing
+  /// using about two strips of RAM plus the size of the list.
+  ///
+  /// The operations are stored in the color depth of the list (8/16/24bit, no palette).
+  /// Filling the whole canvas (fillScreen / clear) drops the previously recorded operations.
+  /// Limitations : the list can not be read back (anti-aliased drawing that reads the background
+  /// blends against black), copyRect / scroll are ignored, and the rotation is fixed to 0.
+  class LGFX_DisplayList : public LovyanGFX
+  {
+  public:
+    /// band : a sprite that wraps the strip buffer. Its row 0 is row band_y of the list.
+    typedef void (*band_cb_t)(LovyanGFX* band, int32_t band_y, void* user);
+
+    LGFX_DisplayList(void)
+    {
+      _panel = &_panel_list;
+      setColorDepth(_write_conv.depth);
+    }
+
+    virtual ~LGFX_DisplayList(void) { deleteList(); }
+
+    void setPsram(bool enabled) { _psram = enabled; }
+
+    bool createList(int32_t w, int32_t h);
+    void deleteList(void);
+
+    /// Discards the recorded operations. The canvas size is kept.
+    void clearList(void) { _panel_list.clearList(); }
+
+    size_t listLength(void) const { return _panel_list.listLength(); }
+    uint32_t opCount(void) const { return _panel_list.opCount(); }
+
+    /// The callback is called for each band after the list has been replayed into it,
+    /// to draw things that are cheaper to generate per band than to record.
+    void setBandCallback(band_cb_t cb, void* user = nullptr) { _band_cb = cb; _band_user = user; }
+
+    /// Replays the list band by band and sends each band to dst with pushImageDMA.
+    /// @param band_height rows per band.
+    /// @param buffer_count 2 = double buffer (render the next band while the previous one is sent).
+    bool pushBands(LovyanGFX* dst, int32_t x = 0, int32_t y = 0, int32_t band_height = 16, uint_fast8_t buffer_count = 2);
+
+  protected:
+    Panel_DisplayList _panel_list;
+    band_cb_t _band_cb = nullptr;
+    void* _band_user = nullptr;
+    bool _psram = false;
+  };
+
+//----------------------------------------------------------------------------
+ }
+}
+
+using LGFX_DisplayList = lgfx::LGFX_DisplayList;
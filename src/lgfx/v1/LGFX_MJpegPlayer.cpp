@@ -0,0 +1,280 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+
+#include "LGFX_MJpegPlayer.hpp"
+
+#include "LGFXBase.hpp"
+#include "../utility/lgfx_tjpgd.h"
+
+#include <string.h>
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  bool LGFX_MJpegPlayer::begin(LGFXBase* dst, DataWrapper* src, uint32_t buffer_size)
+  {
+    end();
+    if (dst == nullptr || src == nullptr || buffer_size < 64) { return false; }
+    _buf = (uint8_t*)heap_alloc(buffer_size);
+    if (_buf == nullptr) { return false; }
+    _buf_size = buffer_size;
+    _buf_pos = 0;
+    _buf_len = 0;
+    _src_end = false;
+    _state = ps_done;
+    _gfx = dst;
+    _src = src;
+    _reader.player = this;
+    _reader.need_transaction = src->need_transaction;
+    dst->prepareTmpTransaction(&_reader);
+    _timing_started = false;
+    _frame_index = 0;
+    _frame_count = 0;
+    _skip_count = 0;
+    _last_info = {};
+    return true;
+  }
+
+  bool LGFX_MJpegPlayer::begin(LGFXBase* dst, const uint8_t* data, uint32_t length, uint32_t buffer_size)
+  {
+    _pointer_wrapper.set(data, length);
+    return begin(dst, &_pointer_wrapper, buffer_size);
+  }
+
+  void LGFX_MJpegPlayer::end(void)
+  {
+    if (_buf) { heap_free(_buf); }
+    _buf = nullptr;
+    _buf_size = 0;
+    _gfx = nullptr;
+    _src = nullptr;
+  }
+
+  bool LGFX_MJpegPlayer::fill_buffer(void)
+  {
+    if (_src_end) { return false; }
+    uint32_t remain = _buf_len - _buf_pos;
+    if (remain && _buf_pos) { memmove(_buf, &_buf[_buf_pos], remain); }
+    _buf_pos = 0;
+    _buf_len = remain;
+    int res = _src->read(&_buf[remain], _buf_size - remain);
+    if (res <= 0) { _src_end = true; return false; }
+    _buf_len += res;
+    return true;
+  }
+
+  bool LGFX_MJpegPlayer::find_soi(void)
+  {
+    for (;;)
+    {
+      uint32_t avail = _buf_len - _buf_pos;
+      if (avail < 2)
+      {
+        if (!fill_buffer()) { return false; }
+        continue;
+      }
+      auto p = &_buf[_buf_pos];
+      auto ff = (const uint8_t*)memchr(p, 0xFF, avail - 1);
+      if (ff == nullptr)
+      {
+        _buf_pos += avail - 1;
+        continue;
+      }
+      uint32_t i = ff - p;
+      if (ff[1] == 0xD8)
+      {
+        _buf_pos += i;
+        _state = ps_marker;
+        _sos = false;
+        _error = false;
+        _frame_pos = 0;
+        return true;
+      }
+      _buf_pos += i + 1;
+    }
+  }
+
+  void LGFX_MJpegPlayer::parse_marker(uint8_t id)
+  {
+    if (id == 0xFF) { _state = ps_marker_id; return; }  // fill byte
+    if (id == 0xD9) { _state = ps_done; return; }       // EOI
+    if (id == 0xD8 || id == 0x01 || (id >= 0xD0 && id <= 0xD7))
+    { // markers without a length field
+      _state = ps_marker;
+      return;
+    }
+    _sos = (id == 0xDA);
+    _state = ps_length_hi;
+  }
+
+  uint32_t LGFX_MJpegPlayer::consume(uint8_t* dst, uint32_t len)
+  {
+    uint32_t total = 0;
+    while (total < len && _state != ps_done)
+    {
+      if (_buf_pos == _buf_len && !fill_buffer()) { break; }
+      auto p = &_buf[_buf_pos];
+      uint32_t avail = _buf_len - _buf_pos;
+      if (avail > len - total) { avail = len - total; }
+      uint32_t i = 0;
+      do
+      {
+        switch (_state)
+        {
+        case ps_entropy:
+          {
+            auto ff = (const uint8_t*)memchr(&p[i], 0xFF, avail - i);
+            if (ff == nullptr) { i = avail; break; }
+            i = ff - p + 1;
+            _state = ps_entropy_ff;
+          }
+          break;
+
+        case ps_entropy_ff:
+          {
+            uint8_t c = p[i++];
+            if (c == 0x00 || (c >= 0xD0 && c <= 0xD7)) { _state = ps_entropy; } // stuffed byte or RSTn
+            else if (c != 0xFF) { parse_marker(c); }
+          }
+          break;
+
+        case ps_marker:
+          if (p[i++] != 0xFF) { _error = true; _state = ps_done; }
+          else { _state = ps_marker_id; }
+          break;
+
+        case ps_marker_id:
+          parse_marker(p[i++]);
+          break;
+
+        case ps_length_hi:
+          _seg_remain = p[i++] << 8;
+          _state = ps_length_lo;
+          break;
+
+        case ps_length_lo:
+          _seg_remain |= p[i++];
+          if (_seg_remain < 2) { _error = true; _state = ps_done; break; }
+          _seg_remain -= 2;
+          _state = _seg_remain ? ps_segment : (_sos ? ps_entropy : ps_marker);
+          break;
+
+        case ps_segment:
+          {
+            uint32_t n = avail - i;
+            if (n > _seg_remain) { n = _seg_remain; }
+            i += n;
+            _seg_remain -= n;
+            if (!_seg_remain) { _state = _sos ? ps_entropy : ps_marker; }
+          }
+          break;
+
+        default:
+          break;
+        }
+      } while (i < avail && _state != ps_done);
+
+      if (dst) { memcpy(&dst[total], p, i); }
+      total += i;
+      _buf_pos += i;
+      _frame_pos += i;
+    }
+    return total;
+  }
+
+  bool LGFX_MJpegPlayer::drain_frame(void)
+  {
+    while (_state != ps_done)
+    {
+      if (0 == consume(nullptr, ~0u)) { return false; }
+    }
+    return !_error;
+  }
+
+  int LGFX_MJpegPlayer::frame_reader_t::read(uint8_t *buf, uint32_t len)
+  {
+    return player->consume(buf, len);
+  }
+
+  void LGFX_MJpegPlayer::frame_reader_t::skip(int32_t offset)
+  {
+    if (offset > 0) { player->consume(nullptr, offset); }
+  }
+
+  bool LGFX_MJpegPlayer::drawNextFrame(frame_info_t* info)
+  {
+    if (_gfx == nullptr) { return false; }
+
+    frame_info_t fi = {};
+    _reader.preRead();
+
+    if (_period_us && !_timing_started)
+    {
+      _timing_started = true;
+      _due_us = lgfx::micros();
+    }
+
+    if (_period_us && _frame_skip)
+    { // more than one frame behind : drop frames without decoding them.
+      while ((int32_t)(lgfx::micros() - _due_us) > (int32_t)_period_us)
+      {
+        if (!find_soi() || !drain_frame()) { _reader.postRead(); return false; }
+        _due_us += _period_us;
+        ++_frame_index;
+        ++fi.skipped;
+      }
+      _skip_count += fi.skipped;
+    }
+
+    if (!find_soi()) { _reader.postRead(); return false; }
+
+    if (_period_us)
+    {
+      int32_t wait = _due_us - lgfx::micros();
+      if (wait > 0)
+      {
+        fi.idle_us = wait;
+        if (wait >= 1000) { lgfx::delay(wait / 1000); }
+        wait = _due_us - lgfx::micros();
+        if (wait > 0) { lgfx::delayMicroseconds(wait); }
+      }
+      _due_us += _period_us;
+    }
+
+    // the tables are kept for the next frame, and only the second and later frames of the stream take them over.
+    auto t = lgfx::micros();
+    bool res = _gfx->draw_jpg(&_reader, _x, _y, _max_w, _max_h, 0, 0, _scale_x, _scale_y, _datum, &fi.transfer_us, _frame_count ? JD_REUSE_TAKE : JD_REUSE_KEEP);
+    res = drain_frame() && res;
+    t = lgfx::micros() - t;
+    _reader.postRead();
+
+    fi.index = _frame_index++;
+    fi.length = _frame_pos;
+    fi.decode_us = (t > fi.transfer_us) ? t - fi.transfer_us : 0;
+    _last_info = fi;
+    if (info) { *info = fi; }
+    if (res) { ++_frame_count; }
+    return res;
+  }
+
+//----------------------------------------------------------------------------
+ }
+}
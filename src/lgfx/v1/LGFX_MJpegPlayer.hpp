@@ -0,0 +1,150 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#pragma once
+
+#include "misc/enum.hpp"
+#include "misc/DataWrapper.hpp"
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  class LGFXBase;
+
+  /// Plays a stream of concatenated JPEG frames (MJPEG, or the movi chunks of an AVI)
+  /// read from a DataWrapper. Frame boundaries are found by following the JPEG markers,
+  /// so any data between the frames (container headers, padding) is skipped.
+  class LGFX_MJpegPlayer
+  {
+  public:
+    struct frame_info_t
+    {
+      uint32_t index;        // index of the frame in the stream (counting skipped frames)
+      uint32_t length;       // bytes from SOI to EOI
+      uint32_t skipped;      // frames skipped just before this frame to hold the frame rate
+      uint32_t decode_us;    // time spent in decoding, excluding output
+      uint32_t transfer_us;  // time spent in writing the pixels to the destination
+      uint32_t idle_us;      // time waited before this frame to hold the frame rate
+    };
+
+    LGFX_MJpegPlayer(void) = default;
+    LGFX_MJpegPlayer(const LGFX_MJpegPlayer&) = delete;
+    LGFX_MJpegPlayer& operator=(const LGFX_MJpegPlayer&) = delete;
+    ~LGFX_MJpegPlayer(void) { end(); }
+
+    /// @param dst destination (LGFX_Device or LGFX_Sprite).
+    /// @param src stream to play. It must stay valid until end().
+    /// @param buffer_size size of the read buffer in bytes.
+    bool begin(LGFXBase* dst, DataWrapper* src, uint32_t buffer_size = 2048);
+    bool begin(LGFXBase* dst, const uint8_t* data, uint32_t length, uint32_t buffer_size = 2048);
+    void end(void);
+
+    void setPosition(int32_t x, int32_t y, datum_t datum = datum_t::top_left) { _x = x; _y = y; _datum = datum; }
+    void setClipSize(int32_t maxWidth, int32_t maxHeight) { _max_w = maxWidth; _max_h = maxHeight; }
+    void setScale(float scale_x, float scale_y = 0.0f) { _scale_x = scale_x; _scale_y = scale_y; }
+
+    /// @param fps target frame rate. 0 plays as fast as possible.
+    void setFrameRate(float fps) { _period_us = (fps > 0.0f) ? (uint32_t)(1000000.0f / fps) : 0; _timing_started = false; }
+    /// @param enable when the playback falls behind the frame rate, drop frames without decoding them.
+    void setFrameSkip(bool enable) { _frame_skip = enable; }
+
+    /// Decodes and draws the next frame. (waits for its turn when the frame rate is set)
+    /// @param info receives the statistics of the drawn frame. (nullable)
+    /// @return false at the end of the stream or on a decode error.
+    bool drawNextFrame(frame_info_t* info = nullptr);
+
+    uint32_t getFrameCount(void) const { return _frame_count; }
+    uint32_t getSkipCount(void) const { return _skip_count; }
+    const frame_info_t& getLastFrameInfo(void) const { return _last_info; }
+
+  private:
+    /// Hands out the bytes of one frame (SOI to EOI) from the buffered stream.
+    struct frame_reader_t : public DataWrapper
+    {
+      LGFX_MJpegPlayer* player = nullptr;
+
+      int read(uint8_t *buf, uint32_t len) override;
+      void skip(int32_t offset) override;
+      bool seek(uint32_t offset) override { (void)offset; return false; }
+      void close(void) override {}
+      int32_t tell(void) override { return player->_frame_pos; }
+    };
+
+    enum parse_state_t : uint8_t
+    { ps_marker
+    , ps_marker_id
+    , ps_length_hi
+    , ps_length_lo
+    , ps_segment
+    , ps_entropy
+    , ps_entropy_ff
+    , ps_done
+    };
+
+    bool find_soi(void);
+    bool fill_buffer(void);
+    void parse_marker(uint8_t id);
+    uint32_t consume(uint8_t* dst, uint32_t len);
+    bool drain_frame(void);
+
+    LGFXBase* _gfx = nullptr;
+    DataWrapper* _src = nullptr;
+    PointerWrapper _pointer_wrapper;
+    frame_reader_t _reader;
+
+    uint8_t* _buf = nullptr;
+    uint32_t _buf_size = 0;
+    uint32_t _buf_pos = 0;
+    uint32_t _buf_len = 0;
+    bool _src_end = false;
+
+    parse_state_t _state = ps_done;
+    uint16_t _seg_remain = 0;
+    bool _sos = false;
+    bool _error = false;
+    uint32_t _frame_pos = 0;
+
+    int32_t _x = 0;
+    int32_t _y = 0;
+    int32_t _max_w = 0;
+    int32_t _max_h = 0;
+    float _scale_x = 1.0f;
+    float _scale_y = 0.0f;
+    datum_t _datum = datum_t::top_left;
+
+    uint32_t _period_us = 0;
+    uint32_t _due_us = 0;
+    bool _timing_started = false;
+    bool _frame_skip = false;
+
+    uint32_t _frame_index = 0;
+    uint32_t _frame_count = 0;
+    uint32_t _skip_count = 0;
+    frame_info_t _last_info = {};
+  };
+
+//----------------------------------------------------------------------------
+ }
+}
+
+using LGFX_MJpegPlayer = lgfx::LGFX_MJpegPlayer;
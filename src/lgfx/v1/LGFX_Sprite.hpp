@@ -59,6 +59,7 @@ namespace lgfx
     void display(uint_fast16_t, uint_fast16_t, uint_fast16_t, uint_fast16_t) override {}
     bool isReadable(void) const override { return true; }
     bool isBusShared(void) const override { return false; }
+    bool isFrameBuffer(void) const override { return true; }
 
     uint32_t readCommand(uint_fast16_t, uint_fast8_t, uint_fast8_t) override { return 0; }
     uint32_t readData(uint_fast8_t, uint_fast8_t) override { return 0; }
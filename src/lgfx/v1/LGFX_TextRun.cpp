@@ -0,0 +1,303 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+
+#include "LGFX_TextRun.hpp"
+
+#include "LGFX_Sprite.hpp"
+
+#include <string.h>
+#include <algorithm>
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  void LGFX_TextRun::release(void)
+  {
+    if (_glyphs)
+    {
+      heap_free(_glyphs);
+      _glyphs = nullptr;
+    }
+    _count = 0;
+    _capacity = 0;
+  }
+
+  LGFX_TextRun::glyph_t* LGFX_TextRun::add_glyph(void)
+  {
+    if (_count == _capacity)
+    {
+      size_t capacity = _capacity ? _capacity * 2 : 16;
+      auto glyphs = (glyph_t*)heap_alloc(capacity * sizeof(glyph_t));
+      if (glyphs == nullptr) { return nullptr; }
+      if (_glyphs)
+      {
+        memcpy(glyphs, _glyphs, _count * sizeof(glyph_t));
+        heap_free(_glyphs);
+      }
+      _glyphs = glyphs;
+      _capacity = capacity;
+    }
+    return &_glyphs[_count++];
+  }
+
+  bool LGFX_TextRun::prepare(const LGFXBase* gfx, const char* string, const IFont* font)
+  {
+    _count = 0;
+    if (font == nullptr) { font = gfx->getFont(); }
+    _font = font;
+    if (font == nullptr) { return false; }
+    font->getDefaultMetric(&_metrics);
+    _emoji = (gfx->getEmojiCallback() != nullptr);
+    if (string == nullptr) { return true; }
+
+    bool utf8 = gfx->getTextStyle().utf8;
+    auto metrics = _metrics;
+    uint32_t unicode_buffer = 0;
+    uint_fast8_t decoder_state = 0;
+    uint8_t flags = 0;
+    for (; *string; ++string)
+    {
+      uint32_t uniCode = *string;
+      if (utf8)
+      { // LGFXBase::decodeUTF8 と同じ規則で復号する
+        uint8_t c = *string;
+        uniCode = c;
+        if (c & 0x80)
+        {
+          if (decoder_state)
+          {
+            --decoder_state;
+            unicode_buffer |= (c & 0x3F) << (6 * decoder_state);
+            if (decoder_state) { continue; }
+            uniCode = unicode_buffer;
+          }
+          else if ((c & 0xE0) == 0xC0) { unicode_buffer = (c & 0x1F) << 6;  decoder_state = 1; continue; }
+          else if ((c & 0xF0) == 0xE0) { unicode_buffer = (c & 0x0F) << 12; decoder_state = 2; continue; }
+          else if ((c & 0xF8) == 0xF0) { unicode_buffer = (c & 0x07) << 18; decoder_state = 3; continue; }
+        }
+        else
+        {
+          decoder_state = 0;
+        }
+        if (uniCode < 0x20)
+        {
+          if (uniCode == '\n') { flags |= flag_newline; }
+          continue;
+        }
+      }
+      if ((uniCode >= 0xFE00) && (uniCode < 0xFE10)) continue;
+
+      auto glyph = add_glyph();
+      if (glyph == nullptr) { return false; }
+      glyph->flags = flags;
+      flags = 0;
+      if (uniCode > 0xFFFF || (!font->updateFontMetric(&metrics, uniCode) && uniCode != 0))
+      {
+        if (_emoji)
+        {
+          glyph->flags |= flag_emoji;
+          metrics.width     = metrics.height;
+          metrics.x_advance = metrics.height;
+          metrics.x_offset  = 0;
+        }
+        else
+        {
+          uniCode = 0;
+          font->updateFontMetric(&metrics, uniCode);
+        }
+      }
+      glyph->code      = uniCode;
+      glyph->width     = metrics.width;
+      glyph->x_advance = metrics.x_advance;
+      glyph->x_offset  = metrics.x_offset;
+    }
+    return true;
+  }
+
+  int32_t LGFX_TextRun::textWidth(const LGFXBase* gfx, size_t start, size_t count) const
+  {
+    if (start >= _count) { return 0; }
+    count = std::min(count, _count - start);
+
+    int32_t sx = 65536 * gfx->getTextSizeX();
+    int32_t left = 0;
+    int32_t right = 0;
+    for (auto glyph = &_glyphs[start], end = glyph + count; glyph != end; ++glyph)
+    {
+      int32_t sxoffset = (glyph->x_offset * sx) >> 16;
+      if (left == 0 && right == 0 && glyph->x_offset < 0) left = right = - sxoffset;
+      int32_t sxadvance = (glyph->x_advance * sx) >> 16;
+      right = left + std::max<int>(sxadvance, ((glyph->width * sx) >> 16) + sxoffset);
+      left += sxadvance;
+    }
+    return right;
+  }
+
+  size_t LGFX_TextRun::lineBreak(const LGFXBase* gfx, size_t start, int32_t max_width) const
+  {
+    if (start >= _count) { return 0; }
+
+    int32_t sx = 65536 * gfx->getTextSizeX();
+    int32_t left = 0;
+    int32_t right = 0;
+    size_t last_space = 0;
+    for (size_t i = start; i < _count; ++i)
+    {
+      auto glyph = &_glyphs[i];
+      if (i != start && (glyph->flags & flag_newline)) { return i - start; }
+      int32_t sxoffset = (glyph->x_offset * sx) >> 16;
+      if (left == 0 && right == 0 && glyph->x_offset < 0) left = right = - sxoffset;
+      int32_t sxadvance = (glyph->x_advance * sx) >> 16;
+      right = left + std::max<int>(sxadvance, ((glyph->width * sx) >> 16) + sxoffset);
+      if (right > max_width && i != start)
+      {
+        if (glyph->code == 0x20) { return i - start + 1; }
+        return last_space ? last_space : i - start;
+      }
+      left += sxadvance;
+      if (glyph->code == 0x20) { last_space = i - start + 1; }
+    }
+    return _count - start;
+  }
+
+  textdatum_t LGFX_TextRun::gfx_datum(const LGFXBase* gfx)
+  {
+    return gfx->getTextDatum();
+  }
+
+  size_t LGFX_TextRun::draw_string(LGFXBase* gfx, int32_t x, int32_t y, size_t start, size_t count, textdatum_t datum) const
+  {
+    if (_font == nullptr) { return 0; }
+    if (start >= _count) { count = 0; }
+    else { count = std::min(count, _count - start); }
+
+    auto& style = gfx->getTextStyle();
+    auto metrics = _metrics;
+    int16_t sumX = 0;
+    int32_t cwidth = textWidth(gfx, start, count);
+    int32_t sy = 65536 * style.size_y;
+    int32_t cheight = (metrics.height * sy) >> 16;
+
+    if (gfx->getTextBuffered())
+    {
+      struct draw_arg_t { const LGFX_TextRun* run; size_t start; size_t count; textdatum_t datum; };
+      draw_arg_t arg = { this, start, count, datum };
+      size_t res;
+      if (gfx->draw_string_strip(x, y, datum, cwidth, metrics, [](LGFXBase* strip, int32_t x, int32_t y, void* arg) -> size_t
+        {
+          auto a = (draw_arg_t*)arg;
+          return a->run->draw_string(strip, x, y, a->start, a->count, a->datum);
+        }, &arg, &res))
+      {
+        return res;
+      }
+    }
+
+    if (count && _glyphs[start].x_offset < 0)
+    {
+      int32_t sx = 65536 * style.size_x;
+      sumX = - (_glyphs[start].x_offset * sx) >> 16;
+    }
+
+    if (datum & middle_left) {          // vertical: middle
+      y -= cheight >> 1;
+    } else if (datum & bottom_left) {   // vertical: bottom
+      y -= cheight;
+    } else if (datum & baseline_left) { // vertical: baseline
+      y -= (metrics.baseline * sy) >> 16;
+    }
+
+    gfx->startWrite();
+    int32_t padx = style.padding_x;
+    if ((style.fore_rgb888 != style.back_rgb888) && (padx > cwidth)) {
+      gfx->setColor(style.back_rgb888);
+      if (datum & top_center) {
+        auto halfcwidth = cwidth >> 1;
+        auto halfpadx = (padx >> 1);
+        gfx->writeFillRect(x - halfpadx, y, halfpadx - halfcwidth, cheight);
+        halfcwidth = cwidth - halfcwidth;
+        halfpadx = padx - halfpadx;
+        gfx->writeFillRect(x + halfcwidth, y, halfpadx - halfcwidth, cheight);
+      } else if (datum & top_right) {
+        gfx->writeFillRect(x - padx, y, padx - cwidth, cheight);
+      } else {
+        gfx->writeFillRect(x + cwidth, y, padx - cwidth, cheight);
+      }
+    }
+
+    if (datum & top_center) {           // Horizontal: middle
+      x -= cwidth >> 1;
+    } else if (datum & top_right) {     // Horizontal: right
+      x -= cwidth;
+    }
+
+    y -= (metrics.y_offset * sy) >> 16;
+
+    int32_t dummy_filled_x = 0;
+    for (auto glyph = &_glyphs[start], end = glyph + count; glyph != end; ++glyph)
+    {
+      uint32_t uniCode = glyph->code;
+      bool drawn = false;
+      if (glyph->flags & flag_emoji)
+      {
+        if (auto cb = gfx->getEmojiCallback())
+        {
+          int32_t ew = cb(gfx, x + sumX, y, uniCode, (metrics.height * sy) >> 16);
+          if (ew > 0) { sumX += ew; drawn = true; }
+        }
+        if (!drawn) uniCode = 0;
+      }
+      if (!drawn) {
+        sumX += _font->drawChar(gfx, x + sumX, y, uniCode, &style, &metrics, dummy_filled_x);
+      }
+    }
+    gfx->endWrite();
+
+    return sumX;
+  }
+
+  size_t LGFX_TextRun::drawWrapped(LGFXBase* gfx, int32_t x, int32_t y, int32_t max_width, int32_t line_height) const
+  {
+    if (line_height <= 0)
+    {
+      int32_t sy = 65536 * gfx->getTextSizeY();
+      line_height = (_metrics.y_advance * sy) >> 16;
+    }
+    auto datum = gfx->getTextDatum();
+    size_t lines = 0;
+    size_t pos = 0;
+    while (pos < _count)
+    {
+      size_t len = lineBreak(gfx, pos, max_width);
+      if (len == 0) { break; }
+      size_t draw_len = len;
+      while (draw_len && _glyphs[pos + draw_len - 1].code == 0x20) { --draw_len; }
+      draw_string(gfx, x, y, pos, draw_len, datum);
+      y += line_height;
+      pos += len;
+      ++lines;
+    }
+    return lines;
+  }
+
+//----------------------------------------------------------------------------
+ }
+}
@@ -0,0 +1,110 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#pragma once
+
+#include "lgfx_fonts.hpp"
+#include "misc/enum.hpp"
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  class LGFXBase;
+
+  /// A string decoded once, with the metric of every glyph looked up once.
+  /// drawString() gives the same result as LGFXBase::drawString with the same text style,
+  /// but does not decode the string nor call updateFontMetric again, so a label that is
+  /// redrawn every frame only pays for drawing the glyphs.
+  ///
+  /// The run keeps a pointer to the font. It must be prepared again after the font is
+  /// unloaded, or after the text size or the emoji callback of gfx is changed.
+  class LGFX_TextRun
+  {
+  public:
+    struct glyph_t
+    {
+      uint32_t code;      // code passed to drawChar (0 = not found in the font)
+      int16_t width;      // metric returned by updateFontMetric (unscaled)
+      int16_t x_advance;
+      int16_t x_offset;
+      uint8_t flags;
+      uint8_t reserved;
+    };
+
+    enum glyph_flag_t : uint8_t
+    { flag_emoji   = 1  // drawn by the emoji callback
+    , flag_newline = 2  // a line feed precedes this glyph
+    };
+
+    LGFX_TextRun(void) = default;
+    LGFX_TextRun(const LGFX_TextRun&) = delete;
+    LGFX_TextRun& operator=(const LGFX_TextRun&) = delete;
+    ~LGFX_TextRun(void) { release(); }
+
+    /// Decodes string with the text style of gfx and looks up the metrics.
+    /// @param font nullptr = the current font of gfx.
+    bool prepare(const LGFXBase* gfx, const char* string, const IFont* font = nullptr);
+    void clear(void) { _count = 0; }
+    void release(void);
+
+    size_t length(void) const { return _count; }
+    const glyph_t* glyphs(void) const { return _glyphs; }
+    const IFont* getFont(void) const { return _font; }
+    const FontMetrics& getMetrics(void) const { return _metrics; }
+
+    /// Width of glyphs [start, start+count) in pixels, same as LGFXBase::textWidth.
+    int32_t textWidth(const LGFXBase* gfx, size_t start = 0, size_t count = SIZE_MAX) const;
+
+    /// Number of glyphs from start that fit in max_width. The line breaks after the last
+    /// space that fits, or at a line feed. A word wider than max_width is split.
+    size_t lineBreak(const LGFXBase* gfx, size_t start, int32_t max_width) const;
+
+    /// Draws glyphs [start, start+count) with the text datum, colors and padding of gfx.
+    /// Follows gfx->setTextBuffered() like LGFXBase::drawString.
+    /// @return width of the drawn text.
+    size_t drawString(LGFXBase* gfx, int32_t x, int32_t y, size_t start = 0, size_t count = SIZE_MAX) const { return draw_string(gfx, x, y, start, count, gfx_datum(gfx)); }
+    size_t drawString(LGFXBase* gfx, int32_t x, int32_t y, textdatum_t datum, size_t start = 0, size_t count = SIZE_MAX) const { return draw_string(gfx, x, y, start, count, datum); }
+
+    /// Draws the run in lines of at most max_width pixels, line_height pixels apart.
+    /// @param line_height 0 = the height of the font.
+    /// @return number of lines drawn.
+    size_t drawWrapped(LGFXBase* gfx, int32_t x, int32_t y, int32_t max_width, int32_t line_height = 0) const;
+
+  private:
+    static textdatum_t gfx_datum(const LGFXBase* gfx);
+    size_t draw_string(LGFXBase* gfx, int32_t x, int32_t y, size_t start, size_t count, textdatum_t datum) const;
+    glyph_t* add_glyph(void);
+
+    glyph_t* _glyphs = nullptr;
+    size_t _count = 0;
+    size_t _capacity = 0;
+    const IFont* _font = nullptr;
+    FontMetrics _metrics = {};
+    bool _emoji = false;  // the emoji callback was set when prepared
+  };
+
+//----------------------------------------------------------------------------
+ }
+}
+
+using LGFX_TextRun = lgfx::LGFX_TextRun;
@@ -0,0 +1,252 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+
+#include "LGFX_TouchEngine.hpp"
+
+#include "LGFXBase.hpp"
+
+#include <math.h>
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  bool LGFX_GestureRecognizer::feed(const touch_event_t& event, gesture_t* result)
+  {
+    if (event.count == 0)
+    {
+      auto prev = _state;
+      _state = state_idle;
+      if (prev != state_single) { return false; }
+
+      uint32_t duration = event.msec - _start_msec;
+      int32_t dx = _last_x - _start_x;
+      int32_t dy = _last_y - _start_y;
+      gesture_type_t type = gesture_none;
+      if (!_moved)
+      {
+        if (duration <= _cfg.tap_msec) { type = gesture_tap; }
+      }
+      else if (duration <= _cfg.swipe_msec
+            && (dx * dx + dy * dy) >= (int32_t)_cfg.swipe_distance * _cfg.swipe_distance)
+      {
+        type = gesture_swipe;
+      }
+      if (type == gesture_none) { return false; }
+      result->type = type;
+      result->x = _start_x;
+      result->y = _start_y;
+      result->dx = dx;
+      result->dy = dy;
+      result->scale = 1.0f;
+      result->msec = event.msec;
+      result->duration = duration;
+      return true;
+    }
+
+    int16_t x = event.point[0].x;
+    int16_t y = event.point[0].y;
+    if (_state == state_idle)
+    {
+      _start_msec = event.msec;
+      _start_x = _last_x = x;
+      _start_y = _last_y = y;
+      _moved = false;
+      _state = state_single;
+    }
+
+    if (event.count >= 2)
+    {
+      int32_t cx = (x + event.point[1].x) >> 1;
+      int32_t cy = (y + event.point[1].y) >> 1;
+      float fx = event.point[1].x - x;
+      float fy = event.point[1].y - y;
+      float distance = sqrtf(fx * fx + fy * fy);
+      if (_state != state_pinch)
+      {
+        _state = state_pinch;
+        _pinch_distance = distance;
+        _pinch_reported = 1.0f;
+        return false;
+      }
+      if (_pinch_distance <= 0.0f)
+      { // 指が同じ位置から始まった場合は、離れた時点を基準にする;
+        _pinch_distance = distance;
+        return false;
+      }
+      float scale = distance / _pinch_distance;
+      if (fabsf(scale - _pinch_reported) < _cfg.pinch_step * _pinch_reported) { return false; }
+      _pinch_reported = scale;
+      result->type = gesture_pinch;
+      result->x = cx;
+      result->y = cy;
+      result->dx = 0;
+      result->dy = 0;
+      result->scale = scale;
+      result->msec = event.msec;
+      result->duration = event.msec - _start_msec;
+      return true;
+    }
+
+    if (_state != state_single)
+    { // ピンチ中に片方の指が離れた場合は、全ての指が離れるまで何もしない;
+      _state = state_done;
+      return false;
+    }
+
+    _last_x = x;
+    _last_y = y;
+    if (!_moved)
+    {
+      int32_t dx = x - _start_x;
+      int32_t dy = y - _start_y;
+      if ((dx * dx + dy * dy) > (int32_t)_cfg.move_threshold * _cfg.move_threshold)
+      {
+        _moved = true;
+      }
+      else if ((event.msec - _start_msec) >= _cfg.long_press_msec)
+      {
+        _state = state_done;
+        result->type = gesture_long_press;
+        result->x = _start_x;
+        result->y = _start_y;
+        result->dx = 0;
+        result->dy = 0;
+        result->scale = 1.0f;
+        result->msec = event.msec;
+        result->duration = event.msec - _start_msec;
+        return true;
+      }
+    }
+    return false;
+  }
+
+//----------------------------------------------------------------------------
+
+  bool LGFX_TouchEngine::init(LGFX_Device* gfx)
+  {
+    release();
+    size_t length = 2;
+    while (length < _cfg.queue_length && length < 32768) { length <<= 1; }
+    _queue = (touch_event_t*)heap_alloc(length * sizeof(touch_event_t));
+    if (_queue == nullptr) { return false; }
+    _mask = length - 1;
+    _gfx = gfx;
+    _head.store(0, std::memory_order_relaxed);
+    _tail.store(0, std::memory_order_relaxed);
+    _drop_count.store(0, std::memory_order_relaxed);
+    _notified.store(false, std::memory_order_relaxed);
+    _sample_count = 0;
+    _last_count = 0;
+    _sampled = false;
+    _gesture.reset();
+    return true;
+  }
+
+  void LGFX_TouchEngine::release(void)
+  {
+    _gfx = nullptr;
+    if (_queue)
+    {
+      heap_free(_queue);
+      _queue = nullptr;
+    }
+  }
+
+  bool LGFX_TouchEngine::push(const touch_event_t& event)
+  {
+    uint16_t head = _head.load(std::memory_order_relaxed);
+    if ((uint16_t)(head - _tail.load(std::memory_order_acquire)) > _mask)
+    {
+      _drop_count.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    _queue[head & _mask] = event;
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool LGFX_TouchEngine::update(void)
+  {
+    return update(lgfx::millis());
+  }
+
+  bool LGFX_TouchEngine::update(uint32_t msec)
+  {
+    if (_queue == nullptr || _gfx == nullptr) { return false; }
+    auto touch = _gfx->touch();
+    if (touch == nullptr) { return false; }
+
+    bool notified = _notified.exchange(false, std::memory_order_relaxed);
+    if (!notified && _sampled)
+    {
+      uint32_t interval = _last_count ? _cfg.poll_msec : _cfg.idle_msec;
+      if (interval == 0 && _last_count == 0) { return false; }
+      if ((msec - _last_msec) < interval) { return false; }
+    }
+
+    if (!notified && _last_count == 0 && _cfg.use_pin_int)
+    { // 離れている間は、INTピンがタッチを示していなければバスを使わない;
+      int pin = touch->config().pin_int;
+      if (pin >= 0 && (bool)lgfx::gpio_in(pin) != _cfg.pin_int_active)
+      {
+        _last_msec = msec;
+        _sampled = true;
+        return false;
+      }
+    }
+
+    touch_event_t event;
+    event.msec = msec;
+    event.count = _gfx->getTouch(event.point, touch_event_t::max_points);
+    ++_sample_count;
+    _last_msec = msec;
+    _sampled = true;
+
+    if (event.count == 0 && _last_count == 0) { return false; }
+    if (event.count > touch_event_t::max_points) { event.count = touch_event_t::max_points; }
+    bool res = push(event);
+    // 離した時のイベントが入らなかった場合は、次回の update で再度試みる;
+    if (res || event.count) { _last_count = event.count; }
+    return res;
+  }
+
+  bool LGFX_TouchEngine::readEvent(touch_event_t* event)
+  {
+    uint16_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail == _head.load(std::memory_order_acquire)) { return false; }
+    *event = _queue[tail & _mask];
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool LGFX_TouchEngine::readGesture(gesture_t* result)
+  {
+    touch_event_t event;
+    while (readEvent(&event))
+    {
+      if (_gesture.feed(event, result)) { return true; }
+    }
+    return false;
+  }
+
+//----------------------------------------------------------------------------
+ }
+}
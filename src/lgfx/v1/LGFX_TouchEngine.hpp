@@ -0,0 +1,185 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#pragma once
+
+#include "Touch.hpp"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  class LGFX_Device;
+
+  enum gesture_type_t : uint8_t
+  { gesture_none
+  , gesture_tap
+  , gesture_long_press
+  , gesture_swipe
+  , gesture_pinch
+  };
+
+  struct gesture_t
+  {
+    gesture_type_t type = gesture_none;
+    int16_t x = 0;        // tap / long_press : position,  swipe : start position,  pinch : center
+    int16_t y = 0;
+    int16_t dx = 0;       // swipe : end - start
+    int16_t dy = 0;
+    float scale = 1.0f;   // pinch : distance / distance at the start of the pinch
+    uint32_t msec = 0;    // time of the event that completed the gesture
+    uint32_t duration = 0;// time since the first touch
+  };
+
+//----------------------------------------------------------------------------
+
+  /// タッチイベント列からタップ・長押し・スワイプ・ピンチを判定する。;
+  /// Recognizes gestures from a sequence of touch events. It keeps no time source of its own,
+  /// so the same event sequence always gives the same gestures.
+  class LGFX_GestureRecognizer
+  {
+  public:
+    struct config_t
+    {
+      uint16_t tap_msec = 250;         // longest touch that counts as a tap
+      uint16_t long_press_msec = 600;  // touch held this long without moving is a long press
+      uint16_t move_threshold = 10;    // moves shorter than this (pixel) are ignored for tap and long press
+      uint16_t swipe_distance = 40;    // shortest swipe (pixel)
+      uint16_t swipe_msec = 500;       // longest swipe
+      float pinch_step = 0.05f;        // a pinch is reported each time the scale changes this much
+    };
+
+    config_t config(void) const { return _cfg; }
+    void config(const config_t& cfg) { _cfg = cfg; }
+
+    /// @return true if a gesture was recognized and stored in result.
+    bool feed(const touch_event_t& event, gesture_t* result);
+    void reset(void) { _state = state_idle; }
+
+  private:
+    enum state_t : uint8_t
+    { state_idle
+    , state_single
+    , state_pinch
+    , state_done   // gesture already reported, waiting for the release
+    };
+
+    config_t _cfg;
+    state_t _state = state_idle;
+    bool _moved = false;
+    int16_t _start_x = 0;
+    int16_t _start_y = 0;
+    int16_t _last_x = 0;
+    int16_t _last_y = 0;
+    uint32_t _start_msec = 0;
+    float _pinch_distance = 0;   // distance at the start of the pinch
+    float _pinch_reported = 1.0f;
+  };
+
+//----------------------------------------------------------------------------
+
+  /// タッチの読取りを描画ループから切り離すためのサンプリングエンジン。;
+  /// update() samples the touch panel of gfx and stores timestamped events in a ring buffer.
+  /// The ring buffer is lock-free for one producer and one consumer, so the UI can read the
+  /// events with readEvent() / readGesture() on another task than the one that calls update().
+  ///
+  /// update() reads the touch controller over its bus.  When the touch shares the bus with the
+  /// panel (touch config bus_shared, e.g. XPT2046 on the SPI of the LCD), call update() only
+  /// from the task that draws: the bus is released for the read only when that task is inside
+  /// startWrite, and a read from another task would collide with a running transfer.
+  /// A touch controller on its own bus (I2C, or a separate SPI) can be sampled from any task.
+  ///
+  /// While nothing is touched, the touch controller is read only every idle_msec, only when
+  /// pin_int shows a touch, or right after notify() was called (e.g. from the pin_int interrupt).
+  /// While touched, it is read every poll_msec and an event is stored for every sample.
+  class LGFX_TouchEngine
+  {
+  public:
+    struct config_t
+    {
+      uint16_t poll_msec = 10;      // sampling interval while touched
+      uint16_t idle_msec = 20;      // sampling interval while released (0 = only after notify())
+      uint16_t queue_length = 32;   // rounded up to a power of 2
+      bool use_pin_int = true;      // skip the bus access while pin_int shows no touch
+      bool pin_int_active = false;  // level of pin_int while touched
+    };
+
+    LGFX_TouchEngine(void) = default;
+    LGFX_TouchEngine(const LGFX_TouchEngine&) = delete;
+    LGFX_TouchEngine& operator=(const LGFX_TouchEngine&) = delete;
+    ~LGFX_TouchEngine(void) { release(); }
+
+    config_t config(void) const { return _cfg; }
+    void config(const config_t& cfg) { _cfg = cfg; }
+
+    LGFX_GestureRecognizer& gesture(void) { return _gesture; }
+
+    bool init(LGFX_Device* gfx);
+    void release(void);
+
+    /// Samples the touch panel if the interval has passed.  Producer side.
+    /// Call it from the drawing task if the touch shares the bus with the panel.
+    /// @return true if an event was stored.
+    bool update(void);
+    bool update(uint32_t msec);
+
+    /// Requests a sample at the next update().  Safe to call from an interrupt handler.
+    void notify(void) { _notified.store(true, std::memory_order_relaxed); }
+
+    /// Consumer side.
+    bool readEvent(touch_event_t* event);
+    size_t available(void) const { return (uint16_t)(_head.load(std::memory_order_acquire) - _tail.load(std::memory_order_relaxed)); }
+    void clear(void) { _tail.store(_head.load(std::memory_order_acquire), std::memory_order_release); _gesture.reset(); }
+
+    /// Reads events until a gesture is recognized.  The events read are consumed.
+    bool readGesture(gesture_t* result);
+
+    /// Number of events dropped because the queue was full.
+    uint32_t getDropCount(void) const { return _drop_count.load(std::memory_order_relaxed); }
+    /// Number of times the touch controller was read.
+    uint32_t getSampleCount(void) const { return _sample_count; }
+
+  private:
+    bool push(const touch_event_t& event);
+
+    config_t _cfg;
+    LGFX_Device* _gfx = nullptr;
+    touch_event_t* _queue = nullptr;
+    uint16_t _mask = 0;
+    std::atomic<uint16_t> _head { 0 };
+    std::atomic<uint16_t> _tail { 0 };
+    std::atomic<bool> _notified { false };
+    std::atomic<uint32_t> _drop_count { 0 };
+    uint32_t _sample_count = 0;
+    uint32_t _last_msec = 0;
+    uint8_t _last_count = 0;
+    bool _sampled = false;
+    LGFX_GestureRecognizer _gesture;
+  };
+
+//----------------------------------------------------------------------------
+ }
+}
+
+using LGFX_TouchEngine = lgfx::LGFX_TouchEngine;
+using LGFX_GestureRecognizer = lgfx::LGFX_GestureRecognizer;
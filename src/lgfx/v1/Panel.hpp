@@ -123,6 +123,8 @@ namespace lgfx
     virtual void display(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h) = 0;
     virtual bool isReadable(void) const = 0;
     virtual bool isBusShared(void) const = 0;
+    /// true if the pixels are in memory, so that many small writeImage calls cost no bus transfers.
+    virtual bool isFrameBuffer(void) const { return false; }
 
     virtual void writeBlock(uint32_t rawcolor, uint32_t len) = 0;
     virtual void setWindow(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye) = 0;
@@ -141,6 +143,16 @@ namespace lgfx
     /// @return -1=unsupported. / 0~height= current scanline position.
     virtual int32_t getScanLine(void) { return -1; }
 
+    /// Calls func(arg, y, h) for horizontal bands of the rectangle x, y, w, h, in parallel if the panel supports it.
+    /// func may only call drawPixelPreclipped / writeFillRectPreclipped / writeImage for the rows of its band.
+    /// @return false if not supported. The caller then draws the rows by itself.
+    virtual bool writeBands(uint_fast16_t, uint_fast16_t, uint_fast16_t, uint_fast16_t, void (*)(void* arg, int32_t y, int32_t h), void*) { return false; }
+
+    /// Moves the image of the full-width rows y ~ y+h-1 by dy rows inside the panel (hardware scroll).
+    /// Later drawing is remapped, so coordinates keep pointing at the same place on the screen.
+    /// @return false if not supported. The caller then copies the pixels.
+    virtual bool scrollVertical(uint_fast16_t, uint_fast16_t, int_fast16_t) { return false; }
+
     virtual void writeFillRectAlphaPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t argb8888)
     {
       effect(x, y, w, h, effect_fill_alpha ( argb8888_t { argb8888 } ) );
@@ -34,6 +34,16 @@ namespace lgfx
     uint16_t id   = 0;
   };
 
+  /// touch points sampled at one time. used by LGFX_TouchEngine and Touch_Replay.
+  struct touch_event_t
+  {
+    static constexpr size_t max_points = 2;
+
+    uint32_t msec = 0;   // sampling time
+    uint8_t count = 0;   // number of touched points (0 = released)
+    touch_point_t point[max_points];  // panel coordinates (same as LGFXBase::getTouch)
+  };
+
 //----------------------------------------------------------------------------
 
   struct ITouch
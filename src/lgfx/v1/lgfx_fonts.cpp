@@ -15,7 +15,6 @@
 #include <stddef.h>
 #include <math.h>
 #include <string.h>
-#include <vector>
 #include "../internal/algorithm.h"
 
 #ifdef min
@@ -591,6 +590,79 @@ label_nextbyte: /// 次のデータを取得する;
     return nullptr;
   }
 
+  void IndexedU8g2font::release(void)
+  {
+    if (_index)
+    {
+      heap_free(_index);
+      _index = nullptr;
+    }
+    _count = 0;
+  }
+
+  bool IndexedU8g2font::build(void)
+  {
+    release();
+    const uint8_t* unicode_lut = &_font[23] + start_pos_unicode();
+    // 最初のブロックの位置からUnicodeのグリフが終端まで連続して並んでいる;
+    const uint8_t* first = unicode_lut + ((pgm_read_byte(&unicode_lut[0]) << 8) + pgm_read_byte(&unicode_lut[1]));
+
+    uint32_t glyphs = 0;
+    for (auto font = first; (pgm_read_byte(&font[0]) << 8) + pgm_read_byte(&font[1]); font += pgm_read_byte(&font[2]))
+    {
+      ++glyphs;
+    }
+    uint32_t count = (glyphs + _step - 1) / _step;
+    if (count == 0) { return false; }
+
+    // 確保できなければ索引を使わない;
+    auto index = (uint32_t*)heap_alloc(count * (sizeof(uint32_t) + sizeof(uint16_t)));
+    if (index == nullptr) { return false; }
+
+    auto codes = (uint16_t*)&index[count];
+    uint32_t i = 0;
+    uint32_t n = 0;
+    for (auto font = first; i < count; font += pgm_read_byte(&font[2]))
+    {
+      if (n == 0)
+      {
+        index[i] = font - _font;
+        codes[i] = (pgm_read_byte(&font[0]) << 8) + pgm_read_byte(&font[1]);
+        ++i;
+        n = _step;
+      }
+      --n;
+    }
+    _index = index;
+    _count = count;
+    return true;
+  }
+
+  const uint8_t* IndexedU8g2font::getGlyph(uint16_t encoding) const
+  {
+    if (encoding <= 255 || _index == nullptr) { return U8g2font::getGlyph(encoding); }
+
+    auto codes = (const uint16_t*)&_index[_count];
+    if (encoding < codes[0]) { return nullptr; }
+
+    uint32_t lo = 0;
+    uint32_t hi = _count;
+    while (hi - lo > 1)
+    {
+      uint32_t mid = (lo + hi) >> 1;
+      if (codes[mid] <= encoding) { lo = mid; }
+      else                        { hi = mid; }
+    }
+
+    const uint8_t* font = &_font[_index[lo]];
+    uint_fast16_t e;
+    for (uint_fast8_t i = _step; i && 0 != (e = (pgm_read_byte(&font[0]) << 8) + pgm_read_byte(&font[1])); --i, font += pgm_read_byte(&font[2]))
+    {
+      if ( e == encoding ) { return font + 3; }  /* skip encoding and glyph size */
+    }
+    return nullptr;
+  }
+
   void U8g2font::getDefaultMetric(lgfx::FontMetrics *metrics) const
   {
     metrics->height    = max_char_height();
@@ -901,71 +973,30 @@ label_nextbyte: /// 次のデータを取得する;
     return xAdvance;
   }
 
-  size_t LVGLfont::drawChar(LGFXBase* gfx, int32_t x, int32_t y, uint16_t uniCode, const TextStyle* style, FontMetrics* metrics, int32_t& filled_x) const
+  const uint8_t* LVGLfont::decodeGlyph(LGFXBase* gfx, lv_font_glyph_dsc_t* gd, uint32_t* stride) const
   {
-    if (_font == nullptr || _font->get_glyph_dsc == nullptr || _font->get_glyph_bitmap == nullptr)
-    {
-      return drawCharDummy(gfx, x, y, metrics->x_advance, metrics->height, style, filled_x);
-    }
-
-    int32_t sy = 65536 * style->size_y;
-    int32_t sx = 65536 * style->size_x;
-    y += (metrics->y_offset * sy) >> 16;
-
-    lv_font_glyph_dsc_t gd;
-    if (!_font->get_glyph_dsc(_font, &gd, uniCode, 0))
-    {
-      return drawCharDummy(gfx, x, y, metrics->x_advance, metrics->height, style, filled_x);
-    }
-
-    int32_t adv_px = gd.adv_w;
-    int32_t xAdvance = (adv_px * sx) >> 16;
-    int32_t xoffset = (gd.ofs_x * sx) >> 16;
-
-    /*
-     * Space-like glyphs can have valid metrics but no bitmap payload.
-     * Do not fallback to drawCharDummy, keep LVGL-like spacing behavior.
-     */
-    if (gd.box_w == 0 || gd.box_h == 0)
-    {
-      bool fillbg = (style->back_rgb888 != style->fore_rgb888);
-      if (fillbg)
-      {
-        int32_t left  = std::max<int>(filled_x, x);
-        int32_t right = x + xAdvance;
-        if (left < right)
-        {
-          uint32_t col_back = gfx->getColorConverter()->convert(style->back_rgb888);
-          gfx->startWrite();
-          gfx->setRawColor(col_back);
-          gfx->writeFillRect(left, y, right - left, (metrics->height * sy) >> 16);
-          gfx->endWrite();
-        }
-        filled_x = right;
-      }
-      return xAdvance;
-    }
-
-    gd.req_raw_bitmap = 0;
-    gd.resolved_font = _font;
-    uint32_t glyph_stride = gd.box_w;
-    uint32_t glyph_stride_alloc = ((gd.box_w + 63U) / 64U) * 64U;
-    if (glyph_stride_alloc < gd.box_w) glyph_stride_alloc = gd.box_w;
+    gd->req_raw_bitmap = 0;
+    gd->resolved_font = _font;
+    uint32_t glyph_stride_alloc = ((gd->box_w + 63U) / 64U) * 64U;
+    if (glyph_stride_alloc < gd->box_w) glyph_stride_alloc = gd->box_w;
     const uint8_t stride_sentinel = 0xA5;
-    std::vector<uint8_t> glyph_buf(glyph_stride_alloc * gd.box_h, stride_sentinel);
+    size_t glyph_buf_size = glyph_stride_alloc * gd->box_h;
+    uint8_t* glyph_buf = gfx->getFontScratch(glyph_buf_size);
+    if (glyph_buf == nullptr) { return nullptr; }
+    memset(glyph_buf, stride_sentinel, glyph_buf_size);
     lv_draw_buf_t draw_buf{};
-    draw_buf.data = glyph_buf.data();
-    const void* bmp_res = _font->get_glyph_bitmap(&gd, &draw_buf);
+    draw_buf.data = glyph_buf;
+    const void* bmp_res = _font->get_glyph_bitmap(gd, &draw_buf);
     const uint8_t* bitmap = draw_buf.data;
     if (bmp_res == nullptr || bitmap == nullptr)
     {
-      return drawCharDummy(gfx, x, y, metrics->x_advance, metrics->height, style, filled_x);
+      return nullptr;
     }
 
     uint8_t glyph_bpp = 8;
     // NOTE: LV_FONT_GLYPH_FORMAT_* are enum values (see lv_font/font.h),
     //       not preprocessor macros, so they cannot be #ifdef'd.
-    switch (gd.format)
+    switch (gd->format)
     {
       case LV_FONT_GLYPH_FORMAT_A1:
       case LV_FONT_GLYPH_FORMAT_A1_ALIGNED:
@@ -984,7 +1015,7 @@ label_nextbyte: /// 次のデータを取得する;
         break;
     }
 
-    if (gd.box_w > 0 && gd.box_h > 0)
+    if (gd->box_w > 0 && gd->box_h > 0)
     {
       auto is_quantized_alpha = [glyph_bpp](uint8_t a) -> bool {
         if (glyph_bpp >= 8) return true;
@@ -994,24 +1025,24 @@ label_nextbyte: /// 次のデータを取得する;
       };
 
       auto score_stride = [&](uint32_t test_stride) -> uint32_t {
-        if (test_stride < gd.box_w || test_stride > glyph_stride_alloc) return 0;
+        if (test_stride < gd->box_w || test_stride > glyph_stride_alloc) return 0;
 
         uint32_t q_score = 0;
         uint32_t payload_written = 0;
         uint32_t pad_untouched = 0;
-        uint32_t payload_total = gd.box_w * gd.box_h;
-        uint32_t pad_total = (test_stride - gd.box_w) * gd.box_h;
+        uint32_t payload_total = gd->box_w * gd->box_h;
+        uint32_t pad_total = (test_stride - gd->box_w) * gd->box_h;
 
-        for (uint32_t py = 0; py < gd.box_h; ++py)
+        for (uint32_t py = 0; py < gd->box_h; ++py)
         {
           const uint8_t* row = bitmap + py * test_stride;
-          for (uint32_t px = 0; px < gd.box_w; ++px)
+          for (uint32_t px = 0; px < gd->box_w; ++px)
           {
             uint8_t v = row[px];
             if (is_quantized_alpha(v)) ++q_score;
             if (v != stride_sentinel) ++payload_written;
           }
-          for (uint32_t px = gd.box_w; px < test_stride; ++px)
+          for (uint32_t px = gd->box_w; px < test_stride; ++px)
           {
             if (row[px] == stride_sentinel) ++pad_untouched;
           }
@@ -1029,16 +1060,16 @@ label_nextbyte: /// 次のデータを取得する;
       };
 
       const uint32_t candidates[] = {
-        gd.box_w,
-        (uint32_t)((gd.box_w + 1U) & ~1U),
-        (uint32_t)((gd.box_w + 3U) & ~3U),
-        (uint32_t)((gd.box_w + 7U) & ~7U),
-        (uint32_t)((gd.box_w + 15U) & ~15U),
-        (uint32_t)((gd.box_w + 31U) & ~31U),
-        (uint32_t)((gd.box_w + 63U) & ~63U)
+        gd->box_w,
+        (uint32_t)((gd->box_w + 1U) & ~1U),
+        (uint32_t)((gd->box_w + 3U) & ~3U),
+        (uint32_t)((gd->box_w + 7U) & ~7U),
+        (uint32_t)((gd->box_w + 15U) & ~15U),
+        (uint32_t)((gd->box_w + 31U) & ~31U),
+        (uint32_t)((gd->box_w + 63U) & ~63U)
       };
 
-      uint32_t best_stride = gd.box_w;
+      uint32_t best_stride = gd->box_w;
       uint32_t best_score = score_stride(best_stride);
       for (size_t ci = 0; ci < sizeof(candidates) / sizeof(candidates[0]); ++ci)
       {
@@ -1051,7 +1082,82 @@ label_nextbyte: /// 次のデータを取得する;
           best_stride = s;
         }
       }
-      glyph_stride = best_stride;
+      *stride = best_stride;
+    }
+    return bitmap;
+  }
+
+  size_t LVGLfont::drawChar(LGFXBase* gfx, int32_t x, int32_t y, uint16_t uniCode, const TextStyle* style, FontMetrics* metrics, int32_t& filled_x) const
+  {
+    if (_font == nullptr || _font->get_glyph_dsc == nullptr || _font->get_glyph_bitmap == nullptr)
+    {
+      return drawCharDummy(gfx, x, y, metrics->x_advance, metrics->height, style, filled_x);
+    }
+
+    int32_t sy = 65536 * style->size_y;
+    int32_t sx = 65536 * style->size_x;
+    y += (metrics->y_offset * sy) >> 16;
+
+    lv_font_glyph_dsc_t gd;
+    if (!_font->get_glyph_dsc(_font, &gd, uniCode, 0))
+    {
+      return drawCharDummy(gfx, x, y, metrics->x_advance, metrics->height, style, filled_x);
+    }
+
+    int32_t adv_px = gd.adv_w;
+    int32_t xAdvance = (adv_px * sx) >> 16;
+    int32_t xoffset = (gd.ofs_x * sx) >> 16;
+
+    /*
+     * Space-like glyphs can have valid metrics but no bitmap payload.
+     * Do not fallback to drawCharDummy, keep LVGL-like spacing behavior.
+     */
+    if (gd.box_w == 0 || gd.box_h == 0)
+    {
+      bool fillbg = (style->back_rgb888 != style->fore_rgb888);
+      if (fillbg)
+      {
+        int32_t left  = std::max<int>(filled_x, x);
+        int32_t right = x + xAdvance;
+        if (left < right)
+        {
+          uint32_t col_back = gfx->getColorConverter()->convert(style->back_rgb888);
+          gfx->startWrite();
+          gfx->setRawColor(col_back);
+          gfx->writeFillRect(left, y, right - left, (metrics->height * sy) >> 16);
+          gfx->endWrite();
+        }
+        filled_x = right;
+      }
+      return xAdvance;
+    }
+
+    const uint8_t* bitmap;
+    uint32_t glyph_stride = gd.box_w;
+    auto glyph_cache = getGlyphCache();
+    auto cache = glyph_cache ? glyph_cache->findGlyphCache(uniCode) : nullptr;
+    if (cache && cache->width == gd.box_w && cache->height == gd.box_h)
+    {
+      bitmap = cache->bitmap();
+    }
+    else
+    {
+      bitmap = decodeGlyph(gfx, &gd, &glyph_stride);
+      if (bitmap == nullptr)
+      {
+        return drawCharDummy(gfx, x, y, metrics->x_advance, metrics->height, style, filled_x);
+      }
+      if (auto entry = glyph_cache ? glyph_cache->allocGlyphCache(uniCode, gd.box_w * gd.box_h) : nullptr)
+      { // キャッシュにはstrideを詰めて格納する;
+        entry->width = gd.box_w;
+        entry->height = gd.box_h;
+        for (uint32_t py = 0; py < gd.box_h; ++py)
+        {
+          memcpy(entry->bitmap() + py * gd.box_w, bitmap + py * glyph_stride, gd.box_w);
+        }
+        bitmap = entry->bitmap();
+        glyph_stride = gd.box_w;
+      }
     }
 
     int32_t yoffset = metrics->baseline - (gd.ofs_y + gd.box_h);
@@ -1072,6 +1178,89 @@ label_nextbyte: /// 次のデータを取得する;
         255U);
   }
 
+//----------------------------------------------------------------------------
+
+  void GlyphCache::setGlyphCacheSize(size_t bytes)
+  {
+    _glyph_cache_limit = bytes;
+    while (_glyph_cache_used > _glyph_cache_limit && _glyph_cache_tail)
+    {
+      removeGlyphCache(_glyph_cache_tail);
+    }
+  }
+
+  void GlyphCache::clearGlyphCache(void)
+  {
+    while (_glyph_cache_tail)
+    {
+      removeGlyphCache(_glyph_cache_tail);
+    }
+  }
+
+  void GlyphCache::removeGlyphCache(glyph_cache_t* entry) const
+  {
+    if (entry->prev) { entry->prev->next = entry->next; } else { _glyph_cache_head = entry->next; }
+    if (entry->next) { entry->next->prev = entry->prev; } else { _glyph_cache_tail = entry->prev; }
+    auto link = &_glyph_cache_bucket[entry->index & (glyph_cache_buckets - 1)];
+    while (*link != entry) { link = &(*link)->chain; }
+    *link = entry->chain;
+    _glyph_cache_used -= sizeof(glyph_cache_t) + entry->size;
+    heap_free(entry);
+  }
+
+  GlyphCache::glyph_cache_t* GlyphCache::peekGlyphCache(uint16_t index) const
+  {
+    auto entry = _glyph_cache_bucket[index & (glyph_cache_buckets - 1)];
+    while (entry && entry->index != index) { entry = entry->chain; }
+    return entry;
+  }
+
+  GlyphCache::glyph_cache_t* GlyphCache::findGlyphCache(uint16_t index) const
+  {
+    if (_glyph_cache_limit == 0) return nullptr;
+    auto entry = peekGlyphCache(index);
+    if (entry == nullptr)
+    {
+      ++_glyph_cache_miss;
+      return nullptr;
+    }
+    ++_glyph_cache_hit;
+    if (entry != _glyph_cache_head)
+    { // move to front.
+      entry->prev->next = entry->next;
+      if (entry->next) { entry->next->prev = entry->prev; } else { _glyph_cache_tail = entry->prev; }
+      entry->prev = nullptr;
+      entry->next = _glyph_cache_head;
+      _glyph_cache_head->prev = entry;
+      _glyph_cache_head = entry;
+    }
+    return entry;
+  }
+
+  GlyphCache::glyph_cache_t* GlyphCache::allocGlyphCache(uint16_t index, uint32_t bitmap_size) const
+  {
+    size_t size = sizeof(glyph_cache_t) + bitmap_size;
+    if (size > _glyph_cache_limit) return nullptr;
+    while (_glyph_cache_used + size > _glyph_cache_limit)
+    {
+      removeGlyphCache(_glyph_cache_tail);
+    }
+    auto entry = (glyph_cache_t*)heap_alloc(size);
+    if (entry == nullptr) return nullptr;
+    ++_glyph_cache_alloc;
+    memset(entry, 0, sizeof(glyph_cache_t));
+    entry->index = index;
+    entry->size = bitmap_size;
+    auto& bucket = _glyph_cache_bucket[index & (glyph_cache_buckets - 1)];
+    entry->chain = bucket;
+    bucket = entry;
+    entry->next = _glyph_cache_head;
+    if (_glyph_cache_head) { _glyph_cache_head->prev = entry; } else { _glyph_cache_tail = entry; }
+    _glyph_cache_head = entry;
+    _glyph_cache_used += size;
+    return entry;
+  }
+
 //----------------------------------------------------------------------------
 
   namespace
@@ -1230,6 +1419,7 @@ label_nextbyte: /// 次のデータを取得する;
   bool BFFfont::unloadFont(void)
   {
     _fontLoaded = false;
+    clearGlyphCache();
     if (cmap_data) {
       heap_free(cmap_data);
       cmap_data = nullptr;
@@ -1894,6 +2084,14 @@ label_nextbyte: /// 次のデータを取得する;
     if (!found) gid = 0;
 
     GlyphInfo info;
+    glyph_cache_t* cache = subpixel_rendering ? nullptr : peekGlyphCache(gid);
+    if (cache)
+    { // subpixel glyphs are cached with the collapsed width, so they are not used for metrics.
+      info.advance_raw = cache->x_advance;
+      info.bbox_x = cache->x_offset;
+      info.bbox_w = cache->width;
+    }
+    else
     if (!loadGlyphInfo(gid, &info))
     {
       metrics->x_offset = 0;
@@ -1920,10 +2118,34 @@ label_nextbyte: /// 次のデータを取得する;
     if (!found) gid = 0;
 
     GlyphInfo info;
-    uint8_t* bitmap = nullptr;
-    if (!decodeGlyphBitmap(gid, &info, &bitmap))
+    uint8_t* decoded = nullptr;
+    const uint8_t* bitmap = nullptr;
+    if (auto cache = findGlyphCache(gid))
     {
-      return drawCharDummy(gfx, x, y, default_advance_width, metrics->height, style, filled_x);
+      info.advance_raw = cache->x_advance;
+      info.bbox_x = cache->x_offset;
+      info.bbox_y = cache->y_offset;
+      info.bbox_w = cache->width;
+      info.bbox_h = cache->height;
+      bitmap = cache->bitmap();
+    }
+    else
+    {
+      if (!decodeGlyphBitmap(gid, &info, &decoded))
+      {
+        return drawCharDummy(gfx, x, y, default_advance_width, metrics->height, style, filled_x);
+      }
+      bitmap = decoded;
+      uint32_t size = decoded ? info.bbox_w * info.bbox_h : 0;
+      if (auto cache = allocGlyphCache(gid, size))
+      {
+        cache->x_advance = info.advance_raw;
+        cache->x_offset = info.bbox_x;
+        cache->y_offset = info.bbox_y;
+        cache->width = info.bbox_w;
+        cache->height = info.bbox_h;
+        if (size) { memcpy(cache->bitmap(), decoded, size); }
+      }
     }
 
     int32_t xAdvance = info.advance_raw;
@@ -1957,7 +2179,7 @@ label_nextbyte: /// 次のデータを取得する;
         bitmap,
         info.bbox_w,
         max_alpha);
-    if (bitmap) heap_free(bitmap);
+    if (decoded) heap_free(decoded);
     return drawn;
   }
 
@@ -1979,6 +2201,7 @@ label_nextbyte: /// 次のデータを取得する;
   bool VLWfont::unloadFont(void)
   {
     _fontLoaded = false;
+    clearGlyphCache();
     if (gUnicode)  { heap_free(gUnicode);  gUnicode  = nullptr; }
     if (gWidth)    { heap_free(gWidth);    gWidth    = nullptr; }
     if (gxAdvance) { heap_free(gxAdvance); gxAdvance = nullptr; }
@@ -2008,6 +2231,10 @@ label_nextbyte: /// 次のデータを取得する;
         metrics->width     = gWidth[gNum];
         metrics->x_advance = gxAdvance[gNum];
         metrics->x_offset  = gdX[gNum];
+      } else if (auto cache = peekGlyphCache(gNum)) {
+        metrics->width     = cache->width;
+        metrics->x_advance = cache->x_advance;
+        metrics->x_offset  = cache->x_offset;
       } else {
         auto file = _fontData;
 
@@ -2031,6 +2258,7 @@ label_nextbyte: /// 次のデータを取得する;
 
 
   bool VLWfont::loadFont(DataWrapper* data) {
+    clearGlyphCache();
     _fontData = data;
     {
       uint32_t buf[6];
@@ -2122,40 +2350,62 @@ label_nextbyte: /// 次のデータを取得する;
   {
     auto file = this->_fontData;
 
-    uint32_t buffer[6] = {0};
+    uint32_t buffer[6];
     uint16_t gNum = 0;
 
     int32_t sy = 65536 * style->size_y;
     y += (metrics->y_offset * sy) >> 16;
 
+    int32_t h = 0;  // Height of glyph
+    int32_t w = 0;  // Width of glyph
+    int32_t adv;    // xAdvance - to move x cursor
+    int32_t dX = 0; // x delta from cursor
+    int32_t dY = 0; // y delta from baseline
+    const uint8_t* pixel = nullptr;
+
     if (code == 0x20) {
-      gNum = 0xFFFF;
-      buffer[2] = getSwap32(this->spaceWidth);
+      adv = this->spaceWidth;
     } else if (!this->getUnicodeIndex(code, &gNum)) {
       return drawCharDummy(gfx, x, y, this->spaceWidth, metrics->height, style, filled_x);
+    } else if (auto cache = findGlyphCache(gNum)) {
+      h   = cache->height;
+      w   = cache->width;
+      adv = cache->x_advance;
+      dX  = cache->x_offset;
+      dY  = cache->y_offset;
+      pixel = cache->bitmap();
     } else {
       file->preRead();
       file->seek(28 + gNum * 28);
       file->read((uint8_t*)buffer, 24);
+      h   = getSwap32(buffer[0]);
+      w   = getSwap32(buffer[1]);
+      adv = getSwap32(buffer[2]);
+      dY  = (int16_t)getSwap32(buffer[3]);
+      dX  = (int8_t)getSwap32(buffer[4]);
+      uint8_t* buf;
+      if (auto cache = allocGlyphCache(gNum, w * h)) {
+        cache->height    = h;
+        cache->width     = w;
+        cache->x_advance = adv;
+        cache->x_offset  = dX;
+        cache->y_offset  = dY;
+        buf = cache->bitmap();
+      } else {
+        buf = (uint8_t*)alloca(w * h);
+      }
       file->seek(this->gBitmap[gNum]);
+      file->read(buf, w * h);
+      file->postRead();
+      pixel = buf;
     }
 
-
-    int32_t h        = getSwap32(buffer[0]); // Height of glyph
-    int32_t w        = getSwap32(buffer[1]); // Width of glyph
     int32_t sx       = 65536 * style->size_x;
-    int32_t xAdvance = (getSwap32(buffer[2]) * sx) >> 16; // xAdvance - to move x cursor
-    int32_t xoffset  = ((int32_t)((int8_t)getSwap32(buffer[4])) * sx) >> 16; // x delta from cursor
-    int32_t dY       = (int16_t)getSwap32(buffer[3]); // y delta from baseline
+    int32_t xAdvance = (adv * sx) >> 16;
+    int32_t xoffset  = (dX * sx) >> 16;
     int32_t yoffset  = (this->maxAscent - dY);
 //      int32_t yoffset = (gfx->_font_metrics.y_offset) - dY;
 
-    auto pixel = (uint8_t*)alloca(w * h);
-    if (gNum != 0xFFFF) {
-      file->read(pixel, w * h);
-      file->postRead();
-    }
-
     gfx->startWrite();
 
     uint32_t colortbl[2] = {gfx->getColorConverter()->convert(style->back_rgb888), gfx->getColorConverter()->convert(style->fore_rgb888)};
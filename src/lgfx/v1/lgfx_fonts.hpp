@@ -208,14 +208,100 @@ namespace lgfx
     bool updateFontMetric(FontMetrics *metrics, uint16_t uniCode) const override;
     size_t drawChar(LGFXBase* gfx, int32_t x, int32_t y, uint16_t c, const TextStyle* style, FontMetrics* metrics, int32_t& filled_x) const override;
 
-  private:
-    const uint8_t* getGlyph(uint16_t encoding) const;
+  protected:
+    virtual const uint8_t* getGlyph(uint16_t encoding) const;
     const uint8_t* _font;
   };
 
+  /// U8g2font with an in-RAM index of the Unicode glyphs (for CJK fonts with thousands of glyphs).
+  /// The index holds every step-th glyph, so a lookup is a binary search and at most step-1 hops
+  /// instead of a walk through the font data.  Memory use : (glyphs / step + 1) * 6 bytes.
+  /// The font constants stay in flash; declare one of these per font and build it before drawing.
+  ///   static lgfx::IndexedU8g2font font(lgfx::fonts::efontJA_16);
+  ///   font.build();  // in setup()
+  ///   lcd.setFont(&font);
+  struct IndexedU8g2font : public U8g2font
+  {
+    IndexedU8g2font(const U8g2font& font, uint8_t step = 8) : U8g2font(font), _step(step ? step : 1) {}
+    IndexedU8g2font(const IndexedU8g2font&) = delete;
+    IndexedU8g2font& operator=(const IndexedU8g2font&) = delete;
+    virtual ~IndexedU8g2font(void) { release(); }
+
+    /// Build the index.  Without it (or if allocation fails) lookups walk the font data as U8g2font does.
+    bool build(void);
+    void release(void);
+    size_t getIndexSize(void) const { return _count * (sizeof(uint32_t) + sizeof(uint16_t)); }
+
+  protected:
+    const uint8_t* getGlyph(uint16_t encoding) const override;
+
+    /// 索引 : オフセット(uint32_t) _count個の後に、文字コード(uint16_t) _count個が続く;
+    uint32_t* _index = nullptr;
+    uint32_t _count = 0;
+    uint8_t _step;
+  };
+
 //----------------------------------------------------------------------------
 
-  struct RunTimeFont : public IFont
+  /// LRU cache of decoded glyph bitmaps, shared by the fonts that decode glyphs at draw time.
+  struct GlyphCache
+  {
+    GlyphCache(void) = default;
+    GlyphCache(const GlyphCache&) = delete;
+    GlyphCache& operator=(const GlyphCache&) = delete;
+    ~GlyphCache(void) { clearGlyphCache(); }
+
+    /// Set the byte budget of the in-RAM glyph cache. (0 = disabled)
+    void setGlyphCacheSize(size_t bytes);
+    size_t getGlyphCacheSize(void) const { return _glyph_cache_limit; }
+    size_t getGlyphCacheUsed(void) const { return _glyph_cache_used; }
+    uint32_t getGlyphCacheHitCount(void) const { return _glyph_cache_hit; }
+    uint32_t getGlyphCacheMissCount(void) const { return _glyph_cache_miss; }
+    /// Number of heap allocations made for cache entries.
+    uint32_t getGlyphCacheAllocCount(void) const { return _glyph_cache_alloc; }
+    void resetGlyphCacheCount(void) { _glyph_cache_hit = 0; _glyph_cache_miss = 0; _glyph_cache_alloc = 0; }
+    void clearGlyphCache(void);
+
+  protected:
+    friend struct LVGLfont;
+
+    // decoded metrics and alpha bitmap of one glyph. the bitmap follows the header in the same allocation.
+    struct glyph_cache_t
+    {
+      glyph_cache_t* prev;
+      glyph_cache_t* next;
+      glyph_cache_t* chain; // next entry in the same bucket
+      uint32_t size;
+      uint16_t index;
+      uint16_t width;
+      uint16_t height;
+      uint16_t x_advance;
+      int16_t  x_offset;
+      int16_t  y_offset;
+      uint8_t* bitmap(void) { return reinterpret_cast<uint8_t*>(this + 1); }
+    };
+
+    /// Counts a hit or miss and moves the entry to the front. Call it once per drawn glyph.
+    glyph_cache_t* findGlyphCache(uint16_t index) const;
+    /// Looks up without counting or reordering, for metric lookups.
+    glyph_cache_t* peekGlyphCache(uint16_t index) const;
+    glyph_cache_t* allocGlyphCache(uint16_t index, uint32_t bitmap_size) const;
+
+  private:
+    void removeGlyphCache(glyph_cache_t* entry) const;
+
+    mutable glyph_cache_t* _glyph_cache_head = nullptr; // most recently used
+    mutable glyph_cache_t* _glyph_cache_tail = nullptr; // least recently used
+    static constexpr size_t glyph_cache_buckets = 32;
+    mutable glyph_cache_t* _glyph_cache_bucket[glyph_cache_buckets] = {}; // indexed by the low bits of the glyph index
+    mutable size_t _glyph_cache_used = 0;
+    mutable uint32_t _glyph_cache_hit = 0;
+    mutable uint32_t _glyph_cache_miss = 0;
+    mutable uint32_t _glyph_cache_alloc = 0;
+    size_t _glyph_cache_limit = 0;
+  };
+
+  struct RunTimeFont : public IFont, public GlyphCache
   {
     virtual ~RunTimeFont() = default;
     virtual bool loadFont(DataWrapper* data) = 0;
@@ -344,6 +430,8 @@ namespace lgfx
 //----------------------------------------------------------------------------
 // LVGL font wrapper (lv_font_t / lv_font_fmt_txt)
 
+  /// Glyphs are decoded into the font scratch buffer of the LGFXBase being drawn on
+  /// (LGFXBase::getFontScratch), so the font itself holds no state and stays a constant.
   struct LVGLfont : public IFont
   {
     constexpr LVGLfont(const ::lv_font_t* font = nullptr) : _font(font) {}
@@ -354,6 +442,25 @@ namespace lgfx
     size_t drawChar(LGFXBase* gfx, int32_t x, int32_t y, uint16_t c, const TextStyle* style, FontMetrics* metrics, int32_t& filled_x) const override;
 
     const ::lv_font_t* _font;
+
+  protected:
+    virtual const GlyphCache* getGlyphCache(void) const { return nullptr; }
+
+  private:
+    const uint8_t* decodeGlyph(LGFXBase* gfx, ::lv_font_glyph_dsc_t* gd, uint32_t* stride) const;
+  };
+
+  /// LVGLfont that keeps the decoded glyphs in an LRU cache, which saves the decompression
+  /// of the compressed fonts (lv_font_montserrat_28_compressed).
+  /// The cache belongs to this object, not to the constant font it wraps:
+  ///   static lgfx::CachedLVGLfont font(lgfx::fonts::lv_font_montserrat_28_compressed, 32768);
+  ///   lcd.setFont(&font);
+  struct CachedLVGLfont : public LVGLfont, public GlyphCache
+  {
+    CachedLVGLfont(const LVGLfont& font, size_t cache_bytes) : LVGLfont(font._font) { setGlyphCacheSize(cache_bytes); }
+
+  protected:
+    const GlyphCache* getGlyphCache(void) const override { return this; }
   };
 
 //----------------------------------------------------------------------------
@@ -6,6 +6,10 @@ typedef struct {
     uint32_t gid_right;
 } kern_pair_ref_t;
 
+#ifndef LV_USE_FONT_COMPRESSED
+#define LV_USE_FONT_COMPRESSED 1
+#endif
+
 static const uint8_t opa2_table[4] = {0x00, 0x55, 0xAA, 0xFF};
 static const uint8_t opa4_table[16] = {
     0x00, 0x11, 0x22, 0x33,
@@ -14,6 +18,118 @@ static const uint8_t opa4_table[16] = {
     0xCC, 0xDD, 0xEE, 0xFF
 };
 
+#if LV_USE_FONT_COMPRESSED
+
+typedef enum {
+    RLE_STATE_SINGLE = 0,
+    RLE_STATE_REPEATED,
+    RLE_STATE_COUNTER,
+} rle_state_t;
+
+typedef struct {
+    uint32_t rdp;
+    const uint8_t * in;
+    uint8_t bpp;
+    uint8_t prev_v;
+    uint8_t count;
+    rle_state_t state;
+} rle_t;
+
+static inline uint8_t get_bits(const uint8_t * in, uint32_t bit_pos, uint8_t len)
+{
+    uint8_t bit_mask = (uint8_t)((1u << len) - 1);
+    uint32_t byte_pos = bit_pos >> 3;
+    bit_pos = bit_pos & 0x7;
+
+    if(bit_pos + len >= 8) {
+        uint16_t in16 = (in[byte_pos] << 8) + in[byte_pos + 1];
+        return (in16 >> (16 - bit_pos - len)) & bit_mask;
+    }
+    return (in[byte_pos] >> (8 - bit_pos - len)) & bit_mask;
+}
+
+static uint8_t rle_next(rle_t * rle)
+{
+    uint8_t ret = 0;
+
+    if(rle->state == RLE_STATE_SINGLE) {
+        ret = get_bits(rle->in, rle->rdp, rle->bpp);
+        if(rle->rdp != 0 && rle->prev_v == ret) {
+            rle->count = 0;
+            rle->state = RLE_STATE_REPEATED;
+        }
+        rle->prev_v = ret;
+        rle->rdp += rle->bpp;
+    }
+    else if(rle->state == RLE_STATE_REPEATED) {
+        uint8_t v = get_bits(rle->in, rle->rdp, 1);
+        rle->count++;
+        rle->rdp += 1;
+        if(v == 1) {
+            ret = rle->prev_v;
+            if(rle->count == 11) {
+                rle->count = get_bits(rle->in, rle->rdp, 6);
+                rle->rdp += 6;
+                if(rle->count != 0) {
+                    rle->state = RLE_STATE_COUNTER;
+                }
+                else {
+                    ret = get_bits(rle->in, rle->rdp, rle->bpp);
+                    rle->prev_v = ret;
+                    rle->rdp += rle->bpp;
+                    rle->state = RLE_STATE_SINGLE;
+                }
+            }
+        }
+        else {
+            ret = get_bits(rle->in, rle->rdp, rle->bpp);
+            rle->prev_v = ret;
+            rle->rdp += rle->bpp;
+            rle->state = RLE_STATE_SINGLE;
+        }
+    }
+    else if(rle->state == RLE_STATE_COUNTER) {
+        ret = rle->prev_v;
+        rle->count--;
+        if(rle->count == 0) {
+            ret = get_bits(rle->in, rle->rdp, rle->bpp);
+            rle->prev_v = ret;
+            rle->rdp += rle->bpp;
+            rle->state = RLE_STATE_SINGLE;
+        }
+    }
+
+    return ret;
+}
+
+/* Decode an RLE compressed glyph into an 8 bit alpha bitmap with stride w.
+ * With prefilter each line is XORed with the previous one. The raw values are
+ * kept in the output until the end so no line buffers are needed. */
+static void decompress(const uint8_t * in, uint8_t * out, int32_t w, int32_t h, uint8_t bpp, bool prefilter)
+{
+    rle_t rle = { 0, in, bpp, 0, 0, RLE_STATE_SINGLE };
+    int32_t x, y;
+    uint8_t * line = out;
+
+    for(y = 0; y < h; y++) {
+        for(x = 0; x < w; x++) {
+            uint8_t v = rle_next(&rle);
+            line[x] = (prefilter && y) ? (uint8_t)(v ^ line[x - w]) : v;
+        }
+        line += w;
+    }
+
+    int32_t size = w * h;
+    for(x = 0; x < size; x++) {
+        uint8_t v = out[x];
+        if(bpp == 1) out[x] = v ? 0xFF : 0x00;
+        else if(bpp == 2) out[x] = opa2_table[v];
+        else if(bpp == 4) out[x] = opa4_table[v];
+        else if(bpp == 3) out[x] = (uint8_t)((v << 5) | (v << 2) | (v >> 1));
+    }
+}
+
+#endif /*LV_USE_FONT_COMPRESSED*/
 
 const void * lv_font_get_bitmap_fmt_txt(lv_font_glyph_dsc_t * g_dsc, lv_draw_buf_t * draw_buf)
 {
@@ -0,0 +1,171 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+
+#include "Bus_Recorder.hpp"
+
+#include "pixelcopy.hpp"
+
+#include <string.h>
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  void Bus_Recorder::release(void)
+  {
+    if (_cfg.target) { _cfg.target->release(); }
+    _flip_buffer.deleteBuffer();
+    _pixel_buffer.deleteBuffer();
+  }
+
+  void Bus_Recorder::record(char kind, uint_fast8_t bit_length, uint32_t length, const void* payload, size_t payload_size)
+  {
+    uint8_t header[6] = { (uint8_t)kind, (uint8_t)bit_length
+                        , (uint8_t)length, (uint8_t)(length >> 8), (uint8_t)(length >> 16), (uint8_t)(length >> 24) };
+    fwrite(header, 1, sizeof(header), _cfg.output);
+    if (payload_size) { fwrite(payload, 1, payload_size, _cfg.output); }
+  }
+
+  void Bus_Recorder::beginTransaction(void)
+  {
+    ++_stats.transactions;
+    if (_cfg.target) { _cfg.target->beginTransaction(); }
+  }
+
+  bool Bus_Recorder::writeCommand(uint32_t data, uint_fast8_t bit_length)
+  {
+    uint32_t bytes = bit_length >> 3;
+    ++_stats.commands;
+    _stats.command_bytes += bytes;
+    // 最後に送られるバイトがコマンド本体 (16bitの場合は cmd << 8 の形で渡される);
+    if (bytes && ((data >> ((bytes - 1) << 3)) & 0xFF) == _cfg.window_command) { ++_stats.windows; }
+    if (_cfg.output)
+    {
+      uint8_t buf[4] = { (uint8_t)data, (uint8_t)(data >> 8), (uint8_t)(data >> 16), (uint8_t)(data >> 24) };
+      record('C', bit_length, bytes, buf, bytes);
+    }
+    return _cfg.target ? _cfg.target->writeCommand(data, bit_length) : true;
+  }
+
+  void Bus_Recorder::writeData(uint32_t data, uint_fast8_t bit_length)
+  {
+    uint32_t bytes = bit_length >> 3;
+    _stats.data_bytes += bytes;
+    if (_cfg.output)
+    {
+      uint8_t buf[4] = { (uint8_t)data, (uint8_t)(data >> 8), (uint8_t)(data >> 16), (uint8_t)(data >> 24) };
+      record('D', bit_length, bytes, buf, bytes);
+    }
+    if (_cfg.target) { _cfg.target->writeData(data, bit_length); }
+  }
+
+  void Bus_Recorder::writeDataRepeat(uint32_t data, uint_fast8_t bit_length, uint32_t count)
+  {
+    uint32_t bytes = bit_length >> 3;
+    _stats.data_bytes += (uint64_t)bytes * count;
+    if (_cfg.output)
+    {
+      uint8_t buf[4] = { (uint8_t)data, (uint8_t)(data >> 8), (uint8_t)(data >> 16), (uint8_t)(data >> 24) };
+      record('R', bit_length, count, buf, bytes);
+    }
+    if (_cfg.target) { _cfg.target->writeDataRepeat(data, bit_length, count); }
+  }
+
+  void Bus_Recorder::writePixels(pixelcopy_t* pc, uint32_t length)
+  {
+    uint32_t bytes = pc->dst_bits >> 3;
+    _stats.data_bytes += (uint64_t)bytes * length;
+    if (_cfg.target)
+    {
+      if (_cfg.output == nullptr)
+      {
+        _cfg.target->writePixels(pc, length);
+        return;
+      }
+      // 記録用に変換した後、同じ状態のpixelcopyでターゲットに送る;
+      pixelcopy_t pc_copy = *pc;
+      _cfg.target->writePixels(&pc_copy, length);
+    }
+
+    // ターゲットが無い場合も実機と同じく変換を行い、pcを進める;
+    static constexpr uint32_t limit = 256;
+    auto buf = _pixel_buffer.getBuffer(limit * bytes);
+    if (buf == nullptr) { return; }
+    do
+    {
+      uint32_t len = (length < limit) ? length : limit;
+      pc->fp_copy(buf, 0, len, pc);
+      if (_cfg.output) { record('D', pc->dst_bits, len * bytes, buf, len * bytes); }
+      length -= len;
+    } while (length);
+  }
+
+  void Bus_Recorder::writeBytes(const uint8_t* data, uint32_t length, bool dc, bool use_dma)
+  {
+    if (dc)
+    {
+      _stats.data_bytes += length;
+      if (use_dma) { _stats.dma_bytes += length; }
+    }
+    else
+    {
+      _stats.command_bytes += length;
+    }
+    if (_cfg.output) { record(dc ? 'D' : 'C', 8, length, data, length); }
+    if (_cfg.target) { _cfg.target->writeBytes(data, length, dc, use_dma); }
+  }
+
+  void Bus_Recorder::addDMAQueue(const uint8_t* data, uint32_t length)
+  {
+    ++_stats.dma_queues;
+    _stats.data_bytes += length;
+    _stats.dma_bytes += length;
+    if (_cfg.output) { record('D', 8, length, data, length); }
+    if (_cfg.target) { _cfg.target->addDMAQueue(data, length); }
+  }
+
+  uint32_t Bus_Recorder::readData(uint_fast8_t bit_length)
+  {
+    _stats.read_bytes += bit_length >> 3;
+    return _cfg.target ? _cfg.target->readData(bit_length) : 0;
+  }
+
+  bool Bus_Recorder::readBytes(uint8_t* dst, uint32_t length, bool use_dma)
+  {
+    _stats.read_bytes += length;
+    if (_cfg.target) { return _cfg.target->readBytes(dst, length, use_dma); }
+    memset(dst, 0, length);
+    return true;
+  }
+
+  void Bus_Recorder::readPixels(void* dst, pixelcopy_t* pc, uint32_t length)
+  {
+    _stats.read_bytes += (uint64_t)length * (pc->src_bits >> 3);
+    if (_cfg.target)
+    {
+      _cfg.target->readPixels(dst, pc, length);
+      return;
+    }
+    memset(dst, 0, length * (pc->dst_bits >> 3));
+  }
+
+//----------------------------------------------------------------------------
+ }
+}
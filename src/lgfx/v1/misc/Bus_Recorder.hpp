@@ -0,0 +1,117 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../Bus.hpp"
+#include "../platforms/common.hpp"
+
+#include <stdint.h>
+#include <stdio.h>
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  /// @brief 送信内容を計数・記録するバス。;
+  /// Counts what a panel sends: commands, bytes, DMA queue submissions and window settings.
+  /// With a target bus, every call is also passed to it, so the traffic of a real display
+  /// can be measured.  Without a target it needs no hardware, and the panel code
+  /// (e.g. Panel_ILI9341) runs unchanged on a host; reads return zero.
+  ///
+  /// If output is set, the byte stream is written to it as records:
+  ///   kind (1 byte: 'C' command / 'D' data / 'R' repeated data),
+  ///   bit length (1 byte), length (4 bytes, little endian), payload.
+  /// For 'C' and 'D' the length is the payload size in bytes.
+  /// For 'R' the payload is one value and the length is the repeat count.
+  class Bus_Recorder : public IBus
+  {
+  public:
+    struct config_t
+    {
+      IBus* target = nullptr;       // bus that receives the calls too (optional)
+      FILE* output = nullptr;       // byte stream output (optional)
+      uint8_t window_command = 0x2C;// command counted as one setWindow (RAMWR, sent by every setWindow)
+    };
+
+    struct stats_t
+    {
+      uint32_t transactions = 0;
+      uint32_t commands = 0;
+      uint32_t windows = 0;         // number of window_command sent
+      uint32_t dma_queues = 0;      // addDMAQueue calls
+      uint64_t command_bytes = 0;
+      uint64_t data_bytes = 0;      // includes dma_bytes
+      uint64_t dma_bytes = 0;       // sent through addDMAQueue or writeBytes(use_dma)
+      uint64_t read_bytes = 0;
+
+      uint64_t total_bytes(void) const { return command_bytes + data_bytes; }
+    };
+
+    const config_t& config(void) const { return _cfg; }
+    void config(const config_t& cfg) { _cfg = cfg; }
+
+    const stats_t& getStats(void) const { return _stats; }
+    void resetStats(void) { _stats = stats_t(); }
+
+    bus_type_t busType(void) const override { return _cfg.target ? _cfg.target->busType() : bus_type_t::bus_spi; }
+
+    bool init(void) override { return _cfg.target ? _cfg.target->init() : true; }
+    void release(void) override;
+
+    uint32_t getClock(void) const override { return _cfg.target ? _cfg.target->getClock() : 0; }
+    uint32_t getReadClock(void) const override { return _cfg.target ? _cfg.target->getReadClock() : 0; }
+    void setClock(uint32_t freq) override { if (_cfg.target) { _cfg.target->setClock(freq); } }
+    void setReadClock(uint32_t freq) override { if (_cfg.target) { _cfg.target->setReadClock(freq); } }
+
+    void beginTransaction(void) override;
+    void endTransaction(void) override { if (_cfg.target) { _cfg.target->endTransaction(); } }
+    void wait(void) override { if (_cfg.target) { _cfg.target->wait(); } }
+    bool busy(void) const override { return _cfg.target ? _cfg.target->busy() : false; }
+
+    void initDMA(void) override { if (_cfg.target) { _cfg.target->initDMA(); } }
+    void addDMAQueue(const uint8_t* data, uint32_t length) override;
+    void execDMAQueue(void) override { if (_cfg.target) { _cfg.target->execDMAQueue(); } }
+    uint8_t* getDMABuffer(uint32_t length) override { return _cfg.target ? _cfg.target->getDMABuffer(length) : _flip_buffer.getBuffer(length); }
+
+    void flush(void) override { if (_cfg.target) { _cfg.target->flush(); } }
+    bool writeCommand(uint32_t data, uint_fast8_t bit_length) override;
+    void writeData(uint32_t data, uint_fast8_t bit_length) override;
+    void writeDataRepeat(uint32_t data, uint_fast8_t bit_length, uint32_t count) override;
+    void writePixels(pixelcopy_t* pc, uint32_t length) override;
+    void writeBytes(const uint8_t* data, uint32_t length, bool dc, bool use_dma) override;
+
+    void beginRead(void) override { if (_cfg.target) { _cfg.target->beginRead(); } }
+    void endRead(void) override { if (_cfg.target) { _cfg.target->endRead(); } }
+    uint32_t readData(uint_fast8_t bit_length) override;
+    bool readBytes(uint8_t* dst, uint32_t length, bool use_dma) override;
+    void readPixels(void* dst, pixelcopy_t* pc, uint32_t length) override;
+
+  private:
+    void record(char kind, uint_fast8_t bit_length, uint32_t length, const void* payload, size_t payload_size);
+
+    config_t _cfg;
+    stats_t _stats;
+    FlipBuffer _flip_buffer;
+    SimpleBuffer _pixel_buffer;
+  };
+
+//----------------------------------------------------------------------------
+ }
+}
@@ -0,0 +1,167 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+
+#include "WorkerPool.hpp"
+
+#include "../platforms/common.hpp"
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  void WorkerPool::exec_band(size_t index, uint8_t thread)
+  {
+    int32_t y0 = _y + (int32_t)((int64_t)_h *  index      / _band_count);
+    int32_t y1 = _y + (int32_t)((int64_t)_h * (index + 1) / _band_count);
+    auto& t = _band_times[index];
+    t.y = y0;
+    t.h = y1 - y0;
+    t.thread = thread;
+    uint32_t start = lgfx::micros();
+    _func(_arg, y0, y1 - y0);
+    t.usec = lgfx::micros() - start;
+  }
+
+#if LGFX_USE_WORKER_THREADS
+
+  bool WorkerPool::init(size_t threads)
+  {
+    release();
+    if (threads > max_bands - 1) { threads = max_bands - 1; }
+    _quit = false;
+    for (size_t i = 0; i < threads; ++i)
+    {
+      _threads[i] = std::thread(&WorkerPool::worker, this, (uint8_t)(i + 1));
+    }
+    _thread_count = threads;
+    return threads != 0;
+  }
+
+  void WorkerPool::release(void)
+  {
+    if (_thread_count == 0) { return; }
+    {
+      std::lock_guard<std::mutex> lock(_mtx);
+      _quit = true;
+    }
+    _cv_start.notify_all();
+    for (size_t i = 0; i < _thread_count; ++i)
+    {
+      _threads[i].join();
+    }
+    _thread_count = 0;
+  }
+
+  bool WorkerPool::take_band(uint32_t generation, size_t* index)
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    // 前回のrunの帯を取得しないよう、世代が変わっていれば終了する;
+    if (generation != _generation || _next_band >= _band_count) { return false; }
+    *index = _next_band++;
+    return true;
+  }
+
+  void WorkerPool::worker(uint8_t thread)
+  {
+    uint32_t generation = 0;
+    for (;;)
+    {
+      {
+        std::unique_lock<std::mutex> lock(_mtx);
+        _cv_start.wait(lock, [&]{ return _quit || generation != _generation; });
+        if (_quit) { return; }
+        generation = _generation;
+      }
+      size_t index;
+      while (take_band(generation, &index))
+      {
+        exec_band(index, thread);
+        std::lock_guard<std::mutex> lock(_mtx);
+        if (--_remain == 0) { _cv_done.notify_one(); }
+      }
+    }
+  }
+
+  void WorkerPool::run(int32_t y, int32_t h, band_func_t func, void* arg, int32_t min_rows)
+  {
+    if (h <= 0) { return; }
+    size_t bands = (min_rows > 1) ? h / min_rows : h;
+    if (bands > _thread_count + 1) { bands = _thread_count + 1; }
+    if (bands < 1) { bands = 1; }
+    uint32_t generation;
+    {
+      std::lock_guard<std::mutex> lock(_mtx);
+      _func = func;
+      _arg = arg;
+      _y = y;
+      _h = h;
+      _band_count = bands;
+      if (bands == 1)
+      { // 分割しない場合はワーカーを起こさない;
+        _next_band = 1;
+        generation = _generation;
+      }
+      else
+      {
+        _next_band = 0;
+        _remain = bands;
+        generation = ++_generation;
+      }
+    }
+    if (bands == 1)
+    {
+      exec_band(0, 0);
+      return;
+    }
+    ++_run_count;
+    _cv_start.notify_all();
+
+    size_t index;
+    while (take_band(generation, &index))
+    {
+      exec_band(index, 0);
+      std::lock_guard<std::mutex> lock(_mtx);
+      --_remain;
+    }
+    std::unique_lock<std::mutex> lock(_mtx);
+    _cv_done.wait(lock, [this]{ return _remain == 0; });
+  }
+
+#else
+
+  bool WorkerPool::init(size_t) { return false; }
+  void WorkerPool::release(void) {}
+
+  void WorkerPool::run(int32_t y, int32_t h, band_func_t func, void* arg, int32_t)
+  {
+    if (h <= 0) { return; }
+    _func = func;
+    _arg = arg;
+    _y = y;
+    _h = h;
+    _band_count = 1;
+    exec_band(0, 0);
+  }
+
+#endif
+
+//----------------------------------------------------------------------------
+ }
+}
@@ -0,0 +1,115 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#if !defined (LGFX_USE_WORKER_THREADS)
+ #if defined (ESP_PLATFORM) || defined (ARDUINO) || defined (USE_PICO_SDK) || defined (STM32F2xx) || defined (STM32F4xx) || defined (STM32F7xx)
+  #define LGFX_USE_WORKER_THREADS 0
+ #else
+  #define LGFX_USE_WORKER_THREADS 1
+ #endif
+#endif
+
+#if LGFX_USE_WORKER_THREADS
+ #include <thread>
+ #include <mutex>
+ #include <condition_variable>
+#endif
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  /// @brief 描画を横方向の帯に分割して並列に処理するスレッドプール (ホスト環境用);
+  /// run() splits a range of rows into bands and calls the band function for each of them.
+  /// The calling thread draws bands too, and run() returns when all bands are done.
+  /// Without thread support (LGFX_USE_WORKER_THREADS == 0) init() fails and run() draws
+  /// the bands one by one.
+  /// Panels that take a pool with setWorkerPool(): Panel_FrameBufferBase and its derived
+  /// panels (Panel_sdl, Panel_Headless) and Panel_fb.  Panel_OpenCV has no writeBands,
+  /// so drawing on it stays on the calling thread.
+  class WorkerPool
+  {
+  public:
+    static constexpr size_t max_bands = 16;
+
+    typedef void (*band_func_t)(void* arg, int32_t y, int32_t h);
+
+    struct band_time_t
+    {
+      int32_t y = 0;
+      int32_t h = 0;
+      uint32_t usec = 0;   // time spent in the band function
+      uint8_t thread = 0;  // 0 = calling thread, 1~ = worker thread
+    };
+
+    WorkerPool(void) = default;
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    ~WorkerPool(void) { release(); }
+
+    /// Starts the worker threads.  threads does not include the calling thread.
+    bool init(size_t threads);
+    void release(void);
+
+    size_t getThreadCount(void) const { return _thread_count; }
+
+    /// Calls func for bands of at least min_rows rows covering y ~ y+h-1.
+    void run(int32_t y, int32_t h, band_func_t func, void* arg, int32_t min_rows = 8);
+
+    /// Timings of the bands of the last run().
+    size_t getBandCount(void) const { return _band_count; }
+    const band_time_t* getBandTimes(void) const { return _band_times; }
+    /// Number of run() calls that were split into two or more bands.
+    uint32_t getRunCount(void) const { return _run_count; }
+
+  private:
+    void exec_band(size_t index, uint8_t thread);
+
+    band_func_t _func = nullptr;
+    void* _arg = nullptr;
+    int32_t _y = 0;
+    int32_t _h = 0;
+    size_t _band_count = 0;
+    size_t _thread_count = 0;
+    uint32_t _run_count = 0;
+    band_time_t _band_times[max_bands];
+
+#if LGFX_USE_WORKER_THREADS
+    void worker(uint8_t thread);
+    bool take_band(uint32_t generation, size_t* index);
+
+    std::thread _threads[max_bands - 1];
+    std::mutex _mtx;
+    std::condition_variable _cv_start;
+    std::condition_variable _cv_done;
+    uint32_t _generation = 0;
+    size_t _next_band = 0;
+    size_t _remain = 0;
+    bool _quit = false;
+#endif
+  };
+
+//----------------------------------------------------------------------------
+ }
+}
@@ -265,6 +265,31 @@ namespace lgfx
       return index;
     }
 
+    uint32_t pixelcopy_t::compare_bit_border_affine(void* __restrict dst, uint32_t index, uint32_t last, pixelcopy_t* __restrict param)
+    {
+      auto s = static_cast<const uint8_t*>(param->src_data);
+      auto d = static_cast<bool*>(dst);
+      auto src_x32     = param->src_x32;
+      auto src_y32     = param->src_y32;
+      auto src_x32_add = param->src_x32_add;
+      auto src_y32_add = param->src_y32_add;
+      auto src_bitwidth= param->src_bitwidth;
+      auto border      = param->transp;
+      auto fill        = param->fore_rgb888;
+      auto src_bits    = param->src_bits;
+      auto src_mask    = param->src_mask;
+      do {
+        uint32_t i = ((src_x32 >> FP_SCALE) + (src_y32 >> FP_SCALE) * src_bitwidth) * src_bits;
+        uint32_t raw = (pgm_read_byte(&s[i >> 3]) >> (-(int32_t)(i + src_bits) & 7)) & src_mask;
+        d[index] = (raw != border) && (raw != fill);
+        src_x32 += src_x32_add;
+        src_y32 += src_y32_add;
+      } while (++index != last);
+      param->src_x32 = src_x32;
+      param->src_y32 = src_y32;
+      return index;
+    }
+
 //----------------------------------------------------------------------------
   }
 }
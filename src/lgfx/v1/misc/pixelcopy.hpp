@@ -21,12 +21,44 @@ Contributors:
 
 #include "colortype.hpp"
 
+// NEON の経路は ARM 実機で結果を確認していないため、既定では無効とする (-DLGFX_PIXELCOPY_SIMD=1 で有効)
+#if !defined (LGFX_PIXELCOPY_SIMD)
+ #if defined (__SSE2__) || defined (_M_X64)
+  #define LGFX_PIXELCOPY_SIMD 1
+ #else
+  #define LGFX_PIXELCOPY_SIMD 0
+ #endif
+#endif
+
 namespace lgfx
 {
  inline namespace v1
  {
 //----------------------------------------------------------------------------
 
+  /// Vectorized loops for the format pairs that dominate on PC builds (SDL / framebuffer / OpenCV).
+  /// copy / blend process a multiple of the vector width from the head of a run of contiguous pixels
+  /// and return the count. The rest is left to the scalar loop, and the results are bit-identical to it.
+  /// They are on by default for SSE2; the NEON versions are built only with LGFX_PIXELCOPY_SIMD=1.
+  /// Build with LGFX_PIXELCOPY_SIMD=0 to disable them.
+  struct pixelcopy_simd_none_t
+  {
+    static constexpr uint32_t copy (void*, const void*, uint32_t) { return 0; }
+    static constexpr uint32_t blend(void*, const void*, uint32_t) { return 0; }
+  };
+
+  template <typename TDst, typename TSrc>
+  struct pixelcopy_simd_t : public pixelcopy_simd_none_t {};
+
+#if LGFX_PIXELCOPY_SIMD
+  template <> struct pixelcopy_simd_t<bgr888_t  , swap565_t > : public pixelcopy_simd_none_t { static uint32_t copy (void* dst, const void* src, uint32_t len); };
+  template <> struct pixelcopy_simd_t<swap565_t , bgr888_t  > : public pixelcopy_simd_none_t { static uint32_t copy (void* dst, const void* src, uint32_t len); };
+  template <> struct pixelcopy_simd_t<argb8888_t, bgr888_t  > : public pixelcopy_simd_none_t { static uint32_t copy (void* dst, const void* src, uint32_t len); };
+  template <> struct pixelcopy_simd_t<bgr888_t  , argb8888_t> : public pixelcopy_simd_none_t { static uint32_t copy (void* dst, const void* src, uint32_t len);
+                                                                                            static uint32_t blend(void* dst, const void* src, uint32_t len); };
+  template <> struct pixelcopy_simd_t<swap565_t , argb8888_t> : public pixelcopy_simd_none_t { static uint32_t blend(void* dst, const void* src, uint32_t len); };
+#endif
+
   struct pixelcopy_t
   {
     static constexpr uint32_t FP_SCALE = 16;
@@ -80,7 +112,7 @@ namespace lgfx
     const void* palette = nullptr;
     uint32_t (*fp_copy)(void*, uint32_t, uint32_t, pixelcopy_t*) = nullptr;
     uint32_t (*fp_skip)(       uint32_t, uint32_t, pixelcopy_t*) = nullptr;
-    uint32_t fore_rgb888 = 0xFFFFFF;  // for copy_gray
+    uint32_t fore_rgb888 = 0xFFFFFF;  // for copy_gray / compare_*_border_affine
     uint32_t back_rgb888 = 0;         // for copy_gray
     uint8_t src_mask  = ~0;
     uint8_t dst_mask  = ~0;
@@ -100,6 +132,7 @@ namespace lgfx
     static uint32_t copy_alpha_affine(void* __restrict dst, uint32_t index, uint32_t last, pixelcopy_t* __restrict param);
     static uint32_t blend_palette_fast(void* __restrict dst, uint32_t index, uint32_t last, pixelcopy_t* __restrict param);
     static uint32_t compare_bit_affine(void* __restrict dst, uint32_t index, uint32_t last, pixelcopy_t* __restrict param);
+    static uint32_t compare_bit_border_affine(void* __restrict dst, uint32_t index, uint32_t last, pixelcopy_t* __restrict param);
     static uint32_t skip_bit_affine(uint32_t index, uint32_t last, pixelcopy_t* param);
 
     template<typename TSrc>
@@ -170,9 +203,13 @@ namespace lgfx
       }
       else
       {
-        do {
-          d[index].set(color_convert<TDst, TSrc>(s[index].get()));
-        } while (++index != last);
+        index += pixelcopy_simd_t<TDst, TSrc>::copy(&d[index], &s[index], last - index);
+        if (index != last)
+        {
+          do {
+            d[index].set(color_convert<TDst, TSrc>(s[index].get()));
+          } while (++index != last);
+        }
       }
       return last;
     }
@@ -250,6 +287,21 @@ namespace lgfx
       auto src_y32_add = param->src_y32_add;
       auto src_x32 = param->src_x32;
       auto src_y32 = param->src_y32;
+      if (((src_x32_add | src_y32_add) & ((1 << FP_SCALE) - 1)) == 0)
+      { // 0/90/180/270度で縮小率が整数の場合、転送元の位置は一定の間隔で進むため、位置の計算を省く;
+        uint32_t i = (src_x32 >> FP_SCALE) + (src_y32 >> FP_SCALE) * src_bitwidth;
+        int32_t step = ((int32_t)src_x32_add >> FP_SCALE) + ((int32_t)src_y32_add >> FP_SCALE) * (int32_t)src_bitwidth;
+        uint32_t start = index;
+        do {
+          uint32_t raw = s[i].get();
+          if (raw == param->transp) break;
+          d[index].set(color_convert<TDst, TSrc>(raw));
+          i += step;
+        } while (++index != last);
+        param->src_x32 = src_x32 + src_x32_add * (index - start);
+        param->src_y32 = src_y32 + src_y32_add * (index - start);
+        return index;
+      }
       do {
         uint32_t i = (src_x32 >> FP_SCALE) + (src_y32 >> FP_SCALE) * src_bitwidth;
         uint32_t raw = s[i].get();
@@ -504,6 +556,16 @@ namespace lgfx
       auto src_x32_add = param->src_x32_add;
       auto src_y32_add = param->src_y32_add;
       auto s = static_cast<const TSrc*>(param->src_data);
+      if (src_x32_add == (1u << FP_SCALE) && src_y32_add == 0)
+      { // the source pixels are contiguous.
+        uint32_t len = pixelcopy_simd_t<TDst, TSrc>::blend(&d[index], &s[param->src_x + param->src_y * param->src_bitwidth], last - index);
+        if (len)
+        {
+          param->src_x32 += len << FP_SCALE;
+          index += len;
+          if (index == last) return last;
+        }
+      }
       for (;;) {
         uint32_t i = param->src_x + param->src_y * param->src_bitwidth;
         uint_fast16_t a = s[i].a;
@@ -573,6 +635,31 @@ namespace lgfx
       param->src_y32 = src_y32;
       return index;
     }
+
+    // transp = border raw, fore_rgb888 = fill raw. true for pixels matching neither.
+    template <typename TSrc>
+    static uint32_t compare_rgb_border_affine(void* __restrict dst, uint32_t index, uint32_t last, pixelcopy_t* __restrict param)
+    {
+      auto s = static_cast<const TSrc*>(param->src_data);
+      auto d = static_cast<bool*>(dst);
+      auto src_x32     = param->src_x32;
+      auto src_y32     = param->src_y32;
+      auto src_x32_add = param->src_x32_add;
+      auto src_y32_add = param->src_y32_add;
+      auto src_bitwidth= param->src_bitwidth;
+      auto border      = param->transp;
+      auto fill        = param->fore_rgb888;
+      do {
+        uint32_t i = (src_x32 >> FP_SCALE) + (src_y32 >> FP_SCALE) * src_bitwidth;
+        uint32_t raw = s[i].get();
+        d[index] = (raw != border) && (raw != fill);
+        src_x32 += src_x32_add;
+        src_y32 += src_y32_add;
+      } while (++index != last);
+      param->src_x32 = src_x32;
+      param->src_y32 = src_y32;
+      return index;
+    }
   };
 
 //----------------------------------------------------------------------------
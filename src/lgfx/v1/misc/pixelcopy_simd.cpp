@@ -0,0 +1,484 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+
+#include "pixelcopy.hpp"
+
+#if LGFX_PIXELCOPY_SIMD
+
+#if defined (__ARM_NEON)
+ #include <arm_neon.h>
+#else
+ #include <emmintrin.h>
+ #if defined (__SSSE3__)
+  #include <tmmintrin.h>
+ #endif
+ #if defined (__AVX2__)
+  #include <immintrin.h>
+ #endif
+#endif
+
+/// Every kernel here is a vectorized form of the scalar color_convert / blend_rgb_fast expression
+/// for the same pair, so the output must stay bit-identical to them.
+///
+/// blend : out = (dst * (256 - a) + src * (a + 1)) >> 8
+///  a == 255 gives src and a == 0 gives dst (re-truncated to the same bits),
+///  which is what the scalar loop produces by its early-outs. The sum never exceeds 0xFFFF.
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+#if defined (__ARM_NEON)
+
+  // 16bit lanes of 8bit channels <- swap565
+  static inline void unpack_swap565(uint16x8_t v, uint16x8_t& r, uint16x8_t& g, uint16x8_t& b)
+  {
+    uint16x8_t r5 = vandq_u16(vshrq_n_u16(v, 3), vdupq_n_u16(0x1F));
+    uint16x8_t b5 = vandq_u16(vshrq_n_u16(v, 8), vdupq_n_u16(0x1F));
+    uint16x8_t g6 = vorrq_u16(vshlq_n_u16(vandq_u16(v, vdupq_n_u16(7)), 3), vshrq_n_u16(v, 13));
+    r = vorrq_u16(vshlq_n_u16(r5, 3), vshrq_n_u16(r5, 2));
+    b = vorrq_u16(vshlq_n_u16(b5, 3), vshrq_n_u16(b5, 2));
+    g = vorrq_u16(vshlq_n_u16(g6, 2), vshrq_n_u16(g6, 4));
+  }
+
+  // swap565 <- 16bit lanes of 8bit channels
+  static inline uint16x8_t pack_swap565(uint16x8_t r, uint16x8_t g, uint16x8_t b)
+  {
+    uint16x8_t lo = vorrq_u16(vshrq_n_u16(g, 5), vandq_u16(r, vdupq_n_u16(0xF8)));
+    uint16x8_t hi = vorrq_u16(vshlq_n_u16(vandq_u16(b, vdupq_n_u16(0xF8)), 5), vshlq_n_u16(vandq_u16(g, vdupq_n_u16(0x1C)), 11));
+    return vorrq_u16(lo, hi);
+  }
+
+  static inline uint16x8_t blend_channel(uint16x8_t d, uint16x8_t s, uint16x8_t inv, uint16x8_t a1)
+  {
+    return vshrq_n_u16(vmlaq_u16(vmulq_u16(d, inv), s, a1), 8);
+  }
+
+  uint32_t pixelcopy_simd_t<bgr888_t, swap565_t>::copy(void* dst, const void* src, uint32_t len)
+  {
+    auto d = static_cast<uint8_t*>(dst);
+    auto s = static_cast<const uint16_t*>(src);
+    uint32_t i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+      uint16x8_t r0, g0, b0, r1, g1, b1;
+      unpack_swap565(vld1q_u16(&s[i    ]), r0, g0, b0);
+      unpack_swap565(vld1q_u16(&s[i + 8]), r1, g1, b1);
+      uint8x16x3_t rgb;
+      rgb.val[0] = vcombine_u8(vmovn_u16(r0), vmovn_u16(r1));
+      rgb.val[1] = vcombine_u8(vmovn_u16(g0), vmovn_u16(g1));
+      rgb.val[2] = vcombine_u8(vmovn_u16(b0), vmovn_u16(b1));
+      vst3q_u8(&d[i * 3], rgb);
+    }
+    return i;
+  }
+
+  uint32_t pixelcopy_simd_t<swap565_t, bgr888_t>::copy(void* dst, const void* src, uint32_t len)
+  {
+    auto d = static_cast<uint16_t*>(dst);
+    auto s = static_cast<const uint8_t*>(src);
+    uint32_t i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+      uint8x16x3_t rgb = vld3q_u8(&s[i * 3]);
+      vst1q_u16(&d[i    ], pack_swap565(vmovl_u8(vget_low_u8 (rgb.val[0])), vmovl_u8(vget_low_u8 (rgb.val[1])), vmovl_u8(vget_low_u8 (rgb.val[2]))));
+      vst1q_u16(&d[i + 8], pack_swap565(vmovl_u8(vget_high_u8(rgb.val[0])), vmovl_u8(vget_high_u8(rgb.val[1])), vmovl_u8(vget_high_u8(rgb.val[2]))));
+    }
+    return i;
+  }
+
+  uint32_t pixelcopy_simd_t<argb8888_t, bgr888_t>::copy(void* dst, const void* src, uint32_t len)
+  {
+    auto d = static_cast<uint8_t*>(dst);
+    auto s = static_cast<const uint8_t*>(src);
+    uint32_t i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+      uint8x16x3_t rgb = vld3q_u8(&s[i * 3]);
+      uint8x16x4_t bgra;
+      bgra.val[0] = rgb.val[2];
+      bgra.val[1] = rgb.val[1];
+      bgra.val[2] = rgb.val[0];
+      bgra.val[3] = vdupq_n_u8(0xFF);
+      vst4q_u8(&d[i * 4], bgra);
+    }
+    return i;
+  }
+
+  uint32_t pixelcopy_simd_t<bgr888_t, argb8888_t>::copy(void* dst, const void* src, uint32_t len)
+  {
+    auto d = static_cast<uint8_t*>(dst);
+    auto s = static_cast<const uint8_t*>(src);
+    uint32_t i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+      uint8x16x4_t bgra = vld4q_u8(&s[i * 4]);
+      uint8x16x3_t rgb;
+      rgb.val[0] = bgra.val[2];
+      rgb.val[1] = bgra.val[1];
+      rgb.val[2] = bgra.val[0];
+      vst3q_u8(&d[i * 3], rgb);
+    }
+    return i;
+  }
+
+  uint32_t pixelcopy_simd_t<swap565_t, argb8888_t>::blend(void* dst, const void* src, uint32_t len)
+  {
+    auto d = static_cast<uint16_t*>(dst);
+    auto s = static_cast<const uint8_t*>(src);
+    uint32_t i = 0;
+    for (; i + 8 <= len; i += 8)
+    {
+      uint8x8x4_t bgra = vld4_u8(&s[i * 4]);
+      uint16x8_t a   = vmovl_u8(bgra.val[3]);
+      uint16x8_t inv = vsubq_u16(vdupq_n_u16(256), a);
+      uint16x8_t a1  = vaddq_u16(a, vdupq_n_u16(1));
+      uint16x8_t r, g, b;
+      unpack_swap565(vld1q_u16(&d[i]), r, g, b);
+      r = blend_channel(r, vmovl_u8(bgra.val[2]), inv, a1);
+      g = blend_channel(g, vmovl_u8(bgra.val[1]), inv, a1);
+      b = blend_channel(b, vmovl_u8(bgra.val[0]), inv, a1);
+      vst1q_u16(&d[i], pack_swap565(r, g, b));
+    }
+    return i;
+  }
+
+  uint32_t pixelcopy_simd_t<bgr888_t, argb8888_t>::blend(void* dst, const void* src, uint32_t len)
+  {
+    auto d = static_cast<uint8_t*>(dst);
+    auto s = static_cast<const uint8_t*>(src);
+    uint32_t i = 0;
+    for (; i + 8 <= len; i += 8)
+    {
+      uint8x8x4_t bgra = vld4_u8(&s[i * 4]);
+      uint8x8x3_t rgb = vld3_u8(&d[i * 3]);
+      uint16x8_t a   = vmovl_u8(bgra.val[3]);
+      uint16x8_t inv = vsubq_u16(vdupq_n_u16(256), a);
+      uint16x8_t a1  = vaddq_u16(a, vdupq_n_u16(1));
+      rgb.val[0] = vmovn_u16(blend_channel(vmovl_u8(rgb.val[0]), vmovl_u8(bgra.val[2]), inv, a1));
+      rgb.val[1] = vmovn_u16(blend_channel(vmovl_u8(rgb.val[1]), vmovl_u8(bgra.val[1]), inv, a1));
+      rgb.val[2] = vmovn_u16(blend_channel(vmovl_u8(rgb.val[2]), vmovl_u8(bgra.val[0]), inv, a1));
+      vst3_u8(&d[i * 3], rgb);
+    }
+    return i;
+  }
+
+#else // SSE2
+
+  static inline __m128i set1_16(int v) { return _mm_set1_epi16((short)v); }
+  static inline __m128i set1_32(uint32_t v) { return _mm_set1_epi32((int)v); }
+
+  /// 16 pixels of 3 byte RGB (48 byte) -> 4 x 4 lanes of (r | g << 8 | b << 16)
+  static inline void load_rgb24x16(const uint8_t* s, __m128i p[4])
+  {
+    __m128i v0 = _mm_loadu_si128((const __m128i*)&s[ 0]);
+    __m128i v1 = _mm_loadu_si128((const __m128i*)&s[16]);
+    __m128i v2 = _mm_loadu_si128((const __m128i*)&s[32]);
+#if defined (__SSSE3__)
+    const __m128i shuf = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    p[0] = _mm_shuffle_epi8(v0, shuf);
+    p[1] = _mm_shuffle_epi8(_mm_alignr_epi8(v1, v0, 12), shuf);
+    p[2] = _mm_shuffle_epi8(_mm_alignr_epi8(v2, v1,  8), shuf);
+    p[3] = _mm_shuffle_epi8(_mm_srli_si128(v2, 4), shuf);
+#else
+    __m128i g[4] = { v0
+                   , _mm_or_si128(_mm_srli_si128(v0, 12), _mm_slli_si128(v1, 4))
+                   , _mm_or_si128(_mm_srli_si128(v1,  8), _mm_slli_si128(v2, 8))
+                   , _mm_srli_si128(v2, 4) };
+    const __m128i m0 = _mm_setr_epi32(0xFFFFFF, 0, 0, 0);
+    const __m128i m1 = _mm_slli_si128(m0, 4);
+    const __m128i m2 = _mm_slli_si128(m0, 8);
+    const __m128i m3 = _mm_slli_si128(m0, 12);
+    for (int k = 0; k < 4; ++k)
+    {
+      p[k] = _mm_or_si128(_mm_or_si128(_mm_and_si128(g[k], m0)
+                                     , _mm_and_si128(_mm_slli_si128(g[k], 1), m1))
+                        , _mm_or_si128(_mm_and_si128(_mm_slli_si128(g[k], 2), m2)
+                                     , _mm_and_si128(_mm_slli_si128(g[k], 3), m3)));
+    }
+#endif
+  }
+
+  /// 4 x 4 lanes of (r | g << 8 | b << 16) -> 16 pixels of 3 byte RGB (48 byte). the top byte of the lanes is ignored.
+  static inline void store_rgb24x16(uint8_t* d, const __m128i p[4])
+  {
+    __m128i q[4];
+#if defined (__SSSE3__)
+    const __m128i shuf = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    for (int k = 0; k < 4; ++k) { q[k] = _mm_shuffle_epi8(p[k], shuf); }
+#else
+    const __m128i m0 = _mm_setr_epi32(0xFFFFFF, 0, 0, 0);
+    const __m128i m1 = _mm_slli_si128(m0, 4);
+    const __m128i m2 = _mm_slli_si128(m0, 8);
+    const __m128i m3 = _mm_slli_si128(m0, 12);
+    for (int k = 0; k < 4; ++k)
+    {
+      q[k] = _mm_or_si128(_mm_or_si128(_mm_and_si128(p[k], m0)
+                                     , _mm_srli_si128(_mm_and_si128(p[k], m1), 1))
+                        , _mm_or_si128(_mm_srli_si128(_mm_and_si128(p[k], m2), 2)
+                                     , _mm_srli_si128(_mm_and_si128(p[k], m3), 3)));
+    }
+#endif
+    _mm_storeu_si128((__m128i*)&d[ 0], _mm_or_si128(q[0], _mm_slli_si128(q[1], 12)));
+    _mm_storeu_si128((__m128i*)&d[16], _mm_or_si128(_mm_srli_si128(q[1], 4), _mm_slli_si128(q[2], 8)));
+    _mm_storeu_si128((__m128i*)&d[32], _mm_or_si128(_mm_srli_si128(q[2], 8), _mm_slli_si128(q[3], 4)));
+  }
+
+  /// swap the 1st and 3rd byte of each 32bit lane and clear the top byte. (argb8888 <-> 3 byte RGB lanes)
+  static inline __m128i swap_rb(__m128i p)
+  {
+    return _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(p, set1_32(0xFF)), 16)
+                                   , _mm_and_si128(_mm_srli_epi32(p, 16), set1_32(0xFF)))
+                      , _mm_and_si128(p, set1_32(0xFF00)));
+  }
+
+  /// 8 lanes of 16bit <- byte n of 2 x 4 lanes of 32bit
+  template <int n>
+  static inline __m128i channel16(__m128i p0, __m128i p1)
+  {
+    return _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, n * 8), set1_32(0xFF))
+                         , _mm_and_si128(_mm_srli_epi32(p1, n * 8), set1_32(0xFF)));
+  }
+
+  /// 16bit lanes of 8bit channels <- swap565
+  static inline void unpack_swap565(__m128i v, __m128i& r, __m128i& g, __m128i& b)
+  {
+    __m128i r5 = _mm_and_si128(_mm_srli_epi16(v, 3), set1_16(0x1F));
+    __m128i b5 = _mm_and_si128(_mm_srli_epi16(v, 8), set1_16(0x1F));
+    __m128i g6 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(v, set1_16(7)), 3), _mm_srli_epi16(v, 13));
+    r = _mm_or_si128(_mm_slli_epi16(r5, 3), _mm_srli_epi16(r5, 2));
+    b = _mm_or_si128(_mm_slli_epi16(b5, 3), _mm_srli_epi16(b5, 2));
+    g = _mm_or_si128(_mm_slli_epi16(g6, 2), _mm_srli_epi16(g6, 4));
+  }
+
+  /// swap565 <- 16bit lanes of 8bit channels
+  static inline __m128i pack_swap565(__m128i r, __m128i g, __m128i b)
+  {
+    __m128i lo = _mm_or_si128(_mm_srli_epi16(g, 5), _mm_and_si128(r, set1_16(0xF8)));
+    __m128i hi = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(b, set1_16(0xF8)), 5), _mm_slli_epi16(_mm_and_si128(g, set1_16(0x1C)), 11));
+    return _mm_or_si128(lo, hi);
+  }
+
+  static inline __m128i blend_channel(__m128i d, __m128i s, __m128i inv, __m128i a1)
+  {
+    return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(d, inv), _mm_mullo_epi16(s, a1)), 8);
+  }
+
+#if defined (__AVX2__)
+
+  static inline void unpack_swap565(__m256i v, __m256i& r, __m256i& g, __m256i& b)
+  {
+    const __m256i m1f = _mm256_set1_epi16(0x1F);
+    __m256i r5 = _mm256_and_si256(_mm256_srli_epi16(v, 3), m1f);
+    __m256i b5 = _mm256_and_si256(_mm256_srli_epi16(v, 8), m1f);
+    __m256i g6 = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(v, _mm256_set1_epi16(7)), 3), _mm256_srli_epi16(v, 13));
+    r = _mm256_or_si256(_mm256_slli_epi16(r5, 3), _mm256_srli_epi16(r5, 2));
+    b = _mm256_or_si256(_mm256_slli_epi16(b5, 3), _mm256_srli_epi16(b5, 2));
+    g = _mm256_or_si256(_mm256_slli_epi16(g6, 2), _mm256_srli_epi16(g6, 4));
+  }
+
+  static inline __m256i pack_swap565(__m256i r, __m256i g, __m256i b)
+  {
+    const __m256i mf8 = _mm256_set1_epi16(0xF8);
+    __m256i lo = _mm256_or_si256(_mm256_srli_epi16(g, 5), _mm256_and_si256(r, mf8));
+    __m256i hi = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(b, mf8), 5), _mm256_slli_epi16(_mm256_and_si256(g, _mm256_set1_epi16(0x1C)), 11));
+    return _mm256_or_si256(lo, hi);
+  }
+
+  static inline __m256i blend_channel(__m256i d, __m256i s, __m256i inv, __m256i a1)
+  {
+    return _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(d, inv), _mm256_mullo_epi16(s, a1)), 8);
+  }
+
+  /// 16 lanes of 16bit in pixel order <- byte n of 2 x 8 lanes of 32bit
+  template <int n>
+  static inline __m256i channel16(__m256i p0, __m256i p1)
+  {
+    const __m256i mff = _mm256_set1_epi32(0xFF);
+    __m256i c = _mm256_packs_epi32(_mm256_and_si256(_mm256_srli_epi32(p0, n * 8), mff)
+                                 , _mm256_and_si256(_mm256_srli_epi32(p1, n * 8), mff));
+    return _mm256_permute4x64_epi64(c, 0xD8);  // packs works per 128bit lane.
+  }
+
+#endif
+
+  uint32_t pixelcopy_simd_t<bgr888_t, swap565_t>::copy(void* dst, const void* src, uint32_t len)
+  {
+    auto d = static_cast<uint8_t*>(dst);
+    auto s = static_cast<const uint16_t*>(src);
+    uint32_t i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+      __m128i p[4];
+#if defined (__AVX2__)
+      __m256i r, g, b;
+      unpack_swap565(_mm256_loadu_si256((const __m256i*)&s[i]), r, g, b);
+      __m256i rg = _mm256_or_si256(r, _mm256_slli_epi16(g, 8));
+      __m256i lo = _mm256_unpacklo_epi16(rg, b);  // 0-3, 8-11
+      __m256i hi = _mm256_unpackhi_epi16(rg, b);  // 4-7, 12-15
+      p[0] = _mm256_castsi256_si128(lo);
+      p[1] = _mm256_castsi256_si128(hi);
+      p[2] = _mm256_extracti128_si256(lo, 1);
+      p[3] = _mm256_extracti128_si256(hi, 1);
+#else
+      for (int k = 0; k < 2; ++k)
+      {
+        __m128i r, g, b;
+        unpack_swap565(_mm_loadu_si128((const __m128i*)&s[i + k * 8]), r, g, b);
+        __m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+        p[k * 2    ] = _mm_unpacklo_epi16(rg, b);
+        p[k * 2 + 1] = _mm_unpackhi_epi16(rg, b);
+      }
+#endif
+      store_rgb24x16(&d[i * 3], p);
+    }
+    return i;
+  }
+
+  uint32_t pixelcopy_simd_t<swap565_t, bgr888_t>::copy(void* dst, const void* src, uint32_t len)
+  {
+    auto d = static_cast<uint8_t*>(dst);
+    auto s = static_cast<const uint8_t*>(src);
+    uint32_t i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+      __m128i p[4];
+      load_rgb24x16(&s[i * 3], p);
+      for (int k = 0; k < 4; ++k)
+      { // (px >> 13 & 7) | (px & 0xF8) | (px >> 11 & 0x1F00) | (px << 3 & 0xE000), sign extended for packs.
+        __m128i v = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p[k], 13), set1_32(0x0007))
+                                            , _mm_and_si128(p[k], set1_32(0x00F8)))
+                               , _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p[k], 11), set1_32(0x1F00))
+                                            , _mm_and_si128(_mm_slli_epi32(p[k],  3), set1_32(0xE000))));
+        p[k] = _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+      }
+      _mm_storeu_si128((__m128i*)&d[i * 2     ], _mm_packs_epi32(p[0], p[1]));
+      _mm_storeu_si128((__m128i*)&d[i * 2 + 16], _mm_packs_epi32(p[2], p[3]));
+    }
+    return i;
+  }
+
+  uint32_t pixelcopy_simd_t<argb8888_t, bgr888_t>::copy(void* dst, const void* src, uint32_t len)
+  {
+    auto d = static_cast<uint8_t*>(dst);
+    auto s = static_cast<const uint8_t*>(src);
+    uint32_t i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+      __m128i p[4];
+      load_rgb24x16(&s[i * 3], p);
+      for (int k = 0; k < 4; ++k)
+      {
+        _mm_storeu_si128((__m128i*)&d[(i + k * 4) * 4], _mm_or_si128(swap_rb(p[k]), set1_32(0xFF000000)));
+      }
+    }
+    return i;
+  }
+
+  uint32_t pixelcopy_simd_t<bgr888_t, argb8888_t>::copy(void* dst, const void* src, uint32_t len)
+  {
+    auto d = static_cast<uint8_t*>(dst);
+    auto s = static_cast<const uint8_t*>(src);
+    uint32_t i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+      __m128i p[4];
+      for (int k = 0; k < 4; ++k)
+      {
+        p[k] = swap_rb(_mm_loadu_si128((const __m128i*)&s[(i + k * 4) * 4]));
+      }
+      store_rgb24x16(&d[i * 3], p);
+    }
+    return i;
+  }
+
+  uint32_t pixelcopy_simd_t<swap565_t, argb8888_t>::blend(void* dst, const void* src, uint32_t len)
+  {
+    auto d = static_cast<uint8_t*>(dst);
+    auto s = static_cast<const uint8_t*>(src);
+    uint32_t i = 0;
+#if defined (__AVX2__)
+    for (; i + 16 <= len; i += 16)
+    {
+      __m256i s0 = _mm256_loadu_si256((const __m256i*)&s[i * 4     ]);
+      __m256i s1 = _mm256_loadu_si256((const __m256i*)&s[i * 4 + 32]);
+      __m256i a   = channel16<3>(s0, s1);
+      __m256i inv = _mm256_sub_epi16(_mm256_set1_epi16(256), a);
+      __m256i a1  = _mm256_add_epi16(a, _mm256_set1_epi16(1));
+      __m256i r, g, b;
+      unpack_swap565(_mm256_loadu_si256((const __m256i*)&d[i * 2]), r, g, b);
+      r = blend_channel(r, channel16<2>(s0, s1), inv, a1);
+      g = blend_channel(g, channel16<1>(s0, s1), inv, a1);
+      b = blend_channel(b, channel16<0>(s0, s1), inv, a1);
+      _mm256_storeu_si256((__m256i*)&d[i * 2], pack_swap565(r, g, b));
+    }
+#endif
+    for (; i + 8 <= len; i += 8)
+    {
+      __m128i s0 = _mm_loadu_si128((const __m128i*)&s[i * 4     ]);
+      __m128i s1 = _mm_loadu_si128((const __m128i*)&s[i * 4 + 16]);
+      __m128i a   = channel16<3>(s0, s1);
+      __m128i inv = _mm_sub_epi16(set1_16(256), a);
+      __m128i a1  = _mm_add_epi16(a, set1_16(1));
+      __m128i r, g, b;
+      unpack_swap565(_mm_loadu_si128((const __m128i*)&d[i * 2]), r, g, b);
+      r = blend_channel(r, channel16<2>(s0, s1), inv, a1);
+      g = blend_channel(g, channel16<1>(s0, s1), inv, a1);
+      b = blend_channel(b, channel16<0>(s0, s1), inv, a1);
+      _mm_storeu_si128((__m128i*)&d[i * 2], pack_swap565(r, g, b));
+    }
+    return i;
+  }
+
+  uint32_t pixelcopy_simd_t<bgr888_t, argb8888_t>::blend(void* dst, const void* src, uint32_t len)
+  {
+    auto d = static_cast<uint8_t*>(dst);
+    auto s = static_cast<const uint8_t*>(src);
+    uint32_t i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+      __m128i p[4];
+      load_rgb24x16(&d[i * 3], p);
+      for (int k = 0; k < 4; k += 2)
+      {
+        __m128i s0 = _mm_loadu_si128((const __m128i*)&s[(i + k * 4) * 4     ]);
+        __m128i s1 = _mm_loadu_si128((const __m128i*)&s[(i + k * 4) * 4 + 16]);
+        __m128i a   = channel16<3>(s0, s1);
+        __m128i inv = _mm_sub_epi16(set1_16(256), a);
+        __m128i a1  = _mm_add_epi16(a, set1_16(1));
+        __m128i r = blend_channel(channel16<0>(p[k], p[k + 1]), channel16<2>(s0, s1), inv, a1);
+        __m128i g = blend_channel(channel16<1>(p[k], p[k + 1]), channel16<1>(s0, s1), inv, a1);
+        __m128i b = blend_channel(channel16<2>(p[k], p[k + 1]), channel16<0>(s0, s1), inv, a1);
+        __m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+        p[k    ] = _mm_unpacklo_epi16(rg, b);
+        p[k + 1] = _mm_unpackhi_epi16(rg, b);
+      }
+      store_rgb24x16(&d[i * 3], p);
+    }
+    return i;
+  }
+
+#endif
+
+//----------------------------------------------------------------------------
+ }
+}
+
+#endif
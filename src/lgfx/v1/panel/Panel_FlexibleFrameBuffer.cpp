@@ -115,17 +115,121 @@ namespace lgfx
   void Panel_FlexibleFrameBuffer::_fill_rect_inner(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor)
   {
     h += y;
-    uint_fast16_t ie = x + w;
     do
     {
-      auto i = x;
-      do
-      {
-        _draw_pixel_inner(i, y, rawcolor);
-      } while (++i != ie);
+      _fill_span_inner(x, y, w, rawcolor);
     } while (++y < h);
   }
 
+  void Panel_FlexibleFrameBuffer::_fill_span_inner(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint32_t rawcolor)
+  {
+    uint_fast16_t xe = x + w;
+    do
+    {
+      _draw_pixel_inner(x, y, rawcolor);
+    } while (++x != xe);
+  }
+
+  void Panel_FlexibleFrameBuffer::_copy_span_inner(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, const uint8_t* pixels)
+  {
+    size_t bytes = _write_bits >> 3;
+    uint_fast16_t xe = x + w;
+    do
+    {
+      uint32_t raw = *pixels++;
+      for (size_t by = 1; by < bytes; ++by)
+      {
+        raw += (*pixels++) << (by * 8);
+      }
+      _draw_pixel_inner(x, y, raw);
+    } while (++x != xe);
+  }
+
+  void Panel_FlexibleFrameBuffer::_read_span_inner(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint8_t* pixels)
+  {
+    size_t bytes = _read_bits >> 3;
+    uint_fast16_t xe = x + w;
+    do
+    {
+      uint32_t raw = _read_pixel_inner(x, y);
+      *pixels++ = raw;
+      for (size_t by = 1; by < bytes; ++by)
+      {
+        *pixels++ = raw >>= 8;
+      }
+    } while (++x != xe);
+  }
+
+  static void reverse_pixels(uint8_t* pixels, uint_fast16_t w, size_t bytes)
+  {
+    auto l = pixels;
+    auto r = &pixels[(w - 1) * bytes];
+    while (l < r)
+    {
+      for (size_t by = 0; by < bytes; ++by) { std::swap(l[by], r[by]); }
+      l += bytes;
+      r -= bytes;
+    }
+  }
+
+  void Panel_FlexibleFrameBuffer::_write_span(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint8_t* pixels)
+  {
+    uint_fast8_t r = _rotation;
+    if (r)
+    {
+      if ((1u << r) & 0b10010110) { y = _height - (y + 1); }
+      if (r & 2)                  { x = _width  - (x + w); reverse_pixels(pixels, w, _write_bits >> 3); }
+      if (r & 1)
+      { /// 描画座標の1行はパネル上では1列になるので、1ピクセルずつ処理する;
+        size_t bytes = _write_bits >> 3;
+        uint_fast16_t xe = x + w;
+        do
+        {
+          uint32_t raw = *pixels++;
+          for (size_t by = 1; by < bytes; ++by)
+          {
+            raw += (*pixels++) << (by * 8);
+          }
+          _draw_pixel_inner(y, x, raw);
+        } while (++x != xe);
+        return;
+      }
+    }
+    _copy_span_inner(x, y, w, pixels);
+  }
+
+  void Panel_FlexibleFrameBuffer::_read_span(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint8_t* pixels)
+  {
+    uint_fast8_t r = _rotation;
+    if (r)
+    {
+      if ((1u << r) & 0b10010110) { y = _height - (y + 1); }
+      if (r & 2)                  { x = _width  - (x + w); }
+      if (r & 1)
+      {
+        size_t bytes = _read_bits >> 3;
+        auto buf = pixels;
+        uint_fast16_t xe = x + w;
+        do
+        {
+          uint32_t raw = _read_pixel_inner(y, x);
+          *buf++ = raw;
+          for (size_t by = 1; by < bytes; ++by)
+          {
+            *buf++ = raw >>= 8;
+          }
+        } while (++x != xe);
+      }
+      else
+      {
+        _read_span_inner(x, y, w, pixels);
+      }
+      if (r & 2) { reverse_pixels(pixels, w, _read_bits >> 3); }
+      return;
+    }
+    _read_span_inner(x, y, w, pixels);
+  }
+
   void Panel_FlexibleFrameBuffer::writeBlock(uint32_t rawcolor, uint32_t length)
   {
     do
@@ -153,55 +257,23 @@ namespace lgfx
     uint_fast16_t ye = _ye;
     uint_fast16_t x = _xpos;
     uint_fast16_t y = _ypos;
-    // const size_t bits = _write_bits;
-    // auto k = _bitwidth * bits >> 3;
-
-    uint_fast8_t r = _rotation;
-
-    int_fast16_t ax = 1;
-    int_fast16_t ay = 1;
-    if ((1u << r) & 0b10010110) { y = _height - (y + 1); ys = _height - (ys + 1); ye = _height - (ye + 1); ay = -1; }
-    if (r & 2)                  { x = _width  - (x + 1); xs = _width  - (xs + 1); xe = _width  - (xe + 1); ax = -1; }
+    size_t bytes = _write_bits >> 3;
+    auto pixelbuf = (uint8_t*)alloca(((xe - xs + 1) * bytes + 7) & ~3);
 
-    uint32_t rawcolor;
-    if (r & 1)
-    {
-      do
-      {
-        param->fp_copy(&rawcolor, 0, 1, param);
-        /// xとyを入れ替えて処理する;
-        _draw_pixel_inner(y, x, rawcolor);
-        if (x != xe)
-        {
-          x += ax;
-        }
-        else
-        {
-          x = xs;
-          y = (y != ye) ? (y + ay) : ys;
-        }
-      } while (--length);
-    }
-    else
+    /// ウィンドウの1行ずつまとめて変換して書き込む;
+    uint_fast16_t linelength;
+    do
     {
-      do
+      linelength = std::min<uint32_t>(xe - x + 1, length);
+      param->fp_copy(pixelbuf, 0, linelength, param);
+      _write_span(x, y, linelength, pixelbuf);
+      if ((x += linelength) > xe)
       {
-        param->fp_copy(&rawcolor, 0, 1, param);
-        _draw_pixel_inner(x, y, rawcolor);
-        if (x != xe)
-        {
-          x += ax;
-        }
-        else
-        {
-          x = xs;
-          y = (y != ye) ? (y + ay) : ys;
-        }
-      } while (--length);
-    }
+        x = xs;
+        y = (y != ye) ? (y + 1) : ys;
+      }
+    } while (length -= linelength);
 
-    if ((1u << r) & 0b10010110) { y = _height - (y + 1); }
-    if (r & 2)                  { x = _width  - (x + 1); }
     _xpos = x;
     _ypos = y;
   }
@@ -217,22 +289,13 @@ namespace lgfx
     do
     {
       uint32_t pos = 0;
-      uint32_t raw;
       do
       {
         auto pos2 = param->fp_copy(pixelbuf, pos, w, param);
         if (pos != pos2)
         {
-          uint8_t* buf = &pixelbuf[pos * bytes];
-          do
-          {
-            raw = *buf++;
-            for (size_t by = 1; by < bytes; ++by)
-            {
-              raw += (*buf++) << (by * 8);
-            }
-            drawPixelPreclipped(x + pos, y, raw);
-          } while (++pos != pos2);
+          _write_span(x + pos, y, pos2 - pos, &pixelbuf[pos * bytes]);
+          pos = pos2;
         }
         if (pos != w)
         {
@@ -305,7 +368,7 @@ namespace lgfx
 
   void Panel_FlexibleFrameBuffer::readRect(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, void* dst, pixelcopy_t* param)
   {
-    size_t bytes = _write_bits >> 3;
+    size_t bytes = _read_bits >> 3;
     size_t len = w * bytes;
     auto pixelbuf = (uint8_t*)alloca((len + 7) & ~3);
 
@@ -314,17 +377,7 @@ namespace lgfx
     h += y;
     do
     {
-      uint8_t* buf = pixelbuf;
-      uint32_t i = 0;
-      do
-      {
-        uint32_t raw = readPixelPreclipped(x + i, y);
-        *buf++ = raw;
-        for (size_t by = 1; by < bytes; ++by)
-        {
-          *buf++ = raw >>= 8;
-        }
-      } while (++i != w);
+      _read_span(x, y, w, pixelbuf);
 
       param->src_y32 = 0;
       param->src_x32 = 0;
@@ -27,6 +27,7 @@ namespace lgfx
 
 // 1ピクセル単位で描画を行うフレームバッファ
 // 動作は重いが、派生クラスで _draw_pixel_inner / _read_pixel_inner を overrideするだけで使用できる。
+// 1行単位でまとめて処理できる場合は _fill_span_inner / _copy_span_inner / _read_span_inner も overrideすると高速になる。
 
   struct Panel_FlexibleFrameBuffer : public Panel_Device
   {
@@ -71,6 +72,18 @@ namespace lgfx
     virtual void _draw_pixel_inner(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor) {}
     virtual void _fill_rect_inner(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor);
 
+// 1行分の横方向の連続したピクセルを処理する関数。座標は _draw_pixel_inner と同じく rotationしていない状態のもの。
+// 既定の実装は1ピクセル単位の関数を呼び出すので、派生クラスでは必要なものだけ overrideすればよい。
+// pixels は _write_depth のピクセルを詰めて並べたバイト列 (rawcolorの下位バイトが先)
+    virtual void _fill_span_inner(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint32_t rawcolor);
+    virtual void _copy_span_inner(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, const uint8_t* pixels);
+    virtual void _read_span_inner(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint8_t* pixels);
+
+    /// 描画座標(rotation適用前)で1行分の変換済みピクセルを書き込む。(pixels は左右反転のために書き換えられる)
+    void _write_span(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint8_t* pixels);
+    /// 描画座標(rotation適用前)で1行分のピクセルを読み出す。
+    void _read_span(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint8_t* pixels);
+
   };
 
 //----------------------------------------------------------------------------
@@ -71,6 +71,46 @@ namespace lgfx
   static inline void cacheWriteBack(const void*, uint32_t) {}
 #endif
 
+  struct fill_band_t
+  {
+    Panel_FrameBufferBase* panel;
+    uint_fast16_t x;
+    uint_fast16_t w;
+    uint32_t rawcolor;
+  };
+
+  static void fill_band(void* arg, int32_t y, int32_t h)
+  {
+    auto b = (fill_band_t*)arg;
+    b->panel->Panel_FrameBufferBase::writeFillRectPreclipped(b->x, y, b->w, h, b->rawcolor);
+  }
+
+  struct image_band_t
+  {
+    Panel_FrameBufferBase* panel;
+    uint_fast16_t x;
+    uint_fast16_t y;
+    uint_fast16_t w;
+    pixelcopy_t* param;
+    bool argb;
+  };
+
+  static void image_band(void* arg, int32_t y, int32_t h)
+  {
+    auto b = (image_band_t*)arg;
+    // 帯ごとにpixelcopyを複製し、帯の先頭行まで転送元を進める;
+    pixelcopy_t pc = *b->param;
+    pc.src_y32 += (y - b->y) << pixelcopy_t::FP_SCALE;
+    if (b->argb)
+    {
+      b->panel->Panel_FrameBufferBase::writeImageARGB(b->x, y, b->w, h, &pc);
+    }
+    else
+    {
+      b->panel->Panel_FrameBufferBase::writeImage(b->x, y, b->w, h, &pc, false);
+    }
+  }
+
   bool Panel_FrameBufferBase::init(bool use_reset)
   {
 #if defined ( LGFX_USE_CACHE_WRITEBACK_ADDR )
@@ -123,10 +163,7 @@ namespace lgfx
         if (r & 2)                  { x = _width  - (x + w); }
         if (r & 1) { std::swap(x, y);  std::swap(w, h); }
       }
-      _range_mod.left   = std::min<int_fast16_t>(_range_mod.left  , x        );
-      _range_mod.right  = std::max<int_fast16_t>(_range_mod.right , x + w - 1);
-      _range_mod.top    = std::min<int_fast16_t>(_range_mod.top   , y        );
-      _range_mod.bottom = std::max<int_fast16_t>(_range_mod.bottom, y + h - 1);
+      add_range_mod(x, y, w, h);
     }
     if (_range_mod.empty()) { return; }
 #if defined ( LGFX_USE_CACHE_WRITEBACK_ADDR )
@@ -183,6 +220,26 @@ namespace lgfx
     _ye = ye;
   }
 
+  bool Panel_FrameBufferBase::writeBands(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, void (*func)(void* arg, int32_t y, int32_t h), void* arg)
+  {
+    if (!use_bands(w, h)) { return false; }
+
+    uint_fast16_t rx = x, ry = y, rw = w, rh = h;
+    uint_fast8_t r = _internal_rotation;
+    if (r)
+    {
+      if ((1u << r) & 0b10010110) { ry = _height - (ry + rh); }
+      if (r & 2)                  { rx = _width  - (rx + rw); }
+      if (r & 1) { std::swap(rx, ry);  std::swap(rw, rh); }
+    }
+    add_range_mod(rx, ry, rw, rh);
+
+    _in_bands = true;
+    _worker_pool->run(y, h, func, arg);
+    _in_bands = false;
+    return true;
+  }
+
   void Panel_FrameBufferBase::drawPixelPreclipped(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor)
   {
     uint_fast8_t r = _internal_rotation;
@@ -194,10 +251,7 @@ namespace lgfx
     }
     if (_write_bits >= 8)
     {
-      _range_mod.left   = std::min<int_fast16_t>(_range_mod.left  , x);
-      _range_mod.right  = std::max<int_fast16_t>(_range_mod.right , x);
-      _range_mod.top    = std::min<int_fast16_t>(_range_mod.top   , y);
-      _range_mod.bottom = std::max<int_fast16_t>(_range_mod.bottom, y);
+      add_range_mod(x, y, 1, 1);
 
       size_t bytes = _write_bits >> 3;
       auto ptr = &_lines_buffer[y][x * bytes];
@@ -208,6 +262,12 @@ namespace lgfx
 
   void Panel_FrameBufferBase::writeFillRectPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor)
   {
+    if (use_bands(w, h))
+    {
+      fill_band_t band = { this, x, w, rawcolor };
+      writeBands(x, y, w, h, fill_band, &band);
+      return;
+    }
     uint_fast8_t r = _internal_rotation;
     if (r)
     {
@@ -215,10 +275,7 @@ namespace lgfx
       if (r & 2)                  { x = _width  - (x + w); }
       if (r & 1) { std::swap(x, y);  std::swap(w, h); }
     }
-    _range_mod.left   = std::min<int_fast16_t>(_range_mod.left  , x        );
-    _range_mod.right  = std::max<int_fast16_t>(_range_mod.right , x + w - 1);
-    _range_mod.top    = std::min<int_fast16_t>(_range_mod.top   , y        );
-    _range_mod.bottom = std::max<int_fast16_t>(_range_mod.bottom, y + h - 1);
+    add_range_mod(x, y, w, h);
 
     h += y;
     if (_write_bits >= 8)
@@ -299,16 +356,22 @@ namespace lgfx
     // auto k = _bitwidth * bits >> 3;
 
     uint_fast8_t r = _internal_rotation;
+    { // 変更範囲はウィンドウ全体とし、回転後の座標で追加する;
+      uint_fast16_t rx = xs, ry = ys, rw = xe - xs + 1, rh = ye - ys + 1;
+      if (r)
+      {
+        if ((1u << r) & 0b10010110) { ry = _height - (ry + rh); }
+        if (r & 2)                  { rx = _width  - (rx + rw); }
+        if (r & 1) { std::swap(rx, ry);  std::swap(rw, rh); }
+      }
+      add_range_mod(rx, ry, rw, rh);
+    }
     int_fast16_t ax = 1;
     int_fast16_t ay = 1;
     if (r) {
       if ((1u << r) & 0b10010110) { y = _height - (y + 1); ys = _height - (ys + 1); ye = _height - (ye + 1); ay = -1; }
       if (r & 2)                  { x = _width  - (x + 1); xs = _width  - (xs + 1); xe = _width  - (xe + 1); ax = -1; }
     }
-    _range_mod.left   = std::min<int_fast16_t>(_range_mod.left  , xs);
-    _range_mod.right  = std::max<int_fast16_t>(_range_mod.right , xe);
-    _range_mod.top    = std::min<int_fast16_t>(_range_mod.top   , ys);
-    _range_mod.bottom = std::max<int_fast16_t>(_range_mod.bottom, ye);
 
     if (!r)
     {
@@ -374,6 +437,12 @@ namespace lgfx
 
   void Panel_FrameBufferBase::writeImage(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param, bool)
   {
+    if (use_bands(w, h))
+    {
+      image_band_t band = { this, x, y, w, param, false };
+      writeBands(x, y, w, h, image_band, &band);
+      return;
+    }
     uint_fast8_t r = _internal_rotation;
     uint32_t nextx = 0;
     uint32_t nexty = 1 << pixelcopy_t::FP_SCALE;
@@ -381,10 +450,7 @@ namespace lgfx
     {
       _rotate_pixelcopy(x, y, w, h, param, nextx, nexty);
     }
-    _range_mod.left   = std::min<int32_t>(x, _range_mod.left);
-    _range_mod.right  = std::max<int32_t>(x+w-1, _range_mod.right);
-    _range_mod.top    = std::min<int32_t>(y, _range_mod.top);
-    _range_mod.bottom = std::max<int32_t>(y+h-1, _range_mod.bottom);
+    add_range_mod(x, y, w, h);
 
     if (r == 0 && param->transp == pixelcopy_t::NON_TRANSP && param->no_convert)
     {
@@ -422,12 +488,19 @@ namespace lgfx
 
   void Panel_FrameBufferBase::writeImageARGB(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param)
   {
+    if (use_bands(w, h))
+    {
+      image_band_t band = { this, x, y, w, param, true };
+      writeBands(x, y, w, h, image_band, &band);
+      return;
+    }
     uint32_t nextx = 0;
     uint32_t nexty = 1 << pixelcopy_t::FP_SCALE;
     if (_internal_rotation)
     {
       _rotate_pixelcopy(x, y, w, h, param, nextx, nexty);
     }
+    add_range_mod(x, y, w, h);
     uint32_t sx32 = param->src_x32;
     uint32_t sy32 = param->src_y32;
 
@@ -515,10 +588,7 @@ namespace lgfx
       if (r & 2)                  { src_x = _width  - (src_x + w); dst_x = _width  - (dst_x + w); }
       if (r & 1) { std::swap(src_x, src_y);  std::swap(dst_x, dst_y);  std::swap(w, h); }
     }
-    _range_mod.left   = std::min<int_fast16_t>(_range_mod.left  , dst_x);
-    _range_mod.right  = std::max<int_fast16_t>(_range_mod.right , dst_x + w - 1);
-    _range_mod.top    = std::min<int_fast16_t>(_range_mod.top   , dst_y);
-    _range_mod.bottom = std::max<int_fast16_t>(_range_mod.bottom, dst_y + h - 1);
+    add_range_mod(dst_x, dst_y, w, h);
 
     size_t bytes = _write_bits >> 3;
     size_t len = w * bytes;
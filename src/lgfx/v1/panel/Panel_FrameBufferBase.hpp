@@ -19,6 +19,7 @@ Contributors:
 
 #include "Panel_Device.hpp"
 #include "../misc/range.hpp"
+#include "../misc/WorkerPool.hpp"
 
 namespace lgfx
 {
@@ -40,6 +41,7 @@ namespace lgfx
     bool dmaBusy(void) override { return false; }
     void waitDisplay(void) override {}
     bool displayBusy(void) override { return false; }
+    bool isFrameBuffer(void) const override { return true; }
     color_depth_t setColorDepth(color_depth_t depth) override { _write_depth = depth; _read_depth = depth; return depth; }
 
     void setInvert(bool invert) override { _invert = invert; }
@@ -62,12 +64,38 @@ namespace lgfx
     void readRect(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, void* dst, pixelcopy_t* param) override;
     void copyRect(uint_fast16_t dst_x, uint_fast16_t dst_y, uint_fast16_t w, uint_fast16_t h, uint_fast16_t src_x, uint_fast16_t src_y) override;
 
+    bool writeBands(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, void (*func)(void* arg, int32_t y, int32_t h), void* arg) override;
+
+    /// 大きな塗り潰し・画像転送を横方向の帯に分割し、poolのスレッドで並列に描画する。;
+    /// min_pixels より小さい範囲と、1ピクセルが1バイトに満たない色深度では、呼出し元のスレッドで描画する。;
+    /// nullptr を指定すると無効になる。;
+    /// 描画関数を置き換える派生クラスは、異なる行への同時の呼出しに対して安全にすること。;
+    void setWorkerPool(WorkerPool* pool, uint32_t min_pixels = 32768) { _worker_pool = pool; _band_min_pixels = min_pixels; }
+    WorkerPool* getWorkerPool(void) const { return _worker_pool; }
+
   protected:
     uint8_t** _lines_buffer = nullptr;
     uint16_t _xpos, _ypos;
 
     range_rect_t _range_mod;
 
+    WorkerPool* _worker_pool = nullptr;
+    uint32_t _band_min_pixels = 32768;
+    bool _in_bands = false;   // 帯の描画中は_range_modを更新しない (writeBandsで一括して更新する);
+
+    /// 1バイトに複数のピクセルを持つ色深度では、帯の境目のバイトを複数のスレッドが書き換えるため分割しない;
+    bool use_bands(uint_fast16_t w, uint_fast16_t h) const { return _worker_pool && !_in_bands && _write_bits >= 8 && h > 1 && (uint32_t)w * h >= _band_min_pixels; }
+
+    /// 回転後(フレームバッファ上)の座標で、変更範囲を_range_modに追加する;
+    void add_range_mod(int_fast16_t x, int_fast16_t y, int_fast16_t w, int_fast16_t h)
+    {
+      if (_in_bands) { return; }
+      _range_mod.left   = std::min<int_fast16_t>(_range_mod.left  , x        );
+      _range_mod.right  = std::max<int_fast16_t>(_range_mod.right , x + w - 1);
+      _range_mod.top    = std::min<int_fast16_t>(_range_mod.top   , y        );
+      _range_mod.bottom = std::max<int_fast16_t>(_range_mod.bottom, y + h - 1);
+    }
+
     void _rotate_pixelcopy(uint_fast16_t& x, uint_fast16_t& y, uint_fast16_t& w, uint_fast16_t& h, pixelcopy_t* param, uint32_t& nextx, uint32_t& nexty);
   };
 
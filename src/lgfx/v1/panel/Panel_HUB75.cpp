@@ -20,6 +20,8 @@ Contributors:
 #include "../Bus.hpp"
 #include "../platforms/common.hpp"
 
+#include <algorithm>
+
 namespace lgfx
 {
  inline namespace v1
@@ -33,6 +35,7 @@ namespace lgfx
 
   Panel_HUB75_Multi::~Panel_HUB75_Multi(void)
   {
+    _release_panel_map();
     if (_panel_position)
     {
       heap_free(_panel_position);
@@ -50,7 +53,7 @@ namespace lgfx
   {
     if (_init_impl(_config_detail.panel_count * _config_detail.single_width, _config_detail.single_height))
     {
-      _init_hitcheck();
+      _init_panel_position();
       return true;
     }
     return false;
@@ -175,72 +178,256 @@ namespace lgfx
     }
   }
 
-  void Panel_HUB75_Multi::_draw_pixel_inner(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor)
+  void Panel_HUB75::_fill_span_inner(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint32_t rawcolor)
   {
-    uint32_t indexmask = _x_hitcheck_mask[x >> _x_hitcheck_shift] & _y_hitcheck_mask[y >> _y_hitcheck_shift];
-    if (!indexmask) { return; }
+    if (convertCoordinate || (_write_bits >> 3) == 3)
+    { // Panel_HUB75_Multi からは変換済みの座標で呼ばれるため、仮想関数ではなく自身の _draw_pixel_inner を使う;
+      do
+      {
+        Panel_HUB75::_draw_pixel_inner(x++, y, rawcolor);
+      } while (--w);
+      return;
+    }
+    auto buf = _frame_buffer.getLineBuffer(y);
+    if (_write_bits == 8)
+    {
+      memset(&buf[x], rawcolor, w);
+      return;
+    }
+    // swap565ではなく rgb565で扱う
+    uint16_t c = rawcolor << 8 | ((rawcolor >> 8) & 0xFF);
+    auto buf16 = &((uint16_t*)buf)[x];
+    do { *buf16++ = c; } while (--w);
+  }
 
-    auto single_width = _config_detail.single_width;
-    auto single_height = _config_detail.single_height;
-    for (uint_fast8_t panel_index = 0; indexmask; ++panel_index, indexmask >>= 1)
+  void Panel_HUB75::_copy_span_inner(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, const uint8_t* pixels)
+  {
+    if (convertCoordinate || (_write_bits >> 3) == 3)
     {
-      if (indexmask & 1)
+      size_t bytes = _write_bits >> 3;
+      do
       {
-        auto r = _panel_position[panel_index].rotation;
-        uint_fast16_t ix = x - _panel_position[panel_index].x;
-        uint_fast16_t iy = y - _panel_position[panel_index].y;
-        if (r & 1)
+        uint32_t raw = *pixels++;
+        for (size_t by = 1; by < bytes; ++by)
         {
-          std::swap(ix, iy);
+          raw += (*pixels++) << (by * 8);
         }
-        if (ix >= single_width) { continue; }
-        if (iy >= single_height) { continue; }
-        if (r)
+        Panel_HUB75::_draw_pixel_inner(x++, y, raw);
+      } while (--w);
+      return;
+    }
+    auto buf = _frame_buffer.getLineBuffer(y);
+    if (_write_bits == 8)
+    {
+      memcpy(&buf[x], pixels, w);
+      return;
+    }
+    auto buf16 = &((uint16_t*)buf)[x];
+    do
+    {
+      *buf16++ = pixels[0] << 8 | pixels[1];
+      pixels += 2;
+    } while (--w);
+  }
+
+  void Panel_HUB75::_read_span_inner(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint8_t* pixels)
+  {
+    if (convertCoordinate || (_read_bits >> 3) == 3)
+    {
+      size_t bytes = _read_bits >> 3;
+      do
+      {
+        uint32_t raw = Panel_HUB75::_read_pixel_inner(x++, y);
+        *pixels++ = raw;
+        for (size_t by = 1; by < bytes; ++by)
         {
-          r = 1 << r;
-          if (0b11001100 & r) { ix = single_width  - ix - 1; }
-          if (0b10010110 & r) { iy = single_height - iy - 1; }
+          *pixels++ = raw >>= 8;
         }
+      } while (--w);
+      return;
+    }
+    auto buf = _frame_buffer.getLineBuffer(y);
+    if (_read_bits == 8)
+    {
+      memcpy(pixels, &buf[x], w);
+      return;
+    }
+    auto buf16 = &((const uint16_t*)buf)[x];
+    do
+    {
+      uint32_t tmp = *buf16++;
+      pixels[0] = tmp >> 8;
+      pixels[1] = tmp;
+      pixels += 2;
+    } while (--w);
+  }
+
+  // 描画座標 (x,y) をパネル内の座標に変換する。step_x / step_y は描画座標のxが1増えた時のパネル内座標の増分
+  static void map_to_panel(const Panel_HUB75_Multi::panel_position_t& pos, uint_fast16_t single_width, uint_fast16_t single_height
+                          , uint_fast16_t x, uint_fast16_t y, uint_fast16_t& ix, uint_fast16_t& iy, int_fast8_t& step_x, int_fast8_t& step_y)
+  {
+    ix = x - pos.x;
+    iy = y - pos.y;
+    step_x = 1;
+    step_y = 0;
+    uint_fast8_t r = pos.rotation & 7;
+    if (r & 1)
+    {
+      std::swap(ix, iy);
+      std::swap(step_x, step_y);
+    }
+    if (r)
+    {
+      r = 1 << r;
+      if (0b11001100 & r) { ix = single_width  - ix - 1; step_x = -step_x; }
+      if (0b10010110 & r) { iy = single_height - iy - 1; step_y = -step_y; }
+    }
+  }
 
-        Panel_HUB75::_draw_pixel_inner(ix + panel_index * single_width, iy, rawcolor);
+  void Panel_HUB75_Multi::_draw_pixel_inner(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor)
+  {
+    if (_row_band == nullptr) { return; }
+    uint_fast8_t band = _row_band[y];
+    for (uint_fast16_t i = _band_index[band], ie = _band_index[band + 1]; i < ie; ++i)
+    {
+      auto span = &_panel_span[i];
+      if ((uint_fast16_t)(x - span->x) < span->w)
+      {
+        uint_fast16_t ix, iy;
+        int_fast8_t step_x, step_y;
+        map_to_panel(_panel_position[span->panel_index], _config_detail.single_width, _config_detail.single_height, x, y, ix, iy, step_x, step_y);
+        Panel_HUB75::_draw_pixel_inner(ix + span->panel_index * _config_detail.single_width, iy, rawcolor);
       }
     }
   }
 
   uint32_t Panel_HUB75_Multi::_read_pixel_inner(uint_fast16_t x, uint_fast16_t y)
   {
-    uint32_t indexmask = _x_hitcheck_mask[x >> _x_hitcheck_shift] & _y_hitcheck_mask[y >> _y_hitcheck_shift];
-    if (!indexmask) { return 0; }
+    if (_row_band == nullptr) { return 0; }
+    uint_fast8_t band = _row_band[y];
+    for (uint_fast16_t i = _band_index[band], ie = _band_index[band + 1]; i < ie; ++i)
+    {
+      auto span = &_panel_span[i];
+      if ((uint_fast16_t)(x - span->x) < span->w)
+      {
+        uint_fast16_t ix, iy;
+        int_fast8_t step_x, step_y;
+        map_to_panel(_panel_position[span->panel_index], _config_detail.single_width, _config_detail.single_height, x, y, ix, iy, step_x, step_y);
+        return Panel_HUB75::_read_pixel_inner(ix + span->panel_index * _config_detail.single_width, iy);
+      }
+    }
+    return 0;
+  }
+
+  void Panel_HUB75_Multi::_fill_span_inner(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint32_t rawcolor)
+  {
+    if (_row_band == nullptr) { return; }
+    uint_fast16_t xe = x + w;
+    uint_fast8_t band = _row_band[y];
+    for (uint_fast16_t i = _band_index[band], ie = _band_index[band + 1]; i < ie; ++i)
+    {
+      auto span = &_panel_span[i];
+      uint_fast16_t l = std::max<uint_fast16_t>(x, span->x);
+      uint_fast16_t r = std::min<uint_fast16_t>(xe, span->x + span->w);
+      if (l >= r) { continue; }
+      uint_fast16_t len = r - l;
+      uint_fast16_t ix, iy;
+      int_fast8_t step_x, step_y;
+      map_to_panel(_panel_position[span->panel_index], _config_detail.single_width, _config_detail.single_height, l, y, ix, iy, step_x, step_y);
+      ix += span->panel_index * _config_detail.single_width;
+      if (step_y == 0)
+      { // パネル内でも横方向に並ぶので、向きに関係なく1回で塗る
+        if (step_x < 0) { ix -= len - 1; }
+        Panel_HUB75::_fill_span_inner(ix, iy, len, rawcolor);
+      }
+      else
+      {
+        do
+        {
+          Panel_HUB75::_draw_pixel_inner(ix, iy, rawcolor);
+          iy += step_y;
+        } while (--len);
+      }
+    }
+  }
+
+  void Panel_HUB75_Multi::_copy_span_inner(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, const uint8_t* pixels)
+  {
+    if (_row_band == nullptr) { return; }
+    size_t bytes = _write_bits >> 3;
+    uint_fast16_t xe = x + w;
+    uint_fast8_t band = _row_band[y];
+    for (uint_fast16_t i = _band_index[band], ie = _band_index[band + 1]; i < ie; ++i)
     {
-      auto single_width = _config_detail.single_width;
-      auto single_height = _config_detail.single_height;
-      for (uint_fast8_t panel_index = 0; indexmask; ++panel_index, indexmask >>= 1)
+      auto span = &_panel_span[i];
+      uint_fast16_t l = std::max<uint_fast16_t>(x, span->x);
+      uint_fast16_t r = std::min<uint_fast16_t>(xe, span->x + span->w);
+      if (l >= r) { continue; }
+      uint_fast16_t len = r - l;
+      uint_fast16_t ix, iy;
+      int_fast8_t step_x, step_y;
+      map_to_panel(_panel_position[span->panel_index], _config_detail.single_width, _config_detail.single_height, l, y, ix, iy, step_x, step_y);
+      ix += span->panel_index * _config_detail.single_width;
+      auto src = &pixels[(l - x) * bytes];
+      if (step_x > 0)
+      {
+        Panel_HUB75::_copy_span_inner(ix, iy, len, src);
+        continue;
+      }
+      do
       {
-        if (indexmask & 1)
+        uint32_t raw = *src++;
+        for (size_t by = 1; by < bytes; ++by)
         {
-          uint_fast8_t r = _panel_position[panel_index].rotation;
-          uint_fast16_t ix = x - _panel_position[panel_index].x;
-          uint_fast16_t iy = y - _panel_position[panel_index].y;
-          if (r & 1)
-          {
-            std::swap(ix, iy);
-          }
-          if (ix >= single_width) { continue; }
-          if (iy >= single_height) { continue; }
-          if (r)
-          {
-            r = 1 << r;
-            if (0b11001100 & r) { ix = single_width  - ix - 1; }
-            if (0b10010110 & r) { iy = single_height - iy - 1; }
-          }
-          return Panel_HUB75::_read_pixel_inner(ix + panel_index * single_width, iy);
+          raw += (*src++) << (by * 8);
         }
+        Panel_HUB75::_draw_pixel_inner(ix, iy, raw);
+        ix += step_x;
+        iy += step_y;
+      } while (--len);
+    }
+  }
+
+  void Panel_HUB75_Multi::_read_span_inner(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint8_t* pixels)
+  {
+    size_t bytes = _read_bits >> 3;
+    memset(pixels, 0, w * bytes);
+    if (_row_band == nullptr) { return; }
+    uint_fast16_t xe = x + w;
+    uint_fast8_t band = _row_band[y];
+    /// パネルが重なっている場合は番号の小さいパネルを優先するため、逆順に処理する;
+    for (uint_fast16_t i = _band_index[band + 1], ie = _band_index[band]; i > ie; )
+    {
+      auto span = &_panel_span[--i];
+      uint_fast16_t l = std::max<uint_fast16_t>(x, span->x);
+      uint_fast16_t r = std::min<uint_fast16_t>(xe, span->x + span->w);
+      if (l >= r) { continue; }
+      uint_fast16_t len = r - l;
+      uint_fast16_t ix, iy;
+      int_fast8_t step_x, step_y;
+      map_to_panel(_panel_position[span->panel_index], _config_detail.single_width, _config_detail.single_height, l, y, ix, iy, step_x, step_y);
+      ix += span->panel_index * _config_detail.single_width;
+      auto dst = &pixels[(l - x) * bytes];
+      if (step_x > 0)
+      {
+        Panel_HUB75::_read_span_inner(ix, iy, len, dst);
+        continue;
       }
+      do
+      {
+        uint32_t raw = Panel_HUB75::_read_pixel_inner(ix, iy);
+        *dst++ = raw;
+        for (size_t by = 1; by < bytes; ++by)
+        {
+          *dst++ = raw >>= 8;
+        }
+        ix += step_x;
+        iy += step_y;
+      } while (--len);
     }
-    return 0;
   }
 
-  bool Panel_HUB75_Multi::_init_hitcheck(void)
+  bool Panel_HUB75_Multi::_init_panel_position(void)
   {
     if (_panel_position == nullptr)
     {
@@ -249,75 +436,127 @@ namespace lgfx
       {
         return false;
       }
-      _panel_position_count = panel_count;
       _panel_position = (panel_position_t*)heap_alloc_dma(panel_count * sizeof(panel_position_t));
+      if (_panel_position == nullptr)
+      {
+        return false;
+      }
+      _panel_position_count = panel_count;
       memset(_panel_position, 0, panel_count * sizeof(panel_position_t));
-      memset(_x_hitcheck_mask, 0, sizeof(_x_hitcheck_mask));
-      memset(_y_hitcheck_mask, 0, sizeof(_y_hitcheck_mask));
-
-      uint32_t s = 0;
-      uint32_t tmp = _cfg.panel_width - 1;
-      while (tmp >>= 1) { ++s; }
-      _x_hitcheck_shift = (s > 2) ? (s - 2) : 0;
-
-      s = 0;
-      tmp = _cfg.panel_height - 1;
-      while (tmp >>= 1) { ++s; }
-      _y_hitcheck_shift = (s > 2) ? (s - 2) : 0;
+      _panel_visible = 0;
     }
-    return _panel_position != nullptr;
+    return true;
   }
 
-  bool Panel_HUB75_Multi::setPanelPosition(uint_fast8_t index, uint_fast16_t x, uint_fast16_t y, uint_fast8_t rotation)
+  void Panel_HUB75_Multi::_release_panel_map(void)
   {
-    if (!_init_hitcheck()) { return false; }
-    auto panel_count = _config_detail.panel_count;
-    if (index < panel_count)
+    if (_panel_map)
     {
-      _panel_position[index].x = x;
-      _panel_position[index].y = y;
-      _panel_position[index].rotation = rotation;
-
-      static constexpr const size_t x_size = sizeof(_x_hitcheck_mask) / sizeof(_x_hitcheck_mask[0]);
-      static constexpr const size_t y_size = sizeof(_y_hitcheck_mask) / sizeof(_y_hitcheck_mask[0]);
+      heap_free(_panel_map);
+      _panel_map = nullptr;
+    }
+    _panel_span = nullptr;
+    _band_index = nullptr;
+    _row_band = nullptr;
+  }
 
-      uint32_t mask_index = 1 << index;
+  bool Panel_HUB75_Multi::_update_panel_map(void)
+  {
+    _release_panel_map();
+
+    uint_fast16_t width = _cfg.panel_width;
+    uint_fast16_t height = _cfg.panel_height;
+    uint_fast16_t single_width = _config_detail.single_width;
+    uint_fast16_t single_height = _config_detail.single_height;
+    size_t count = std::min<size_t>(_panel_position_count, 32);
+    if (!width || !height) { return false; }
+
+    // 帯の境界 (画面の上下端と、各パネルの上下端)
+    uint16_t bound[2 + 32 * 2];
+    size_t bound_count = 0;
+    bound[bound_count++] = 0;
+    bound[bound_count++] = height;
+    for (size_t i = 0; i < count; ++i)
+    {
+      if (!(_panel_visible & (1u << i))) { continue; }
+      auto& pos = _panel_position[i];
+      uint_fast16_t y0 = pos.y;
+      uint_fast16_t y1 = y0 + ((pos.rotation & 1) ? single_width : single_height);
+      if (y0 < height) { bound[bound_count++] = y0; }
+      if (y1 < height) { bound[bound_count++] = y1; }
+    }
+    std::sort(bound, bound + bound_count);
+    bound_count = std::unique(bound, bound + bound_count) - bound;
+    size_t band_count = bound_count - 1;
 
-      auto w = _config_detail.single_width;
-      auto h = _config_detail.single_height;
-      if (rotation & 1)
-      {
-        std::swap(w, h);
-      }
-      for (size_t i = 0; i < x_size; ++i)
-      {
-        _x_hitcheck_mask[i] &= ~mask_index;
-      }
-      uint_fast16_t xe = (x + w - 1) >> _x_hitcheck_shift;
-      if (xe > x_size - 1) { xe = x_size - 1; }
-      x >>= _x_hitcheck_shift;
-      while (x <= xe)
+    size_t span_count = 0;
+    for (size_t b = 0; b < band_count; ++b)
+    {
+      for (size_t i = 0; i < count; ++i)
       {
-        _x_hitcheck_mask[x] |= mask_index;
-        ++x;
+        if (!(_panel_visible & (1u << i))) { continue; }
+        auto& pos = _panel_position[i];
+        uint_fast16_t ph = (pos.rotation & 1) ? single_width : single_height;
+        if (pos.x < width && pos.y <= bound[b] && bound[b] < pos.y + ph) { ++span_count; }
       }
+    }
 
-      for (size_t i = 0; i < y_size; ++i)
-      {
-        _y_hitcheck_mask[i] &= ~mask_index;
-      }
-      uint_fast16_t ye = (y + h - 1) >> _y_hitcheck_shift;
-      if (ye > y_size - 1) { ye = y_size - 1; }
-      y >>= _y_hitcheck_shift;
-      while (y <= ye)
+    size_t span_bytes = span_count * sizeof(panel_span_t);
+    size_t index_bytes = (band_count + 1) * sizeof(uint16_t);
+    auto mem = (uint8_t*)heap_alloc(span_bytes + index_bytes + height);
+    if (mem == nullptr) { return false; }
+    _panel_map = mem;
+    _panel_span = (panel_span_t*)mem;
+    _band_index = (uint16_t*)&mem[span_bytes];
+    _row_band = &mem[span_bytes + index_bytes];
+
+    size_t span_index = 0;
+    for (size_t b = 0; b < band_count; ++b)
+    {
+      _band_index[b] = span_index;
+      memset(&_row_band[bound[b]], b, bound[b + 1] - bound[b]);
+      for (size_t i = 0; i < count; ++i)
       {
-        _y_hitcheck_mask[y] |= mask_index;
-        ++y;
+        if (!(_panel_visible & (1u << i))) { continue; }
+        auto& pos = _panel_position[i];
+        uint_fast16_t pw = single_width;
+        uint_fast16_t ph = single_height;
+        if (pos.rotation & 1) { std::swap(pw, ph); }
+        if (pos.x < width && pos.y <= bound[b] && bound[b] < pos.y + ph)
+        {
+          auto span = &_panel_span[span_index++];
+          span->x = pos.x;
+          span->w = std::min<uint_fast16_t>(pw, width - pos.x);
+          span->panel_index = i;
+        }
       }
     }
+    _band_index[band_count] = span_index;
     return true;
   }
 
+  bool Panel_HUB75_Multi::setPanelPosition(uint_fast8_t index, uint_fast16_t x, uint_fast16_t y, uint_fast8_t rotation)
+  {
+    if (!_init_panel_position()) { return false; }
+    if (index < _panel_position_count && index < 32)
+    {
+      _panel_position[index].x = x;
+      _panel_position[index].y = y;
+      _panel_position[index].rotation = rotation;
+      _panel_visible |= 1u << index;
+    }
+    return _update_panel_map();
+  }
+
+  bool Panel_HUB75_Multi::setPanelPositions(const panel_position_t* positions, size_t count)
+  {
+    if (!_init_panel_position()) { return false; }
+    count = std::min<size_t>(count, std::min<size_t>(_panel_position_count, 32));
+    memcpy(_panel_position, positions, count * sizeof(panel_position_t));
+    _panel_visible = (count < 32) ? ((1u << count) - 1) : ~0u;
+    return _update_panel_map();
+  }
+
 //----------------------------------------------------------------------------
  }
 }
@@ -58,6 +58,9 @@ namespace lgfx
 
     uint32_t _read_pixel_inner(uint_fast16_t x, uint_fast16_t y) override;
     void _draw_pixel_inner(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor) override;
+    void _fill_span_inner(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint32_t rawcolor) override;
+    void _copy_span_inner(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, const uint8_t* pixels) override;
+    void _read_span_inner(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint8_t* pixels) override;
   };
 
 
@@ -86,34 +89,51 @@ namespace lgfx
     const config_detail_t& config_detail(void) const { return _config_detail; }
     void config_detail(const config_detail_t& config_detail) { _config_detail = config_detail; }
 
+    struct panel_position_t
+    {
+      uint16_t x;
+      uint16_t y;
+      uint8_t rotation;
+    };
+
     // 各パネルの表示座標の設定。configおよびconfig_detailを設定した後に使用すること。
     bool setPanelPosition(uint_fast8_t index, uint_fast16_t x, uint_fast16_t y, uint_fast8_t rotation = 0);
 
+    // 全パネルの表示座標をまとめて設定する。動作中の配置変更にも使用でき、パネル割当表の再計算は1回で済む。
+    // positions[0] ～ positions[count-1] をパネル0から順に設定し、残りのパネルは非表示になる。
+    bool setPanelPositions(const panel_position_t* positions, size_t count);
+
+    const panel_position_t* getPanelPosition(uint_fast8_t index) const { return (index < _panel_position_count) ? &_panel_position[index] : nullptr; }
+
   protected:
-    struct panel_position_t
+    // 描画座標の1行のうち、1枚のパネルが受け持つ区間
+    struct panel_span_t
     {
       uint16_t x;
-      uint16_t y;
-      uint8_t rotation;
+      uint16_t w;
+      uint8_t panel_index;
     };
 
     config_detail_t _config_detail;
 
-// 座標の上位3ビットを使用し、座標範囲に該当するパネルを判定するためのテーブル
-    uint32_t _x_hitcheck_mask[8];
-    uint32_t _y_hitcheck_mask[8];
-    uint8_t _x_hitcheck_shift = 0;
-    uint8_t _y_hitcheck_shift = 0;
+// 描画座標をパネルの上下の境界で帯状に区切り、帯ごとに横切るパネルの区間をパネル番号順に並べた表
+    void* _panel_map = nullptr;
+    panel_span_t* _panel_span = nullptr;  // 全ての帯の区間
+    uint16_t* _band_index = nullptr;      // 帯ごとの _panel_span の開始位置 (帯の数 + 1 個)
+    uint8_t* _row_band = nullptr;         // 行ごとの帯番号
 
     panel_position_t* _panel_position = nullptr;
     size_t  _panel_position_count = 0;
+    uint32_t _panel_visible = 0;
 
-    uint16_t _single_width;
-    uint16_t _single_height;
-
-    bool _init_hitcheck(void);
+    bool _init_panel_position(void);
+    bool _update_panel_map(void);
+    void _release_panel_map(void);
     uint32_t _read_pixel_inner(uint_fast16_t x, uint_fast16_t y) override;
     void _draw_pixel_inner(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor) override;
+    void _fill_span_inner(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint32_t rawcolor) override;
+    void _copy_span_inner(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, const uint8_t* pixels) override;
+    void _read_span_inner(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint8_t* pixels) override;
   };
 
 //----------------------------------------------------------------------------
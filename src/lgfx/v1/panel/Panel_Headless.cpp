@@ -0,0 +1,286 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#include "Panel_Headless.hpp"
+
+#include "../platforms/common.hpp"
+#include "../misc/pixelcopy.hpp"
+#include "../../utility/lgfx_qoi.h"
+
+#include <string.h>
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  Panel_Headless::~Panel_Headless(void)
+  {
+    release_buffer();
+  }
+
+  void Panel_Headless::config_detail(const config_detail_t& config_detail)
+  {
+    _config_detail = config_detail;
+    if (_lines_buffer) { alloc_ring(); }
+  }
+
+  bool Panel_Headless::init(bool)
+  { // リセット信号が無いため、リセット待ちを行わない;
+    if (!init_buffer() || !Panel_FrameBufferBase::init(false)) { return false; }
+    resetStats();
+    return true;
+  }
+
+  bool Panel_Headless::init_buffer(void)
+  {
+    release_buffer();
+    size_t width = _cfg.panel_width;
+    size_t height = _cfg.panel_height;
+    if (width == 0 || height == 0) { return false; }
+
+    // 色深度を変更しても再確保しないよう、24bpp分の幅で確保する;
+    size_t stride = (width * 3 + 7) & ~7u;
+    auto lines = (uint8_t**)heap_alloc(height * sizeof(uint8_t*));
+    auto buf = (uint8_t*)heap_alloc(stride * height);
+    _output_line = (uint8_t*)heap_alloc(width * 3);
+    if (lines == nullptr || buf == nullptr || _output_line == nullptr)
+    {
+      if (lines) { heap_free(lines); }
+      if (buf) { heap_free(buf); }
+      release_buffer();
+      return false;
+    }
+    memset(buf, 0, stride * height);
+    for (size_t y = 0; y < height; ++y)
+    {
+      lines[y] = &buf[y * stride];
+    }
+    _lines_buffer = lines;
+    return alloc_ring();
+  }
+
+  void Panel_Headless::release_buffer(void)
+  {
+    if (_ring) { heap_free(_ring); }
+    _ring = nullptr;
+    _ring_frame_bytes = 0;
+    _ring_count = 0;
+    _ring_next = 0;
+    if (_output_line) { heap_free(_output_line); }
+    _output_line = nullptr;
+    auto lines = _lines_buffer;
+    _lines_buffer = nullptr;
+    if (lines)
+    {
+      heap_free(lines[0]);
+      heap_free(lines);
+    }
+  }
+
+  bool Panel_Headless::alloc_ring(void)
+  {
+    if (_ring) { heap_free(_ring); }
+    _ring = nullptr;
+    _ring_count = 0;
+    _ring_next = 0;
+    _ring_frame_bytes = getFrameBytes();
+    if (_config_detail.ring_frames == 0) { return true; }
+    _ring = (uint8_t*)heap_alloc(_ring_frame_bytes * _config_detail.ring_frames);
+    return _ring != nullptr;
+  }
+
+  color_depth_t Panel_Headless::setColorDepth(color_depth_t depth)
+  {
+    auto bits = depth & color_depth_t::bit_mask;
+    if (bits >= 16) {
+      depth = (bits > 16)
+            ? rgb888_3Byte
+            : rgb565_2Byte;
+    } else {
+      depth = (depth == color_depth_t::grayscale_8bit)
+            ? grayscale_8bit
+            : rgb332_1Byte;
+    }
+    bool changed = (_write_depth != depth);
+    _write_depth = depth;
+    _read_depth = depth;
+    // 保持済みのフレームは色深度が異なるため破棄する;
+    if (changed && _ring) { alloc_ring(); }
+    return depth;
+  }
+
+  void Panel_Headless::resetStats(void)
+  {
+    _frame_stats = frame_stats_t();
+    _current = frame_stats_t();
+    _total_stats = frame_stats_t();
+    _frame_start = lgfx::micros();
+    _transaction_start = _frame_start;
+  }
+
+  void Panel_Headless::beginTransaction(void)
+  {
+    if (_in_transaction) { return; }
+    _in_transaction = true;
+    _transaction_start = lgfx::micros();
+  }
+
+  void Panel_Headless::endTransaction(void)
+  {
+    if (!_in_transaction) { return; }
+    _in_transaction = false;
+    _current.draw_usec += lgfx::micros() - _transaction_start;
+  }
+
+  void Panel_Headless::display(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h)
+  {
+    Panel_FrameBufferBase::display(x, y, w, h);
+
+    uint32_t now = lgfx::micros();
+    if (_in_transaction) { _current.draw_usec += now - _transaction_start; }
+    _current.frames = 1;
+    _current.frame_usec = now - _frame_start;
+    _frame_start = now;
+
+    if (_ring) { keep_frame(); }
+    if (_config_detail.output) { output_frame(); }
+
+    uint32_t end = lgfx::micros();
+    _current.output_usec = end - now;
+    if (_in_transaction) { _transaction_start = end; }
+
+    _frame_stats = _current;
+    _total_stats.frames      += _current.frames;
+    _total_stats.draw_calls  += _current.draw_calls;
+    _total_stats.pixels      += _current.pixels;
+    _total_stats.draw_usec   += _current.draw_usec;
+    _total_stats.frame_usec  += _current.frame_usec;
+    _total_stats.output_usec += _current.output_usec;
+    _current = frame_stats_t();
+  }
+
+  void Panel_Headless::keep_frame(void)
+  {
+    auto dst = &_ring[_ring_next * _ring_frame_bytes];
+    size_t len = _ring_frame_bytes / _cfg.panel_height;
+    for (size_t y = 0; y < _cfg.panel_height; ++y)
+    {
+      memcpy(dst, _lines_buffer[y], len);
+      dst += len;
+    }
+    if (++_ring_next >= _config_detail.ring_frames) { _ring_next = 0; }
+    if (_ring_count < _config_detail.ring_frames) { ++_ring_count; }
+  }
+
+  const uint8_t* Panel_Headless::getCapturedFrame(size_t age) const
+  {
+    if (age >= _ring_count) { return nullptr; }
+    size_t frames = _config_detail.ring_frames;
+    size_t index = (_ring_next + frames - 1 - age) % frames;
+    return &_ring[index * _ring_frame_bytes];
+  }
+
+  struct headless_output_t
+  {
+    FILE* fp;
+    pixelcopy_t* pc;
+    const uint8_t* const* lines;
+  };
+
+  static int headless_write_bytes(void* user, uint8_t* buf, size_t len)
+  {
+    return fwrite(buf, 1, len, static_cast<headless_output_t*>(user)->fp);
+  }
+
+  static uint8_t* headless_get_row(uint8_t* lineBuffer, int, int w, int, int y, void* qoienc)
+  {
+    auto o = static_cast<headless_output_t*>(qoienc);
+    o->pc->src_data = o->lines[y];
+    o->pc->src_x32 = 0;
+    o->pc->fp_copy(lineBuffer, 0, w, o->pc);
+    return lineBuffer;
+  }
+
+  void Panel_Headless::output_frame(void)
+  {
+    auto fp = _config_detail.output;
+    uint_fast16_t w = _cfg.panel_width;
+    uint_fast16_t h = _cfg.panel_height;
+    pixelcopy_t pc(nullptr, bgr888_t::depth, _write_depth, false);
+    headless_output_t o = { fp, &pc, _lines_buffer };
+
+    if (_config_detail.output_format == output_qoi)
+    {
+      lgfx_qoi_encoder_write_cb_user(_output_line, 4096, w, h, 3, 0, headless_get_row, headless_write_bytes, &o, &o);
+      return;
+    }
+
+    for (uint_fast16_t y = 0; y < h; ++y)
+    {
+      fwrite(headless_get_row(_output_line, 0, w, 1, y, &o), 3, w, fp);
+    }
+  }
+
+  // 帯に分割された描画は、帯の中の呼出しを数えず、ここで領域全体を1回として数える;
+  bool Panel_Headless::writeBands(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, void (*func)(void* arg, int32_t y, int32_t h), void* arg)
+  {
+    if (!use_bands(w, h)) { return false; }
+    count(w * h);
+    return Panel_FrameBufferBase::writeBands(x, y, w, h, func, arg);
+  }
+
+  void Panel_Headless::drawPixelPreclipped(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor)
+  {
+    count(1);
+    Panel_FrameBufferBase::drawPixelPreclipped(x, y, rawcolor);
+  }
+
+  void Panel_Headless::writeFillRectPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor)
+  {
+    if (!use_bands(w, h)) { count(w * h); }
+    Panel_FrameBufferBase::writeFillRectPreclipped(x, y, w, h, rawcolor);
+  }
+
+  void Panel_Headless::writeImage(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param, bool use_dma)
+  {
+    if (!use_bands(w, h)) { count(w * h); }
+    Panel_FrameBufferBase::writeImage(x, y, w, h, param, use_dma);
+  }
+
+  void Panel_Headless::writeImageARGB(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param)
+  {
+    if (!use_bands(w, h)) { count(w * h); }
+    Panel_FrameBufferBase::writeImageARGB(x, y, w, h, param);
+  }
+
+  void Panel_Headless::writePixels(pixelcopy_t* param, uint32_t len, bool use_dma)
+  {
+    count(len);
+    Panel_FrameBufferBase::writePixels(param, len, use_dma);
+  }
+
+  void Panel_Headless::copyRect(uint_fast16_t dst_x, uint_fast16_t dst_y, uint_fast16_t w, uint_fast16_t h, uint_fast16_t src_x, uint_fast16_t src_y)
+  {
+    count(w * h);
+    Panel_FrameBufferBase::copyRect(dst_x, dst_y, w, h, src_x, src_y);
+  }
+
+//----------------------------------------------------------------------------
+ }
+}
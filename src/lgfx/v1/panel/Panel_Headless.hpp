@@ -0,0 +1,131 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#pragma once
+
+#include "Panel_FrameBufferBase.hpp"
+
+#include <stdio.h>
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  /// @brief 表示装置を持たず、メモリ上にのみ描画するパネル;
+  /// Renders into a plain memory frame buffer, so drawing can be measured and checked
+  /// where no display, window system or /dev/fb exists (CI, containers).
+  /// display() ends a frame: the statistics of the frame are fixed, and the frame is
+  /// optionally kept in a ring of images and/or written to a file.
+  /// Statistics count the calls that reach the panel, so they do not depend on the host.
+  struct Panel_Headless : public Panel_FrameBufferBase
+  {
+  public:
+    enum output_format_t : uint8_t
+    {
+      output_raw,  // RGB888 frames, panel_width x panel_height each (e.g. ffmpeg -f rawvideo -pix_fmt rgb24)
+      output_qoi,  // one QOI image per frame, concatenated
+    };
+
+    struct config_detail_t
+    {
+      uint16_t ring_frames = 0;         // number of frames kept in memory (0 = none)
+      FILE* output = nullptr;           // file that receives every frame (optional)
+      output_format_t output_format = output_raw;
+    };
+
+    struct frame_stats_t
+    {
+      uint32_t frames = 0;       // number of frames (display calls) counted
+      uint32_t draw_calls = 0;   // drawing calls that reached the panel
+      uint64_t pixels = 0;       // pixels written by them
+      uint32_t draw_usec = 0;    // time spent between startWrite and endWrite
+      uint32_t frame_usec = 0;   // time from the previous display call
+      uint32_t output_usec = 0;  // time spent keeping / writing the frame (not in draw_usec)
+    };
+
+    Panel_Headless(void) = default;
+    virtual ~Panel_Headless(void);
+
+    bool init(bool use_reset) override;
+    void beginTransaction(void) override;
+    void endTransaction(void) override;
+
+    color_depth_t setColorDepth(color_depth_t depth) override;
+
+    void display(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h) override;
+
+    void drawPixelPreclipped(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor) override;
+    void writeFillRectPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor) override;
+    void writeImage(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param, bool use_dma) override;
+    void writeImageARGB(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param) override;
+    void writePixels(pixelcopy_t* param, uint32_t len, bool use_dma) override;
+    void copyRect(uint_fast16_t dst_x, uint_fast16_t dst_y, uint_fast16_t w, uint_fast16_t h, uint_fast16_t src_x, uint_fast16_t src_y) override;
+    bool writeBands(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, void (*func)(void* arg, int32_t y, int32_t h), void* arg) override;
+
+    const config_detail_t& config_detail(void) const { return _config_detail; }
+    void config_detail(const config_detail_t& config_detail);
+
+    /// Statistics of the last finished frame.
+    const frame_stats_t& getFrameStats(void) const { return _frame_stats; }
+    /// Statistics of all frames since init or resetStats.
+    const frame_stats_t& getTotalStats(void) const { return _total_stats; }
+    void resetStats(void);
+
+    /// Size of one frame in bytes (panel_width x panel_height, in the current color depth).
+    size_t getFrameBytes(void) const { return (size_t)_cfg.panel_width * _cfg.panel_height * _write_bits >> 3; }
+    /// Line y of the frame buffer (not rotated).
+    const uint8_t* getLine(uint_fast16_t y) const { return _lines_buffer ? _lines_buffer[y] : nullptr; }
+
+    /// Number of frames held in the ring.
+    size_t getCapturedCount(void) const { return _ring_count; }
+    /// Frame held in the ring, 0 = newest.  Lines are packed (panel_width pixels each).
+    /// @return nullptr if there is no such frame.
+    const uint8_t* getCapturedFrame(size_t age = 0) const;
+
+  protected:
+    config_detail_t _config_detail;
+
+    frame_stats_t _frame_stats;   // last finished frame
+    frame_stats_t _current;       // frame being drawn
+    frame_stats_t _total_stats;
+
+    uint32_t _frame_start = 0;
+    uint32_t _transaction_start = 0;
+    bool _in_transaction = false;
+
+    uint8_t* _output_line = nullptr;  // RGB888 line for the file output
+
+    uint8_t* _ring = nullptr;
+    size_t _ring_frame_bytes = 0;
+    size_t _ring_count = 0;
+    size_t _ring_next = 0;
+
+    /// Drawing split into bands counts once, for the whole area, in writeBands.
+    void count(uint32_t pixels) { if (!_in_bands) { ++_current.draw_calls; _current.pixels += pixels; } }
+
+    bool init_buffer(void);
+    void release_buffer(void);
+    bool alloc_ring(void);
+    void keep_frame(void);
+    void output_frame(void);
+  };
+
+//----------------------------------------------------------------------------
+ }
+}
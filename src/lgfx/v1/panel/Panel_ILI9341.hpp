@@ -31,6 +31,7 @@ namespace lgfx
     {
       _cfg.memory_width  = _cfg.panel_width  = 240;
       _cfg.memory_height = _cfg.panel_height = 320;
+      _scroll_supported = true;
     }
   };
 
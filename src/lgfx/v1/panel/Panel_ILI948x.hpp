@@ -33,6 +33,7 @@ namespace lgfx
     {
       _cfg.memory_width  = _cfg.panel_width  = 320;
       _cfg.memory_height = _cfg.panel_height = 480;
+      _scroll_supported = true;
     }
 
     void setColorDepth_impl(color_depth_t depth) override
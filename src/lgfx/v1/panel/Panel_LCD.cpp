@@ -72,6 +72,7 @@ namespace lgfx
   void Panel_LCD::end_transaction(void)
   {
     if (!_in_transaction) return;
+    flush_fill_queue();
     _in_transaction = false;
 
     if (_has_align_data)
@@ -116,6 +117,7 @@ namespace lgfx
 
   color_depth_t Panel_LCD::setColorDepth(color_depth_t depth)
   {
+    flush_fill_queue();
     setColorDepth_impl(depth);
 
     update_madctl();
@@ -124,6 +126,7 @@ namespace lgfx
   }
   void Panel_LCD::setRotation(uint_fast8_t r)
   {
+    flush_fill_queue();
     r &= 7;
     _rotation = r;
     // offset_rotationを加算 (0~3:回転方向、 4:上下反転フラグ);
@@ -152,6 +155,8 @@ namespace lgfx
     _xs = _xe = _ys = _ye = INT16_MAX;
 
     update_madctl();
+
+    if (_scroll_height) { reset_scroll(); }
   }
 
   void Panel_LCD::update_madctl(void)
@@ -169,8 +174,27 @@ namespace lgfx
     }
   }
 
+  void Panel_LCD::display(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h)
+  {
+    flush_fill_queue();
+    Panel_Device::display(x, y, w, h);
+  }
+
+  void Panel_LCD::writeCommand(uint32_t data, uint_fast8_t length)
+  {
+    flush_fill_queue();
+    Panel_Device::writeCommand(data, length);
+  }
+
+  void Panel_LCD::writeData(uint32_t data, uint_fast8_t length)
+  {
+    flush_fill_queue();
+    Panel_Device::writeData(data, length);
+  }
+
   void Panel_LCD::write_command(uint32_t data)
   {
+    flush_fill_queue();
     if (!_cfg.dlen_16bit)
     {
       _bus->writeCommand(data, 8);
@@ -188,6 +212,7 @@ namespace lgfx
 
   uint32_t Panel_LCD::readCommand(uint_fast16_t cmd, uint_fast8_t index, uint_fast8_t length)
   {
+    flush_fill_queue();
     size_t dlen = 8 << _cfg.dlen_16bit;
     startWrite();
     write_command(cmd);
@@ -208,6 +233,7 @@ namespace lgfx
 
   uint32_t Panel_LCD::readData(uint_fast8_t index, uint_fast8_t len)
   {
+    flush_fill_queue();
     startWrite();
     auto res = read_bits(index << 3, len << 3);
     endWrite();
@@ -225,6 +251,21 @@ namespace lgfx
   }
 
   void Panel_LCD::setWindow(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye)
+  {
+    flush_fill_queue();
+    _window_by_lcd = true;
+    if (_scroll_offset)
+    { // 折返しを跨ぐ描画は呼出し元で分割済み。跨ぐ窓はスクロール領域の終端で切り詰める;
+      uint_fast16_t end = _scroll_top + _scroll_height;
+      uint_fast16_t my = scroll_map(ys);
+      ye += my - ys;
+      ys = my;
+      if (ys < end && ye >= end) { ye = end - 1; }
+    }
+    set_window(xs, ys, xe, ye);
+  }
+
+  void Panel_LCD::set_window(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye)
   {
     if (!_cfg.dlen_16bit)
     {
@@ -238,6 +279,12 @@ namespace lgfx
 
   void Panel_LCD::drawPixelPreclipped(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor)
   {
+    if (_in_transaction && _fill_queue_mode == fill_queue_enabled && !_scroll_offset)
+    {
+      queue_fill(x, y, 1, 1, rawcolor);
+      return;
+    }
+
     bool tr = _in_transaction;
     if (!tr) begin_transaction();
 
@@ -250,6 +297,30 @@ namespace lgfx
 
   void Panel_LCD::writeFillRectPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor)
   {
+    if (_scroll_offset)
+    { // スクロールの折返し位置で分割する。スクロール中は送信待ちキューを使わない;
+      uint_fast16_t rows;
+      while (h > (rows = scroll_rows(y, h)))
+      {
+        writeFillRectPreclipped(x, y, w, rows, rawcolor);
+        y += rows;
+        h -= rows;
+      }
+    }
+    else
+    if (_fill_queue_mode == fill_queue_enabled)
+    {
+      if (_in_transaction)
+      {
+        queue_fill(x, y, w, h, rawcolor);
+        return;
+      }
+    }
+    else if (_fill_queue_mode == fill_queue_unknown)
+    { // 派生クラスが setWindow を置き換えているか否かを、最初の呼出しで判定する;
+      _window_by_lcd = false;
+    }
+
     uint32_t len = w * h;
     uint_fast16_t xe = w + x - 1;
     uint_fast16_t ye = y + h - 1;
@@ -257,10 +328,88 @@ namespace lgfx
     setWindow(x,y,xe,ye);
     if (_cfg.dlen_16bit) { _has_align_data = (_write_bits & 15) && (len & 1); }
     _bus->writeDataRepeat(rawcolor, _write_bits, len);
+
+    if (_fill_queue_mode == fill_queue_unknown)
+    {
+      _fill_queue_mode = _window_by_lcd ? fill_queue_enabled : fill_queue_disabled;
+    }
+  }
+
+  void Panel_LCD::write_fill(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor)
+  {
+    set_window(x, y, x + w - 1, y + h - 1);
+    uint32_t len = w * h;
+    if (_cfg.dlen_16bit) { _has_align_data = (_write_bits & 15) && (len & 1); }
+    if (len == 1)
+    {
+      _bus->writeData(rawcolor, _write_bits);
+    }
+    else
+    {
+      _bus->writeDataRepeat(rawcolor, _write_bits, len);
+    }
+  }
+
+  void Panel_LCD::flush_fill_queue_impl(void)
+  {
+    uint_fast8_t count = _fill_count;
+    _fill_count = 0;
+    for (uint_fast8_t i = 0; i < count; ++i)
+    {
+      auto& span = _fill_queue[i];
+      write_fill(span.x, span.y, span.w, span.h, span.rawcolor);
+    }
+  }
+
+  void Panel_LCD::queue_fill(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor)
+  {
+    uint_fast16_t xe = x + w;
+    uint_fast16_t ye = y + h;
+
+    // 重なる異色の矩形は先に送信する (異色の矩形同士は重ならないので、送信順は問わない);
+    for (uint_fast8_t i = 0; i < _fill_count; )
+    {
+      auto& span = _fill_queue[i];
+      if (span.rawcolor != rawcolor
+       && span.x < xe && x < span.x + span.w
+       && span.y < ye && y < span.y + span.h)
+      {
+        write_fill(span.x, span.y, span.w, span.h, span.rawcolor);
+        memmove(&_fill_queue[i], &_fill_queue[i + 1], (--_fill_count - i) * sizeof(fill_span_t));
+        continue;
+      }
+      ++i;
+    }
+
+    // 同色で隣接する矩形があれば結合する;
+    for (uint_fast8_t i = 0; i < _fill_count; ++i)
+    {
+      auto& span = _fill_queue[i];
+      if (span.rawcolor != rawcolor) { continue; }
+      if (span.y == y && span.h == h)
+      {
+        if (span.x + span.w == x) { span.w += w; return; }
+        if (xe == span.x) { span.x = x; span.w += w; return; }
+      }
+      if (span.x == x && span.w == w)
+      {
+        if (span.y + span.h == y) { span.h += h; return; }
+        if (ye == span.y) { span.y = y; span.h += h; return; }
+      }
+    }
+
+    if (_fill_count == FILL_QUEUE_LEN)
+    { // 最も古い矩形を送信して空きを作る;
+      auto& span = _fill_queue[0];
+      write_fill(span.x, span.y, span.w, span.h, span.rawcolor);
+      memmove(&_fill_queue[0], &_fill_queue[1], (--_fill_count) * sizeof(fill_span_t));
+    }
+    _fill_queue[_fill_count++] = { (uint16_t)x, (uint16_t)y, (uint16_t)w, (uint16_t)h, rawcolor };
   }
 
   void Panel_LCD::writeBlock(uint32_t rawcolor, uint32_t len)
   {
+    flush_fill_queue();
     _bus->writeDataRepeat(rawcolor, _write_bits, len);
     if (_cfg.dlen_16bit && (_write_bits & 15) && (len & 1))
     {
@@ -270,6 +419,7 @@ namespace lgfx
 
   void Panel_LCD::writePixels(pixelcopy_t* param, uint32_t len, bool use_dma)
   {
+    flush_fill_queue();
     if (param->no_convert)
     {
       _bus->writeBytes(reinterpret_cast<const uint8_t*>(param->src_data), len * _write_bits >> 3, true, use_dma);
@@ -286,6 +436,25 @@ namespace lgfx
 
   void Panel_LCD::writeImage(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param, bool use_dma)
   {
+    flush_fill_queue();
+    if (_scroll_offset)
+    {
+      uint_fast16_t rows;
+      if (h > (rows = scroll_rows(y, h)))
+      { // スクロールの折返し位置で分割し、転送元の行を進めて続きを描画する;
+        auto src_x32 = param->src_x32;
+        auto src_y32 = param->src_y32;
+        do
+        {
+          writeImage(x, y, w, rows, param, use_dma);
+          src_y32 += rows << pixelcopy_t::FP_SCALE;
+          param->src_x32 = src_x32;
+          param->src_y32 = src_y32;
+          y += rows;
+          h -= rows;
+        } while (h > (rows = scroll_rows(y, h)));
+      }
+    }
     auto bytes = param->dst_bits >> 3;
     auto src_x = param->src_x;
 
@@ -408,6 +577,7 @@ namespace lgfx
 
   void Panel_LCD::readRect(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, void* dst, pixelcopy_t* param)
   {
+    flush_fill_queue();
     uint_fast16_t bytes = param->dst_bits >> 3;
     auto len = w * h;
     if (!_cfg.readable)
@@ -416,6 +586,25 @@ namespace lgfx
       return;
     }
 
+    if (_scroll_offset)
+    {
+      uint_fast16_t rows;
+      if (h > (rows = scroll_rows(y, h)))
+      { // スクロールの折返し位置で分割する;
+        startWrite();
+        do
+        {
+          readRect(x, y, w, rows, dst, param);
+          dst = (uint8_t*)dst + w * rows * bytes;
+          y += rows;
+          h -= rows;
+        } while (h > (rows = scroll_rows(y, h)));
+        readRect(x, y, w, h, dst, param);
+        endWrite();
+        return;
+      }
+    }
+
     startWrite();
     setWindow(x, y, x + w - 1, y + h - 1);
 
@@ -448,6 +637,89 @@ namespace lgfx
     return getSwap16(readCommand(CMD_GETSCANLINE, 0, 2));
   }
 
+  uint_fast16_t Panel_LCD::scroll_rows(uint_fast16_t y, uint_fast16_t h) const
+  {
+    uint_fast16_t rows;
+    if (y < _scroll_top)
+    {
+      rows = _scroll_top - y;
+    }
+    else
+    {
+      uint_fast16_t k = y - _scroll_top;
+      if (k >= _scroll_height) { return h; }
+      // 折返し前はメモリ上の領域終端まで、折返し後は表示上の領域終端まで連続する;
+      rows = (k + _scroll_offset < _scroll_height) ? _scroll_height - (k + _scroll_offset) : _scroll_height - k;
+    }
+    return rows < h ? rows : h;
+  }
+
+  void Panel_LCD::write_scroll_param(uint_fast16_t value)
+  {
+    writeData(value >> 8, 1);
+    writeData(value & 0xFF, 1);
+  }
+
+  void Panel_LCD::setHardwareScroll(bool enable)
+  {
+    _scroll_enabled = enable && _scroll_supported;
+    if (!_scroll_enabled && _scroll_height) { reset_scroll(); }
+  }
+
+  void Panel_LCD::reset_scroll(void)
+  {
+    _scroll_top = 0;
+    _scroll_height = 0;
+    _scroll_offset = 0;
+    if (_bus == nullptr) { return; }
+    startWrite();
+    write_command(CMD_VSCRDEF);
+    write_scroll_param(0);
+    write_scroll_param(_cfg.memory_height);
+    write_scroll_param(0);
+    write_command(CMD_VSCRSADD);
+    write_scroll_param(0);
+    _bus->flush();
+    endWrite();
+  }
+
+  bool Panel_LCD::scrollVertical(uint_fast16_t y, uint_fast16_t h, int_fast16_t dy)
+  {
+    if (!_scroll_enabled || h == 0 || _bus == nullptr) { return false; }
+
+    // 行と列の入替えや上下反転がある場合、スクロール方向や基準位置が描画の向きと一致しない;
+    if (getMadCtl(_internal_rotation) & (MAD_MV | MAD_MY)) { return false; }
+
+    uint_fast16_t top = y + _rowstart;
+    if (top + h > _cfg.memory_height) { return false; }
+
+    startWrite();
+    if (_scroll_top != y || _scroll_height != h)
+    { // 移動済みの画像が崩れるため、スクロール中は領域を変更しない;
+      if (_scroll_offset)
+      {
+        endWrite();
+        return false;
+      }
+      _scroll_top = y;
+      _scroll_height = h;
+      write_command(CMD_VSCRDEF);
+      write_scroll_param(top);
+      write_scroll_param(h);
+      write_scroll_param(_cfg.memory_height - top - h);
+    }
+
+    int32_t offset = ((int32_t)_scroll_offset - dy) % (int32_t)h;
+    if (offset < 0) { offset += h; }
+    _scroll_offset = offset;
+
+    write_command(CMD_VSCRSADD);
+    write_scroll_param(top + offset);
+    _bus->flush();
+    endWrite();
+    return true;
+  }
+
   void Panel_LCD::set_window_8(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye, uint32_t cmd)
   {
     static constexpr uint32_t mask = 0xFF00FF;
@@ -40,6 +40,10 @@ namespace lgfx
 
     void waitDisplay(void) override {}
     bool displayBusy(void) override { return false; }
+    void display(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h) override;
+
+    void writeCommand(uint32_t data, uint_fast8_t length) override;
+    void writeData(uint32_t data, uint_fast8_t length) override;
 
     void writePixels(pixelcopy_t* param, uint32_t len, bool use_dma) override;
     void writeBlock(uint32_t rawcolor, uint32_t len) override;
@@ -55,6 +59,20 @@ namespace lgfx
 
     int32_t getScanLine(void) override;
 
+    /// @brief ハードウェア縦スクロール (VSCRDEF / VSCRSADD) を使用する;
+    /// When enabled, LGFXBase::scroll() and the text scroll move a full-width scroll area by
+    /// changing the scroll start address instead of reading and rewriting the pixels, and the
+    /// rows drawn afterwards are remapped, so coordinates stay where they are on the screen.
+    /// Only rotations without row/column exchange or vertical mirror are scrolled by hardware
+    /// (0 and 6 with the default MADCTL table); the others fall back to copyRect.
+    /// A window streamed with setWindow + writePixels is not split, so it should not cross
+    /// the wrap row of the scroll area.  Disabling shows the frame memory unscrolled again.
+    void setHardwareScroll(bool enable);
+    bool getHardwareScroll(void) const { return _scroll_enabled; }
+    /// Rows the scroll area has moved up (0 ~ height of the scroll area - 1).
+    uint16_t getScrollOffset(void) const { return _scroll_offset; }
+    bool scrollVertical(uint_fast16_t y, uint_fast16_t h, int_fast16_t dy) override;
+
   protected:
 
     uint16_t _colstart = 0;
@@ -64,6 +82,34 @@ namespace lgfx
     uint8_t _cmd_ramrd = CMD_RAMRD;
     bool _nop_closing = true; // トランザクション終了時にnopを送るか否か
 
+    /// 単色矩形の送信待ちキュー。;
+    /// Inside a transaction, writeFillRectPreclipped / drawPixelPreclipped are held here, and
+    /// a span adjacent to a held span of the same color (same row band or same column band)
+    /// is merged into it, so one setWindow is sent for both.  Held spans of different colors
+    /// never overlap, so they can be sent in any order.  Every other access to the bus sends
+    /// the held spans first.  A derived class that replaces setWindow does not use the queue.
+    struct fill_span_t
+    {
+      uint16_t x, y, w, h;
+      uint32_t rawcolor;
+    };
+    static constexpr uint8_t FILL_QUEUE_LEN = 8;
+    enum fill_queue_mode_t : uint8_t
+    { fill_queue_unknown
+    , fill_queue_enabled
+    , fill_queue_disabled
+    };
+    fill_span_t _fill_queue[FILL_QUEUE_LEN];
+    uint8_t _fill_count = 0;
+    fill_queue_mode_t _fill_queue_mode = fill_queue_unknown;
+    bool _window_by_lcd = false;  // Panel_LCD::setWindow was used (for fill_queue_unknown)
+
+    bool _scroll_supported = false;  // VSCRDEF / VSCRSADD に対応しているか (派生クラスで設定する);
+    bool _scroll_enabled = false;
+    uint16_t _scroll_top = 0;
+    uint16_t _scroll_height = 0;     // 0 = スクロール領域未設定;
+    uint16_t _scroll_offset = 0;
+
     enum mad_t
     { MAD_MY  = 0x80
     , MAD_MX  = 0x40
@@ -116,7 +162,9 @@ namespace lgfx
     static constexpr uint8_t CMD_PASET   = 0x2B;
     static constexpr uint8_t CMD_RAMWR   = 0x2C;
     static constexpr uint8_t CMD_RAMRD   = 0x2E;
+    static constexpr uint8_t CMD_VSCRDEF = 0x33;
     static constexpr uint8_t CMD_MADCTL  = 0x36;
+    static constexpr uint8_t CMD_VSCRSADD= 0x37;
     static constexpr uint8_t CMD_IDMOFF  = 0x38;
     static constexpr uint8_t CMD_IDMON   = 0x39;
     static constexpr uint8_t CMD_COLMOD  = 0x3A;
@@ -132,6 +180,26 @@ namespace lgfx
     void set_window_8(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye, uint32_t cmd);
     void set_window_16(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye, uint32_t cmd);
 
+    void set_window(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye);
+    void write_fill(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor);
+    void queue_fill(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor);
+    void flush_fill_queue(void) { if (_fill_count) { flush_fill_queue_impl(); } }
+    void flush_fill_queue_impl(void);
+
+    /// スクロール領域内の行を、表示位置に対応するメモリ上の行に変換する;
+    uint_fast16_t scroll_map(uint_fast16_t y) const
+    {
+      uint_fast16_t k = y - _scroll_top;
+      if (k >= _scroll_height) { return y; }
+      k += _scroll_offset;
+      if (k >= _scroll_height) { k -= _scroll_height; }
+      return _scroll_top + k;
+    }
+    /// y から始まるh行のうち、メモリ上で連続している行数;
+    uint_fast16_t scroll_rows(uint_fast16_t y, uint_fast16_t h) const;
+    void write_scroll_param(uint_fast16_t value);
+    void reset_scroll(void);
+
     virtual void update_madctl(void);
 
     virtual uint8_t getColMod(uint8_t bpp) const { return (bpp > 16) ? RGB888_3BYTE : RGB565_2BYTE; }
@@ -34,6 +34,7 @@ namespace lgfx
       _cfg.panel_height = _cfg.memory_height = 162;  // or 160 or 132
 
       _cfg.dummy_read_pixel = 9;
+      _scroll_supported = true;
 
       //freq_write = 27000000;
       //freq_read  = 14000000;
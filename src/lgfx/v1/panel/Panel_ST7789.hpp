@@ -32,6 +32,7 @@ namespace lgfx
       _cfg.panel_height = _cfg.memory_height = 320;
 
       _cfg.dummy_read_pixel = 16;
+      _scroll_supported = true;
     }
 
   protected:
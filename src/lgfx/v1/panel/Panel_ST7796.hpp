@@ -33,6 +33,7 @@ namespace lgfx
       _cfg.panel_height = _cfg.memory_height = 480;
 
       _cfg.dummy_read_pixel = 8;
+      _scroll_supported = true;
     }
 
   protected:
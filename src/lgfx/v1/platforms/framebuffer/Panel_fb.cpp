@@ -24,6 +24,7 @@ Porting for Linux FrameBuffer:
 
 #include "../common.hpp"
 #include "../../Bus.hpp"
+#include "../../misc/common_function.hpp"
 
 #include <list>
 #include <dirent.h>
@@ -36,53 +37,84 @@ namespace lgfx
  inline namespace v1
  {
 //----------------------------------------------------------------------------
-  void Panel_fb::fb_draw_rgb_pixel(int x, int y, uint32_t rawcolor)
+  uint32_t Panel_fb::_fb_color(uint32_t rawcolor) const
   {
-    unsigned int pix_offset = 0;
-    uint8_t r = 0, g = 0, b = 0;
-
-    // GGGBBBBB RRRRRGGG
-    if (_write_depth = color_depth_t::rgb565_2Byte)
+    // 16bpp is handled as rgb565_nonswapped, so only 24/32bpp need a byte order swap.
+    switch (_write_bits)
     {
-      b = (uint8_t)((rawcolor >> 8) & 0b11111);
-      g = (uint8_t)((((rawcolor >> 10) & 0b111000)) | (rawcolor & 0b111));
-      r = (uint8_t)((rawcolor >> 3) & 0b11111);
-
-      pix_offset = x * 2 + y * _fix_info.line_length;
-      unsigned short c = (r << 11) | (g << 5) | b;
-      // write 'two bytes at once'
-      *((unsigned short*)(_fbp + pix_offset)) = c;
+    case 24: return getSwap24(rawcolor);
+    case 32: return getSwap32(rawcolor);
+    default: return rawcolor;
     }
-    // BBBBBBBB GGGGGGGG RRRRRRRR
-    else if (_write_depth = color_depth_t::rgb888_3Byte)
+  }
+
+  void Panel_fb::_fb_swap_span(uint8_t* ptr, uint32_t len) const
+  {
+    if (!len) return;
+    switch (_write_bits)
     {
-      b = (uint8_t)((rawcolor >> 16) & 0xff);
-      g = (uint8_t)((rawcolor >> 8) & 0xff);
-      r = (uint8_t)((rawcolor >> 0) & 0xff);
-
-      pix_offset = x * 3 + y * _fix_info.line_length;
-      *((char*)(_fbp + pix_offset)) = b;
-      *((char*)(_fbp + pix_offset + 1)) = g;
-      *((char*)(_fbp + pix_offset + 2)) = r;
+    case 24:
+      do
+      {
+        std::swap(ptr[0], ptr[2]);
+        ptr += 3;
+      } while (--len);
+      break;
+
+    case 32:
+      {
+        auto p = (uint32_t*)ptr;
+        do
+        {
+          *p = getSwap32(*p);
+          ++p;
+        } while (--len);
+      }
+      break;
+
+    default:
+      break;
     }
   }
 
-  void Panel_fb::fb_draw_argb_pixel(int x, int y, uint32_t rawcolor)
+  struct fb_fill_band_t
+  {
+    Panel_fb* panel;
+    uint_fast16_t x;
+    uint_fast16_t w;
+    uint32_t rawcolor;
+  };
+
+  static void fb_fill_band(void* arg, int32_t y, int32_t h)
   {
-    unsigned int pix_offset = x * 4 + y * _fix_info.line_length;
-
-    uint8_t r = 0, g = 0, b = 0, a = 0;
-
-    // BBBBBBBB GGGGGGGG RRRRRRRR AAAAAAAA
-    b = (uint8_t)((rawcolor >> 24) & 0xff);
-    g = (uint8_t)((rawcolor >> 16) & 0xff);
-    r = (uint8_t)((rawcolor >> 8) & 0xff);
-    a = (uint8_t)((rawcolor >> 0) & 0xff);
-    
-    *((char*)(_fbp + pix_offset)) = b;
-    *((char*)(_fbp + pix_offset + 1)) = g;
-    *((char*)(_fbp + pix_offset + 2)) = r;
-    *((char*)(_fbp + pix_offset + 3)) = a;
+    auto b = (fb_fill_band_t*)arg;
+    b->panel->Panel_fb::writeFillRectPreclipped(b->x, y, b->w, h, b->rawcolor);
+  }
+
+  struct fb_image_band_t
+  {
+    Panel_fb* panel;
+    uint_fast16_t x;
+    uint_fast16_t y;
+    uint_fast16_t w;
+    pixelcopy_t* param;
+    bool argb;
+  };
+
+  static void fb_image_band(void* arg, int32_t y, int32_t h)
+  {
+    auto b = (fb_image_band_t*)arg;
+    // 帯ごとにpixelcopyを複製し、帯の先頭行まで転送元を進める;
+    pixelcopy_t pc = *b->param;
+    pc.src_y32 += (y - b->y) << pixelcopy_t::FP_SCALE;
+    if (b->argb)
+    {
+      b->panel->Panel_fb::writeImageARGB(b->x, y, b->w, h, &pc);
+    }
+    else
+    {
+      b->panel->Panel_fb::writeImage(b->x, y, b->w, h, &pc, false);
+    }
   }
 
   Panel_fb::~Panel_fb(void)
@@ -173,7 +205,14 @@ namespace lgfx
 
   color_depth_t Panel_fb::setColorDepth(color_depth_t depth)
   {
-    // TODO
+    // The framebuffer stores pixels in host byte order.
+    // 16bpp maps directly to rgb565_nonswapped, 24/32bpp are swapped per span in _fb_swap_span.
+    switch (depth & color_depth_t::bit_mask)
+    {
+    case 32: depth = color_depth_t::argb8888_4Byte;    break;
+    case 24: depth = color_depth_t::rgb888_3Byte;      break;
+    default: depth = color_depth_t::rgb565_nonswapped; break;
+    }
     _write_bits = depth;
     _read_bits = depth;
     _write_depth = depth;
@@ -210,6 +249,16 @@ namespace lgfx
     _ye = ye;
   }
 
+  // 各描画関数は行ごとに独立しており、異なる行を同時に描画しても干渉しない;
+  bool Panel_fb::writeBands(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, void (*func)(void* arg, int32_t y, int32_t h), void* arg)
+  {
+    if (!use_bands(w, h)) { return false; }
+    _in_bands = true;
+    _worker_pool->run(y, h, func, arg);
+    _in_bands = false;
+    return true;
+  }
+
   void Panel_fb::drawPixelPreclipped(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor)
   {
     uint_fast8_t rotation = _internal_rotation;
@@ -220,18 +269,9 @@ namespace lgfx
       if (rotation & 1) { std::swap(x, y); }
     }
 
-    switch (_write_depth)
-    {
-      case color_depth_t::rgb565_2Byte:
-      case color_depth_t::rgb888_3Byte:
-        fb_draw_rgb_pixel(x, y, rawcolor);
-        break;
-      case color_depth_t::argb8888_4Byte:
-        fb_draw_argb_pixel(x, y, rawcolor);
-        break;
-      default:
-        break;
-    }
+    size_t bytes = _write_bits >> 3;
+    uint32_t color = _fb_color(rawcolor);
+    memcpy(&_fb_line(y)[x * bytes], &color, bytes);
 
     if (!getStartCount())
     {
@@ -241,6 +281,12 @@ namespace lgfx
 
   void Panel_fb::writeFillRectPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor)
   {
+    if (use_bands(w, h))
+    {
+      fb_fill_band_t band = { this, x, w, rawcolor };
+      writeBands(x, y, w, h, fb_fill_band, &band);
+      return;
+    }
     uint_fast8_t rotation = _internal_rotation;
     if (rotation)
     {
@@ -249,26 +295,25 @@ namespace lgfx
       if (rotation & 1) { std::swap(x, y);  std::swap(w, h); }
     }
 
-    for (size_t width = 0; width < w; width++)
+    size_t bytes = _write_bits >> 3;
+    size_t len = w * bytes;
+    size_t stride = _fix_info.line_length;
+    auto src = &_fb_line(y)[x * bytes];
+
+    // full width fills are a single contiguous range.
+    if (x == 0 && len == stride)
     {
-      for (size_t height = 0; height < h; height++)
-      {
-        uint_fast16_t x_pos = x + width;
-        uint_fast16_t y_pos = y + height;
+      memset_multi(src, _fb_color(rawcolor), bytes, w * h);
+      return;
+    }
 
-        switch (_write_depth)
-        {
-          case color_depth_t::rgb565_2Byte:
-          case color_depth_t::rgb888_3Byte:
-            fb_draw_rgb_pixel(x_pos, y_pos, rawcolor);
-            break;
-          case color_depth_t::argb8888_4Byte:
-            fb_draw_argb_pixel(x_pos, y_pos, rawcolor);
-            break;
-          default:
-            break;
-        }
-      }
+    // fill the first row with the pattern, then copy it to the following rows.
+    memset_multi(src, _fb_color(rawcolor), bytes, w);
+    auto dst = src;
+    while (--h)
+    {
+      dst += stride;
+      memcpy(dst, src, len);
     }
   }
 
@@ -324,15 +369,13 @@ namespace lgfx
 
   void Panel_fb::writePixels(pixelcopy_t* param, uint32_t length, bool use_dma)
   {
-    // NOT TEST
     uint_fast16_t xs = _xs;
     uint_fast16_t xe = _xe;
     uint_fast16_t ys = _ys;
     uint_fast16_t ye = _ye;
     uint_fast16_t x = _xpos;
     uint_fast16_t y = _ypos;
-    const size_t bits = _write_bits;
-    auto k = _cfg.panel_width * bits >> 3;
+    const size_t bytes = _write_bits >> 3;
 
     uint_fast8_t r = _internal_rotation;
     if (!r)
@@ -340,7 +383,9 @@ namespace lgfx
       uint_fast16_t linelength;
       do {
         linelength = std::min<uint_fast16_t>(xe - x + 1, length);
-        param->fp_copy(&_fbp[y * k], x, x + linelength, param);
+        auto ptr = &_fb_line(y)[x * bytes];
+        param->fp_copy(ptr, 0, linelength, param);
+        _fb_swap_span(ptr, linelength);
         if ((x += linelength) > xe)
         {
           x = xs;
@@ -356,70 +401,21 @@ namespace lgfx
     int_fast16_t ay = 1;
     if ((1u << r) & 0b10010110) { y = _height - (y + 1); ys = _height - (ys + 1); ye = _height - (ye + 1); ay = -1; }
     if (r & 2)                  { x = _width  - (x + 1); xs = _width  - (xs + 1); xe = _width  - (xe + 1); ax = -1; }
-    if (param->no_convert)
-    {
-      size_t bytes = bits >> 3;
-      size_t xw = 1;
-      size_t yw = _cfg.panel_width;
-      if (r & 1) std::swap(xw, yw);
-      size_t idx = y * yw + x * xw;
-      auto data = (uint8_t*)param->src_data;
-      do
-      {
-        auto dst = &_fbp[idx * bytes];
-        size_t b = 0;
-        do
-        {
-          dst[b] = *data++;
-        } while (++b < bytes);
-        if (x != xe)
-        {
-          idx += xw * ax;
-          x += ax;
-        }
-        else
-        {
-          x = xs;
-          y = (y != ye) ? (y + ay) : ys;
-          idx = y * yw + x * xw;
-        }
-      } while (--length);
-    }
-    else
+    do
     {
-      if (r & 1)
+      auto ptr = (r & 1) ? &_fb_line(x)[y * bytes] : &_fb_line(y)[x * bytes];
+      param->fp_copy(ptr, 0, 1, param);
+      _fb_swap_span(ptr, 1);
+      if (x != xe)
       {
-        do
-        {
-          param->fp_copy(&_fbp[x * k], y, y + 1, param);
-          if (x != xe)
-          {
-            x += ax;
-          }
-          else
-          {
-            x = xs;
-            y = (y != ye) ? (y + ay) : ys;
-          }
-        } while (--length);
+        x += ax;
       }
       else
       {
-        do
-        {
-          param->fp_copy(&_fbp[y * k], x, x + 1, param);
-          if (x != xe)
-          {
-            x += ax;
-          }
-          else
-          {
-            x = xs;
-            y = (y != ye) ? (y + ay) : ys;
-          }
-        } while (--length);
+        x = xs;
+        y = (y != ye) ? (y + ay) : ys;
       }
-    }
+    } while (--length);
     if ((1u << r) & 0b10010110) { y = _height - (y + 1); }
     if (r & 2)                  { x = _width  - (x + 1); }
     _xpos = x;
@@ -428,30 +424,33 @@ namespace lgfx
 
   void Panel_fb::writeImage(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param, bool)
   {
-    // NOT TEST
+    if (use_bands(w, h))
+    {
+      fb_image_band_t band = { this, x, y, w, param, false };
+      writeBands(x, y, w, h, fb_image_band, &band);
+      return;
+    }
     uint_fast8_t r = _internal_rotation;
+    const size_t bytes = _write_bits >> 3;
     if (r == 0 && param->transp == pixelcopy_t::NON_TRANSP && param->no_convert)
     {
-      auto sx = param->src_x;
-      auto bits = param->src_bits;
-
-      auto bw = _cfg.panel_width * bits >> 3;
-      auto dst = &_fbp[bw * y];
-      auto sw = param->src_bitwidth * bits >> 3;
-      auto src = &((uint8_t*)param->src_data)[param->src_y * sw];
-      if (sw == bw && this->_cfg.panel_width == w && sx == 0 && x == 0)
+      auto sw = param->src_bitwidth * bytes;
+      auto src = &((uint8_t*)param->src_data)[param->src_y * sw + param->src_x * bytes];
+      auto dst = &_fb_line(y)[x * bytes];
+      size_t stride = _fix_info.line_length;
+      size_t len = w * bytes;
+      if (sw == stride && len == stride && _write_bits == 16)
       {
-        memcpy(dst, src, bw * h);
+        memcpy(dst, src, len * h);
         return;
       }
-      y = 0;
-      dst +=  x * bits >> 3;
-      src += sx * bits >> 3;
-      w    =  w * bits >> 3;
       do
       {
-        memcpy(&dst[y * bw], &src[y * sw], w);
-      } while (++y != h);
+        memcpy(dst, src, len);
+        _fb_swap_span(dst, w);
+        src += sw;
+        dst += stride;
+      } while (--h);
       return;
     }
 
@@ -464,22 +463,32 @@ namespace lgfx
     uint32_t sx32 = param->src_x32;
     uint32_t sy32 = param->src_y32;
 
-    y *= _cfg.panel_width;
+    h += y;
     do
     {
-      int32_t pos = x + y;
+      auto line = _fb_line(y);
+      int32_t pos = x;
       int32_t end = pos + w;
-      while (end != (pos = param->fp_copy(_fbp, pos, end, param))
-         &&  end != (pos = param->fp_skip(      pos, end, param)));
+      do
+      {
+        int32_t copied = param->fp_copy(line, pos, end, param);
+        _fb_swap_span(&line[pos * bytes], copied - pos);
+        if (copied == end) break;
+        pos = param->fp_skip(copied, end, param);
+      } while (pos != end);
       param->src_x32 = (sx32 += nextx);
       param->src_y32 = (sy32 += nexty);
-      y += _cfg.panel_width;
-    } while (--h);
+    } while (++y != h);
   }
 
   void Panel_fb::writeImageARGB(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param)
   {
-    // NOT TEST
+    if (use_bands(w, h))
+    {
+      fb_image_band_t band = { this, x, y, w, param, true };
+      writeBands(x, y, w, h, fb_image_band, &band);
+      return;
+    }
     uint32_t nextx = 0;
     uint32_t nexty = 1 << pixelcopy_t::FP_SCALE;
     if (_internal_rotation)
@@ -489,17 +498,19 @@ namespace lgfx
     uint32_t sx32 = param->src_x32;
     uint32_t sy32 = param->src_y32;
 
-    uint32_t pos = x + y * _cfg.panel_width;
-    uint32_t end = pos + w;
-    param->fp_copy(_fbp, pos, end, param);
-    while (--h)
+    const size_t bytes = _write_bits >> 3;
+    uint32_t end = x + w;
+    h += y;
+    do
     {
-      pos += _cfg.panel_width;
-      end = pos + w;
+      auto line = _fb_line(y);
+      // alpha blending reads the destination, so bring it into the panel byte order first.
+      _fb_swap_span(&line[x * bytes], w);
+      param->fp_copy(line, x, end, param);
+      _fb_swap_span(&line[x * bytes], w);
       param->src_x32 = (sx32 += nextx);
       param->src_y32 = (sy32 += nexty);
-      param->fp_copy(_fbp, pos, end, param);
-    }
+    } while (++y != h);
   }
 
   void Panel_fb::readRect(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, void* dst, pixelcopy_t* param)
@@ -518,19 +529,22 @@ namespace lgfx
       if (r & 1) { std::swap(src_x, src_y);  std::swap(dst_x, dst_y);  std::swap(w, h); }
     }
 
-    if ((dst_x + w) > _var_info.xres) w = _var_info.xres - dst_x;
-    if ((dst_y + h) > _var_info.yres) h = _var_info.yres - dst_y;
+    // _cfg.panel_width may not be the screen width, so clamp to _var_info.xres / yres.
+    uint_fast16_t max_x = std::max(src_x, dst_x);
+    uint_fast16_t max_y = std::max(src_y, dst_y);
+    if (max_x >= _var_info.xres || max_y >= _var_info.yres) return;
+    if ((max_x + w) > _var_info.xres) w = _var_info.xres - max_x;
+    if ((max_y + h) > _var_info.yres) h = _var_info.yres - max_y;
     size_t bytes = _write_bits >> 3;
     size_t len = w * bytes;
-    int32_t add = _var_info.xres * bytes;  // _cfg.panel_width may not was the screen width, use _var_info.xres instead.
-    char *src = (_fbp + (src_x * bytes + src_y * _fix_info.line_length));
-    char *dst = (_fbp + (dst_x * bytes + dst_y * _fix_info.line_length));
+    int32_t add = 1;
+    if (src_y < dst_y) add = -add;
+    int32_t pos = (src_y < dst_y) ? h - 1 : 0;
 
     do
     {
-      memmove(dst, src, len);
-      src += add;
-      dst += add;
+      memmove(&_fb_line(dst_y + pos)[dst_x * bytes], &_fb_line(src_y + pos)[src_x * bytes], len);
+      pos += add;
     } while (--h);
   }
 
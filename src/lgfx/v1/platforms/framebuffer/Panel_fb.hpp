@@ -22,6 +22,7 @@ Porting for Linux FrameBuffer:
 
 #include "../../panel/Panel_Device.hpp"
 #include "../../misc/range.hpp"
+#include "../../misc/WorkerPool.hpp"
 #include "../../Touch.hpp"
 
 #include <unistd.h>
@@ -76,6 +77,14 @@ namespace lgfx
     void readRect(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, void* dst, pixelcopy_t* param) override;
     void copyRect(uint_fast16_t dst_x, uint_fast16_t dst_y, uint_fast16_t w, uint_fast16_t h, uint_fast16_t src_x, uint_fast16_t src_y) override;
 
+    bool writeBands(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, void (*func)(void* arg, int32_t y, int32_t h), void* arg) override;
+
+    /// 大きな塗り潰し・画像転送を横方向の帯に分割し、poolのスレッドで並列に描画する。;
+    /// min_pixels より小さい範囲と、1ピクセルが1バイトに満たない色深度では、呼出し元のスレッドで描画する。;
+    /// nullptr を指定すると無効になる。;
+    void setWorkerPool(WorkerPool* pool, uint32_t min_pixels = 32768) { _worker_pool = pool; _band_min_pixels = min_pixels; }
+    WorkerPool* getWorkerPool(void) const { return _worker_pool; }
+
     uint_fast8_t getTouchRaw(touch_point_t* tp, uint_fast8_t count) override;
 
     // init前に使用し、操作対象とするフレームバッファのパス名、または、デバイス名称 ("st7789") 等の文字列へのポインタを指定する。
@@ -99,11 +108,18 @@ namespace lgfx
     int32_t _xpos = 0;
     int32_t _ypos = 0;
 
+    WorkerPool* _worker_pool = nullptr;
+    uint32_t _band_min_pixels = 32768;
+    bool _in_bands = false;
+
+    bool use_bands(uint_fast16_t w, uint_fast16_t h) const { return _worker_pool && !_in_bands && _write_bits >= 8 && h > 1 && (uint32_t)w * h >= _band_min_pixels; }
+
     void _rotate_pixelcopy(uint_fast16_t& x, uint_fast16_t& y, uint_fast16_t& w, uint_fast16_t& h, pixelcopy_t* param, uint32_t& nextx, uint32_t& nexty);
 
   private:
-    void fb_draw_rgb_pixel(int x, int y, uint32_t rawcolor);
-    void fb_draw_argb_pixel(int x, int y, uint32_t rawcolor);
+    uint8_t* _fb_line(uint_fast16_t y) const { return (uint8_t*)&_fbp[y * _fix_info.line_length]; }
+    uint32_t _fb_color(uint32_t rawcolor) const;
+    void _fb_swap_span(uint8_t* ptr, uint32_t len) const;
   };
 
 //----------------------------------------------------------------------------
@@ -23,22 +23,24 @@ Contributors:
 #include "../common.hpp"
 #include "../../Bus.hpp"
 
+#include <chrono>
 #include <list>
+#include <mutex>
+#include <thread>
 
 namespace lgfx
 {
  inline namespace v1
  {
-  struct cvmat_info_t
-  {
-    Panel_OpenCV* panel;
-    cv::Mat* cvmat;
-    const char* window_name;
-    //bool init;
-  };
-  static std::list<cvmat_info_t> _list_mat;
+  static std::list<Panel_OpenCV*> _list_panel;
+  static std::mutex _list_mutex;
   static int _window_no;
 
+  static std::atomic<uint32_t> _target_fps { 60 };
+  static std::atomic<uint32_t> _next_present { 0 };
+  static std::thread _presenter;
+  static std::atomic<bool> _presenter_quit { false };
+
 //----------------------------------------------------------------------------
 
   static void memset_multi(uint8_t* buf, uint32_t c, size_t size, size_t length)
@@ -98,25 +100,132 @@ namespace lgfx
     }
   }
 
+  void Panel_OpenCV::_present(void)
+  {
+    if (-1 == cv::getWindowProperty(_window_name, cv::WND_PROP_AUTOSIZE))
+    {
+      cv::namedWindow(_window_name, cv::WINDOW_AUTOSIZE);
+      cv::setMouseCallback(_window_name, cv_mouse_callback, &_touch_point);
+      _shown_counter = ~_modified_counter;  // 作成直後のウィンドウには必ず表示する;
+    }
+
+    uint32_t modified = _modified_counter;
+    auto draw_thread = _draw_thread.load();
+    bool drawing = (draw_thread != std::thread::id());
+    // startWriteしたまま描画を続けるスケッチは変化を数えられないため、描画中は毎回表示する;
+    if (_shown_counter == modified && !drawing) { return; }
+    _shown_counter = modified;
+
+    // 前回の表示以降に完了したフレームのうち、最後の1枚以外は表示されずに失われる;
+    uint32_t frames = _frame_counter;
+    uint32_t shown = _shown_frame.exchange(frames);
+    if (frames - shown > 1) { _dropped += frames - shown - 1; }
+    ++_presented;
+
+    // 描画スレッドが書き換えを続けるため、表示用の画像へ変換しながら複製する;
+    // 描画の終了は1フレームまで待ち、同じ描画 (startWriteしたままの描画等) では再び待たずに複製する;
+    // 描画スレッド自身から呼ばれた場合は描画が止まっているため、ロックせずに複製する (自スレッドが保持するロックは取得できない);
+    {
+      std::unique_lock<std::timed_mutex> lock(_draw_mutex, std::defer_lock);
+      if (draw_thread != std::this_thread::get_id() && !lock.try_lock())
+      {
+        uint32_t transaction = _transaction_counter;
+        if (_waited_transaction != transaction)
+        {
+          _waited_transaction = transaction;
+          uint32_t fps = _target_fps;
+          lock.try_lock_for(std::chrono::microseconds(fps ? 1000000u / fps : 0));
+        }
+      }
+      cv::cvtColor(_cv_mat, _show_mat, cv::COLOR_BGR2RGB);
+    }
+    cv::imshow(_window_name, _show_mat);
+  }
+
   void Panel_OpenCV::imshowall(void)
   {
-    cv::Mat mat;
-    for (auto& info : _list_mat)
     {
-      if (-1 == cv::getWindowProperty(info.window_name, cv::WND_PROP_AUTOSIZE))
+      std::lock_guard<std::mutex> lock(_list_mutex);
+      for (auto panel : _list_panel)
       {
-        cv::namedWindow(info.window_name, cv::WINDOW_AUTOSIZE);
-        cv::setMouseCallback(info.window_name, cv_mouse_callback, &(info.panel->_touch_point));
+        panel->_present();
       }
-      cv::cvtColor(*(info.cvmat), mat, cv::COLOR_BGR2RGB);
-      cv::imshow(info.window_name, mat);
-      mat.release();
     }
-    cv::waitKey(10);
+
+    uint32_t fps = _target_fps;
+    if (fps == 0)
+    {
+      cv::waitKey(1);
+      return;
+    }
+    uint32_t interval = 1000000u / fps;
+    // presenterと描画スレッドの両方から呼ばれる場合があるため、予定時刻は各呼出しが1間隔ずつ進める;
+    uint32_t next = _next_present.fetch_add(interval) + interval;
+    int32_t remain = (int32_t)(next - lgfx::micros());
+    if (remain < -(int32_t)interval)
+    { // 大きく遅れた場合は、遅れを取り戻そうとせず現在時刻から数え直す;
+      next = lgfx::micros();
+      _next_present = next;
+      remain = 0;
+    }
+    // waitKeyはウィンドウのイベント処理を兼ねるため、最低1回は呼び出す;
+    do
+    {
+      cv::waitKey(remain > 1000 ? remain / 1000 : 1);
+      remain = (int32_t)(next - lgfx::micros());
+    } while (remain > 0);
+  }
+
+  void Panel_OpenCV::setTargetFps(uint32_t fps)
+  {
+    _target_fps = fps;
+  }
+
+  uint32_t Panel_OpenCV::getTargetFps(void)
+  {
+    return _target_fps;
+  }
+
+  bool Panel_OpenCV::startPresenter(uint32_t fps)
+  {
+    if (_presenter.joinable()) { return false; }
+    _target_fps = fps;
+    _presenter_quit = false;
+    _presenter = std::thread([]
+    {
+      while (!_presenter_quit) { imshowall(); }
+    });
+    return true;
+  }
+
+  void Panel_OpenCV::stopPresenter(void)
+  {
+    if (!_presenter.joinable()) { return; }
+    _presenter_quit = true;
+    _presenter.join();
+  }
+
+  Panel_OpenCV::present_stats_t Panel_OpenCV::getPresentStats(void) const
+  {
+    present_stats_t res;
+    res.presented = _presented;
+    res.dropped = _dropped;
+    return res;
+  }
+
+  void Panel_OpenCV::resetPresentStats(void)
+  {
+    _presented = 0;
+    _dropped = 0;
+    _shown_frame = _frame_counter.load();
   }
 
   Panel_OpenCV::~Panel_OpenCV(void)
   {
+    {
+      std::lock_guard<std::mutex> lock(_list_mutex);
+      _list_panel.remove(this);
+    }
     _img = nullptr;
     _cv_mat.release();
   }
@@ -132,8 +241,10 @@ namespace lgfx
     _img = _cv_mat.data;
     sprintf(_window_name, "LGFX_OpenCV_%d", ++_window_no);
 
-    _list_mat.emplace_back(cvmat_info_t{ this, &_cv_mat, _window_name });
-//  _list_mat.push_back(std::make_pair(_window_name, &_cv_mat));
+    {
+      std::lock_guard<std::mutex> lock(_list_mutex);
+      _list_panel.push_back(this);
+    }
 
 //    cv::imshow(_window_name, _cv_mat);
 //    cv::setMouseCallback(_window_name, cv_mouse_callback, &_touch_point);
@@ -143,8 +254,8 @@ namespace lgfx
 
   void Panel_OpenCV::display(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h)
   {
-//    cv::imshow(_window_name, _cv_mat);
-//    cv::pollKey();
+    ++_modified_counter;
+    ++_frame_counter;
   }
 
   color_depth_t Panel_OpenCV::setColorDepth(color_depth_t depth)
@@ -156,9 +267,23 @@ namespace lgfx
     return color_depth_t::rgb888_3Byte;
   }
 
-  void Panel_OpenCV::beginTransaction(void) {}
+  void Panel_OpenCV::beginTransaction(void)
+  {
+    if (_draw_locked) { return; }
+    _draw_mutex.lock();
+    _draw_locked = true;
+    ++_transaction_counter;
+    _draw_thread = std::this_thread::get_id();
+  }
 
-  void Panel_OpenCV::endTransaction(void) {}
+  void Panel_OpenCV::endTransaction(void)
+  {
+    ++_modified_counter;
+    if (!_draw_locked) { return; }
+    _draw_locked = false;
+    _draw_thread = std::thread::id();
+    _draw_mutex.unlock();
+  }
 
   void Panel_OpenCV::setRotation(uint_fast8_t r)
   {
@@ -197,14 +322,15 @@ namespace lgfx
 
     size_t bw = _cfg.panel_width;
     size_t index = x + y * bw;
+    if (!getStartCount())
     {
-      auto img = &((bgr888_t*)_img)[index];
-      *img = rawcolor;
+      std::lock_guard<std::timed_mutex> lock(_draw_mutex);
+      ((bgr888_t*)_img)[index] = rawcolor;
+      ++_modified_counter;
     }
-
-    if (!getStartCount())
+    else
     {
-      display(x, y, 1, 1);
+      ((bgr888_t*)_img)[index] = rawcolor;
     }
   }
 
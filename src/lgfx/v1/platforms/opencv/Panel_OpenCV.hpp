@@ -23,6 +23,10 @@ Contributors:
 
 #include <opencv2/opencv.hpp>
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+
 namespace lgfx
 {
  inline namespace v1
@@ -33,8 +37,30 @@ namespace lgfx
   {
 
   public:
+    struct present_stats_t
+    {
+      uint32_t presented = 0;  // number of times the window was updated
+      uint32_t dropped = 0;    // frames (display calls) drawn over before they were shown
+    };
+
+    /// 描画内容が変化したウィンドウのみを更新し、目標フレームレートに合わせて待機する;
+    /// Call it repeatedly from the thread that owns the windows (e.g. main), or use startPresenter.
+    /// A panel inside startWrite ~ endWrite is updated every time, since its changes are counted at endWrite.
+    /// It may also be called by the drawing thread itself inside startWrite ~ endWrite.
     static void imshowall(void);
 
+    /// Target rate of imshowall.  0 = no pacing (only the window events are processed).
+    static void setTargetFps(uint32_t fps);
+    static uint32_t getTargetFps(void);
+
+    /// Calls imshowall repeatedly in a thread of its own.  Other threads must not use HighGUI then.
+    /// On macOS, where windows belong to the main thread, call imshowall from main instead.
+    static bool startPresenter(uint32_t fps = 60);
+    static void stopPresenter(void);
+
+    present_stats_t getPresentStats(void) const;
+    void resetPresentStats(void);
+
     Panel_OpenCV(void);
     virtual ~Panel_OpenCV(void);
 
@@ -72,10 +98,24 @@ namespace lgfx
     touch_point_t _touch_point;
     uint8_t* _img;
     cv::Mat _cv_mat;
+    cv::Mat _show_mat;  // RGB → BGR 変換済みの表示用画像 (毎回確保せず再利用する);
+
+    std::timed_mutex _draw_mutex;  // 描画中 (startWrite～endWrite) は保持し、表示用の複製と排他する;
+    bool _draw_locked = false;
+    std::atomic<std::thread::id> _draw_thread { std::thread::id() };  // thread inside startWrite ~ endWrite
+    std::atomic<uint32_t> _transaction_counter { 0 };  // counted up by startWrite
+    uint32_t _waited_transaction = 0;                  // transaction the presenter already waited for
+    std::atomic<uint32_t> _modified_counter { 0 };  // counted up when a drawing ends
+    std::atomic<uint32_t> _frame_counter { 0 };     // counted up by display()
+    uint32_t _shown_counter = 0;
+    std::atomic<uint32_t> _shown_frame { 0 };
+    std::atomic<uint32_t> _presented { 0 };
+    std::atomic<uint32_t> _dropped { 0 };
     int32_t _xpos = 0;
     int32_t _ypos = 0;
 
     void _rotate_pixelcopy(uint_fast16_t& x, uint_fast16_t& y, uint_fast16_t& w, uint_fast16_t& h, pixelcopy_t* param, uint32_t& nextx, uint32_t& nexty);
+    void _present(void);
   };
 
 //----------------------------------------------------------------------------
@@ -382,13 +382,27 @@ namespace lgfx
   Panel_sdl::lock_t::lock_t(Panel_sdl* parent)
   : _parent { parent }
   {
-    SDL_LockMutex(parent->_sdl_mutex);
+    /// トランザクション単位でロック中の場合は描画毎のロックを行わない;
+    /// 帯の描画中はwriteBandsを呼んだスレッドがロックしているため、ワーカースレッドはロックしない;
+    if (!parent->_in_transaction && !parent->_in_bands)
+    {
+      SDL_LockMutex(parent->_sdl_mutex);
+    }
   };
 
   Panel_sdl::lock_t::~lock_t(void)
   {
+    if (_parent->_in_bands) { return; }
     ++_parent->_modified_counter;
-    SDL_UnlockMutex(_parent->_sdl_mutex);
+    if (!_parent->_in_transaction)
+    {
+      SDL_UnlockMutex(_parent->_sdl_mutex);
+      _parent->_request_update();
+    }
+  };
+
+  void Panel_sdl::_request_update(void)
+  {
     if (SDL_SemValue(_update_in_semaphore) < 2)
     {
       SDL_SemPost(_update_in_semaphore);
@@ -396,7 +410,28 @@ namespace lgfx
         SDL_SemWaitTimeout(_update_out_semaphore, 1);
       }
     }
-  };
+  }
+
+  void Panel_sdl::beginTransaction(void)
+  {
+    if (_transaction_lock && !_in_transaction)
+    {
+      SDL_LockMutex(_sdl_mutex);
+      _in_transaction = true;
+    }
+  }
+
+  void Panel_sdl::endTransaction(void)
+  {
+    if (_in_transaction)
+    {
+      _in_transaction = false;
+      SDL_UnlockMutex(_sdl_mutex);
+      _request_update();
+      /// endWrite内のdisplay呼出しはロック中のため、ここで改めて反映を待つ;
+      display(0, 0, 0, 0);
+    }
+  }
 
   void Panel_sdl::drawPixelPreclipped(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor)
   {
@@ -434,13 +469,25 @@ namespace lgfx
     Panel_FrameBufferBase::writePixels(param, len, use_dma);
   }
 
+  void Panel_sdl::copyRect(uint_fast16_t dst_x, uint_fast16_t dst_y, uint_fast16_t w, uint_fast16_t h, uint_fast16_t src_x, uint_fast16_t src_y)
+  {
+    lock_t lock(this);
+    Panel_FrameBufferBase::copyRect(dst_x, dst_y, w, h, src_x, src_y);
+  }
+
+  bool Panel_sdl::writeBands(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, void (*func)(void* arg, int32_t y, int32_t h), void* arg)
+  {
+    lock_t lock(this);
+    return Panel_FrameBufferBase::writeBands(x, y, w, h, func, arg);
+  }
+
   void Panel_sdl::display(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h)
   {
     (void)x;
     (void)y;
     (void)w;
     (void)h;
-    if (_in_step_exec)
+    if (_in_step_exec && !_in_transaction)
     {
       if (_display_counter != _modified_counter) {
         do {
@@ -539,11 +586,14 @@ namespace lgfx
     if (monitor.renderer == nullptr)
     {
       sdl_create(&monitor);
+
+      /// 作成直後のテクスチャは内容が不定のため、初回は全面を転送する;
+      _texture_reset = true;
     }
 
     bool step_exec = _in_step_exec;
 
-    if (_texupdate_counter != _modified_counter) {
+    if (_texture_reset || _texupdate_counter != _modified_counter) {
       pixelcopy_t pc(nullptr, color_depth_t::rgb888_3Byte, _write_depth, false);
       if (_write_depth == rgb565_2Byte) {
         pc.fp_copy = pixelcopy_t::copy_rgb_fast<bgr888_t, swap565_t>;
@@ -555,17 +605,48 @@ namespace lgfx
         pc.fp_copy = pixelcopy_t::copy_rgb_fast<bgr888_t, grayscale_t>;
       }
 
-      if (0 == SDL_LockMutex(_sdl_mutex))
+      /// トランザクション単位のロック時は描画スレッドの処理完了を待たずに次回へ回す;
+      if (0 == (_transaction_lock ? SDL_TryLockMutex(_sdl_mutex) : SDL_LockMutex(_sdl_mutex)))
       {
         _texupdate_counter = _modified_counter;
-        for (int y = 0; y < _cfg.panel_height; ++y)
+        if (_texture_reset)
+        {
+          _texture_reset = false;
+          _range_mod.left   = 0;
+          _range_mod.top    = 0;
+          _range_mod.right  = _cfg.panel_width  - 1;
+          _range_mod.bottom = _cfg.panel_height - 1;
+        }
+
+        /// 前回の転送以降に描画された範囲のみを変換・転送する;
+        int l = std::max<int>(0, _range_mod.left);
+        int t = std::max<int>(0, _range_mod.top);
+        int r = std::min<int>(_cfg.panel_width  - 1, _range_mod.right);
+        int b = std::min<int>(_cfg.panel_height - 1, _range_mod.bottom);
+        _range_mod.top = INT16_MAX;
+        _range_mod.left = INT16_MAX;
+        _range_mod.right = 0;
+        _range_mod.bottom = 0;
+
+        if (l <= r && t <= b)
+        {
+          for (int y = t; y <= b; ++y)
+          {
+            pc.src_x32 = l;
+            pc.src_data = _lines_buffer[y];
+            pc.fp_copy(&_texturebuf[y * _cfg.panel_width], l, r + 1, &pc);
+          }
+          SDL_UnlockMutex(_sdl_mutex);
+
+          SDL_Rect rect = { l, t, r - l + 1, b - t + 1 };
+          _upload_pixels = rect.w * rect.h;
+          SDL_UpdateTexture(monitor.texture, &rect, &_texturebuf[t * _cfg.panel_width + l], _cfg.panel_width * sizeof(rgb888_t));
+        }
+        else
         {
-          pc.src_x32 = 0;
-          pc.src_data = _lines_buffer[y];
-          pc.fp_copy(&_texturebuf[y * _cfg.panel_width], 0, _cfg.panel_width, &pc);
+          SDL_UnlockMutex(_sdl_mutex);
+          _upload_pixels = 0;
         }
-        SDL_UnlockMutex(_sdl_mutex);
-        SDL_UpdateTexture(monitor.texture, nullptr, _texturebuf, _cfg.panel_width * sizeof(rgb888_t));
       }
     }
 
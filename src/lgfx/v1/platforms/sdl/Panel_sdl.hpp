@@ -75,6 +75,8 @@ namespace lgfx
     virtual ~Panel_sdl(void);
 
     bool init(bool use_reset) override;
+    void beginTransaction(void) override;
+    void endTransaction(void) override;
 
     color_depth_t setColorDepth(color_depth_t depth) override;
 
@@ -87,6 +89,8 @@ namespace lgfx
     void writeImage(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param, bool use_dma) override;
     void writeImageARGB(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param) override;
     void writePixels(pixelcopy_t* param, uint32_t len, bool use_dma) override;
+    void copyRect(uint_fast16_t dst_x, uint_fast16_t dst_y, uint_fast16_t w, uint_fast16_t h, uint_fast16_t src_x, uint_fast16_t src_y) override;
+    bool writeBands(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, void (*func)(void* arg, int32_t y, int32_t h), void* arg) override;
 
     uint_fast8_t getTouchRaw(touch_point_t* tp, uint_fast8_t count) override;
 
@@ -95,6 +99,14 @@ namespace lgfx
     void setFrameImage(const void* frame_image, int frame_width, int frame_height, int inner_x, int inner_y);
     void setFrameRotation(uint_fast16_t frame_rotaion);
 
+    /// When enabled, the framebuffer lock is held from startWrite to endWrite
+    /// instead of being taken by every drawing call.
+    /// The window is updated when the transaction ends.
+    void setTransactionLock(bool enable) { _transaction_lock = enable; }
+
+    /// Number of pixels converted and uploaded to the texture by the last update.
+    uint32_t getUploadPixelCount(void) const { return _upload_pixels; }
+
     static int setup(void);
     static int loop(void);
     static int close(void);
@@ -125,12 +137,17 @@ namespace lgfx
     uint_fast16_t _modified_counter;
     uint_fast16_t _texupdate_counter;
     uint_fast16_t _display_counter;
+    uint32_t _upload_pixels = 0;
     bool _invalidated;
+    bool _texture_reset = false;
+    bool _transaction_lock = false;
+    bool _in_transaction = false;
 
     static void _event_proc(void);
     static void _update_proc(void);
     static void _update_scaling(monitor_t * m, float sx, float sy);
     void sdl_invalidate(void) { _invalidated = true; }
+    void _request_update(void);
     void render_texture(SDL_Texture* texture, int tx, int ty, int tw, int th, float angle);
     bool initFrameBuffer(size_t width, size_t height);
     void deinitFrameBuffer(void);
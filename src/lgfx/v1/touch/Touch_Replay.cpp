@@ -0,0 +1,144 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#include "Touch_Replay.hpp"
+
+#include "../platforms/common.hpp"
+
+#include <string.h>
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  bool Touch_Replay::init(void)
+  {
+    _index = 0;
+    _started = false;
+    _start_msec = lgfx::millis();
+    _inited = true;
+    return true;
+  }
+
+  uint32_t Touch_Replay::current_time(void) const
+  {
+    return _manual_time ? _time : (lgfx::millis() - _start_msec);
+  }
+
+  void Touch_Replay::setTrace(const touch_event_t* events, size_t count)
+  {
+    releaseTrace();
+    _trace = events;
+    _trace_length = events ? count : 0;
+  }
+
+  void Touch_Replay::releaseTrace(void)
+  {
+    if (_loaded)
+    {
+      heap_free(_loaded);
+      _loaded = nullptr;
+    }
+    _trace = nullptr;
+    _trace_length = 0;
+    _index = 0;
+    _started = false;
+  }
+
+  size_t Touch_Replay::loadTrace(FILE* fp)
+  {
+    releaseTrace();
+    if (fp == nullptr) { return 0; }
+
+    size_t capacity = 0;
+    size_t length = 0;
+    touch_event_t* events = nullptr;
+    char line[128];
+    while (fgets(line, sizeof(line), fp))
+    {
+      unsigned long msec;
+      int count, x0 = -1, y0 = -1, x1 = -1, y1 = -1;
+      int n = sscanf(line, "%lu %d %d %d %d %d", &msec, &count, &x0, &y0, &x1, &y1);
+      if (n < 2) { continue; }  // 空行・コメント行は無視する;
+      if (length == capacity)
+      {
+        capacity = capacity ? capacity * 2 : 64;
+        auto tmp = (touch_event_t*)heap_alloc(capacity * sizeof(touch_event_t));
+        if (tmp == nullptr) { break; }
+        if (events)
+        {
+          memcpy(tmp, events, length * sizeof(touch_event_t));
+          heap_free(events);
+        }
+        events = tmp;
+      }
+      auto& e = events[length++];
+      e = touch_event_t();
+      e.msec = msec;
+      e.count = (count < 0) ? 0 : (count > (int)touch_event_t::max_points) ? touch_event_t::max_points : count;
+      e.point[0].x = x0;
+      e.point[0].y = y0;
+      e.point[0].size = (e.count > 0);
+      e.point[1].x = x1;
+      e.point[1].y = y1;
+      e.point[1].size = (e.count > 1);
+      e.point[1].id = 1;
+    }
+    _loaded = events;
+    _trace = events;
+    _trace_length = length;
+    return length;
+  }
+
+  bool Touch_Replay::writeEvent(FILE* fp, const touch_event_t& event)
+  {
+    return 0 < fprintf(fp, "%lu %d %d %d %d %d\n", (unsigned long)event.msec, event.count
+                      , event.point[0].x, event.point[0].y, event.point[1].x, event.point[1].y);
+  }
+
+  uint_fast8_t Touch_Replay::getTouchRaw(touch_point_t* tp, uint_fast8_t count)
+  {
+    if (_trace_length == 0 || count == 0) { return 0; }
+
+    uint32_t msec = current_time();
+    if (_loop)
+    {
+      msec %= _trace[_trace_length - 1].msec + 1;
+    }
+    if (msec < _trace[_index].msec)
+    { // 時間が戻った場合は先頭から探し直す;
+      _index = 0;
+      _started = false;
+    }
+    if (msec < _trace[_index].msec) { return 0; }
+    _started = true;
+    while (_index + 1 < _trace_length && _trace[_index + 1].msec <= msec) { ++_index; }
+
+    auto& e = _trace[_index];
+    if (count > e.count) { count = e.count; }
+    for (size_t i = 0; i < count; ++i)
+    {
+      tp[i] = e.point[i];
+    }
+    return count;
+  }
+
+//----------------------------------------------------------------------------
+ }
+}
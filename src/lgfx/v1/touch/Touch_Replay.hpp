@@ -0,0 +1,89 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../Touch.hpp"
+
+#include <stdio.h>
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  /// @brief 記録したタッチ操作を再生するタッチデバイス;
+  /// getTouchRaw() returns the last event of the trace whose time has come.
+  /// The trace is a text file with one event per line : "msec count x0 y0 x1 y1".
+  /// writeEvent() writes this format, e.g. from the events of LGFX_TouchEngine.
+  ///
+  /// The points are handled as raw values like any touch controller.  A trace recorded
+  /// in panel coordinates is replayed as is when x_min/x_max and y_min/y_max are
+  /// set to the panel size (the default is 0-319 / 0-479).
+  struct Touch_Replay : public ITouch
+  {
+    Touch_Replay(void)
+    {
+      _cfg.x_min = 0;
+      _cfg.x_max = 319;
+      _cfg.y_min = 0;
+      _cfg.y_max = 479;
+      _cfg.bus_shared = false;
+    }
+    ~Touch_Replay(void) { releaseTrace(); }
+
+    bool init(void) override;
+    void wakeup(void) override {}
+    void sleep(void) override {}
+
+    uint_fast8_t getTouchRaw(touch_point_t* tp, uint_fast8_t count) override;
+
+    /// Uses events as the trace.  The array is not copied.
+    void setTrace(const touch_event_t* events, size_t count);
+    /// Reads the trace from a text file.  @return number of events read.
+    size_t loadTrace(FILE* fp);
+    void releaseTrace(void);
+
+    static bool writeEvent(FILE* fp, const touch_event_t& event);
+
+    /// Fixes the replay time.  Without it, the time is millis() since init().
+    void setTime(uint32_t msec) { _time = msec; _manual_time = true; }
+    /// Replays the trace again from the start after the last event.
+    void setLoop(bool loop) { _loop = loop; }
+
+    size_t getTraceLength(void) const { return _trace_length; }
+    /// true after the last event of the trace has been returned.
+    bool isFinished(void) const { return !_loop && _trace_length && _index + 1 >= _trace_length && _started; }
+
+  private:
+    uint32_t current_time(void) const;
+
+    const touch_event_t* _trace = nullptr;
+    touch_event_t* _loaded = nullptr;   // owned by this instance
+    size_t _trace_length = 0;
+    size_t _index = 0;
+    uint32_t _time = 0;
+    uint32_t _start_msec = 0;
+    bool _manual_time = false;
+    bool _loop = false;
+    bool _started = false;
+  };
+
+//----------------------------------------------------------------------------
+ }
+}
@@ -27,6 +27,11 @@ Contributors:
 #include "v1/LGFXBase.hpp"
 #include "v1/LGFX_Sprite.hpp"
 #include "v1/LGFX_Button.hpp"
+#include "v1/LGFX_MJpegPlayer.hpp"
+#include "v1/LGFX_DisplayList.hpp"
+#include "v1/LGFX_TextRun.hpp"
+#include "v1/LGFX_TouchEngine.hpp"
+#include "v1/misc/Bus_Recorder.hpp"
 #include "v1/Light.hpp"
 
 // LCD / OLED
@@ -82,3 +87,4 @@ Contributors:
 #include "v1/touch/Touch_TT21xxx.hpp"
 #include "v1/touch/Touch_XPT2046.hpp"
 #include "v1/touch/Touch_RA8875.hpp"
+#include "v1/touch/Touch_Replay.hpp"